@@ -0,0 +1,430 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "engine/bytecode.hpp"
+#include "engine/cost_model.hpp"
+#include "engine/jit.hpp"
+#include "engine/nfa.hpp"
+#include "engine/path.hpp"
+#include "engine/planner.hpp"
+#include "solvers/auto.hpp"
+#include "utils/parser.hpp"
+#include "wildcard_matcher.hpp"
+
+/**
+ * @brief The latency observed for one engine of an AdaptiveMatcher.
+ */
+struct EngineStats {
+    std::uint64_t calls = 0;
+    std::uint64_t total_ns = 0;  // Total latency of all calls in nanoseconds.
+
+    /**
+     * @brief The mean latency per call in nanoseconds.
+     */
+    double meanNs() const {
+        return calls == 0 ? 0.0 : static_cast<double>(total_ns) / static_cast<double>(calls);
+    }
+};
+
+/**
+ * @brief Options controlling how an AdaptiveMatcher explores alternative engines.
+ */
+struct AdaptiveOptions {
+    // Every n-th call runs on an alternative engine instead of the current best one.
+    std::size_t sample_interval = 16;
+    // An engine must have been observed this many times before it can become the best one.
+    std::size_t min_samples = 8;
+    // The engines taking part in the selection; those that cannot run the pattern are dropped.
+    std::vector<Engine> candidates = {Engine::GREEDY, Engine::BYTECODE, Engine::JIT};
+};
+
+/**
+ * @brief A matcher for one pattern that converges on the engine with the lowest observed latency.
+ *
+ * The first call starts on the engine chosen by the Planner, or on the first candidate if the
+ * Planner picks an engine that is not one. From then on, every `sample_interval`-th call is
+ * routed to the other candidates in turn (an epsilon-greedy bandit with a deterministic schedule),
+ * and the latency of every call is accumulated per engine in nanoseconds, since most matches take
+ * less than a microsecond. Once an engine has `min_samples` observations and a lower mean latency
+ * than the current one, it takes over the remaining traffic. Candidates that cannot run the
+ * pattern are dropped, so a pattern using dialect tokens stays on the NFA engine. The compiling
+ * engines (bytecode, jit, nfa) keep the program built on their first call, and only the match
+ * itself is timed.
+ *
+ * The learned statistics can be exported as a single line of text and imported again at startup,
+ * so long-running services do not have to relearn their workload after a restart. An
+ * AdaptiveMatcher is not thread-safe; use one per thread or guard it externally.
+ */
+class AdaptiveMatcher {
+   public:
+    /**
+     * @brief Creates an adaptive matcher for a pattern.
+     * @param p_tokens The tokenized pattern vector.
+     * @param options Options controlling the exploration.
+     * @return The adaptive matcher.
+     */
+    static AdaptiveMatcher create(std::vector<Token> p_tokens, AdaptiveOptions options = {}) {
+        AdaptiveMatcher matcher;
+        matcher.tokens = std::move(p_tokens);
+        matcher.options = std::move(options);
+        if (matcher.options.sample_interval == 0) {
+            matcher.options.sample_interval = 1;
+        }
+        matcher.shape = analyzePattern(matcher.tokens);
+        std::erase_if(matcher.options.candidates, [&matcher](Engine engine) {
+            return !CostModel::runs(engine, matcher.shape);
+        });
+        if (matcher.options.candidates.empty()) {
+            matcher.options.candidates.push_back(Engine::NFA);
+        }
+        return matcher;
+    }
+
+    /**
+     * @brief Matches a text on the engine selected by the bandit and records its latency.
+     * @param s The text string view to match.
+     * @return The SolverProfile of the engine that ran, with SolverProfile::engine set.
+     */
+    SolverProfile run(std::string_view s) {
+        const Engine engine = nextEngine(s);
+        std::uint64_t time_elapsed_ns = 0;
+        SolverProfile profile = runOnEngine(engine, s, time_elapsed_ns);
+        profile.engine = engineToString(engine);
+        observe(engine, time_elapsed_ns);
+        return profile;
+    }
+
+    /**
+     * @brief Matches a text, see run().
+     * @param s The text string view to match.
+     * @return true if the text matches the pattern, false otherwise.
+     */
+    bool match(std::string_view s) { return run(s).result; }
+
+    /**
+     * @brief Records one latency observation for an engine and updates the current best engine.
+     * @param engine The engine that ran; ignored if it is not a candidate.
+     * @param time_elapsed_ns Its latency in nanoseconds.
+     */
+    void observe(Engine engine, std::uint64_t time_elapsed_ns) {
+        if (!isCandidate(engine)) {
+            return;
+        }
+        EngineStats& observed = stats[index(engine)];
+        observed.calls++;
+        observed.total_ns += time_elapsed_ns;
+        if (!has_best) {
+            best = engine;
+            has_best = true;
+        }
+        updateBest();
+    }
+
+    /**
+     * @brief Returns the engine that currently receives the bulk of the calls.
+     */
+    Engine currentEngine() const { return best; }
+
+    /**
+     * @brief Returns the latency statistics of an engine.
+     */
+    const EngineStats& engineStats(Engine engine) const { return stats[index(engine)]; }
+
+    /**
+     * @brief Exports the learned state as a single line, e.g.
+     * `best=bytecode greedy=12/30 bytecode=200/410 jit=12/95`, where each entry is calls/total_ns.
+     * @return The serialized state, empty if nothing has been learned yet.
+     */
+    std::string exportState() const {
+        if (!has_best) {
+            return {};
+        }
+        std::string out = "best=";
+        out += engineToString(best);
+        for (Engine engine : options.candidates) {
+            const EngineStats& entry = stats[index(engine)];
+            out += ' ';
+            out += engineToString(engine);
+            out += '=' + std::to_string(entry.calls) + '/' + std::to_string(entry.total_ns);
+        }
+        return out;
+    }
+
+    /**
+     * @brief Restores a state produced by exportState().
+     * @param state The serialized state.
+     * @return true on success; on failure the matcher is left unchanged.
+     */
+    bool importState(std::string_view state) {
+        std::array<EngineStats, engine_count> restored{};
+        std::optional<Engine> restored_best;
+
+        while (!state.empty()) {
+            const std::size_t space = state.find(' ');
+            const std::string_view field = state.substr(0, space);
+            state = space == std::string_view::npos ? std::string_view() : state.substr(space + 1);
+            if (field.empty()) {
+                continue;
+            }
+
+            const std::size_t equals = field.find('=');
+            if (equals == std::string_view::npos) {
+                return false;
+            }
+            const std::string_view key = field.substr(0, equals);
+            const std::string_view value = field.substr(equals + 1);
+            if (key == "best") {
+                restored_best = engineFromString(value);
+                if (!restored_best) {
+                    return false;
+                }
+                continue;
+            }
+
+            const std::optional<Engine> engine = engineFromString(key);
+            const std::size_t slash = value.find('/');
+            if (!engine || slash == std::string_view::npos ||
+                !parseNumber(value.substr(0, slash), restored[index(*engine)].calls) ||
+                !parseNumber(value.substr(slash + 1), restored[index(*engine)].total_ns)) {
+                return false;
+            }
+        }
+        if (!restored_best || !isCandidate(*restored_best)) {
+            return false;
+        }
+
+        stats = restored;
+        best = *restored_best;
+        has_best = true;
+        return true;
+    }
+
+   private:
+    std::vector<Token> tokens;
+    PatternShape shape;
+    AdaptiveOptions options;
+    std::array<EngineStats, engine_count> stats{};
+    Engine best = Engine::GREEDY;
+    bool has_best = false;        // False until the first call or import.
+    std::uint64_t calls = 0;      // Calls routed through nextEngine().
+    std::size_t next_sample = 0;  // Round-robin cursor over the candidates.
+    // Programs of the compiling engines, built on their first call.
+    std::optional<BytecodeProgram> bytecode;
+    std::optional<JitMatcher> jit;
+    std::optional<PathMatcher> path;
+    std::optional<NfaMatcher> nfa;
+
+    AdaptiveMatcher() = default;
+
+    /**
+     * @brief [private] Returns the array index of an engine.
+     */
+    static std::size_t index(Engine engine) { return static_cast<std::size_t>(engine); }
+
+    /**
+     * @brief [private] Returns true if an engine takes part in the selection.
+     */
+    bool isCandidate(Engine engine) const {
+        return std::find(options.candidates.begin(), options.candidates.end(), engine) !=
+               options.candidates.end();
+    }
+
+    /**
+     * @brief [private] Matches a text on one engine and reports its latency in nanoseconds. The
+     * compiling engines reuse their program, so only the match is timed; the others have no
+     * separate compile step and run through AutoSolver.
+     */
+    SolverProfile runOnEngine(Engine engine, std::string_view s, std::uint64_t& time_elapsed_ns) {
+        switch (engine) {
+            case Engine::BYTECODE:
+                if (!bytecode) {
+                    bytecode.emplace(BytecodeProgram::compile(tokens));
+                }
+                return timeMatch(*bytecode, s, time_elapsed_ns);
+            case Engine::JIT:
+                if (!jit) {
+                    jit.emplace(JitMatcher::compile(tokens));
+                }
+                return timeMatch(*jit, s, time_elapsed_ns);
+            case Engine::NFA:
+                if (!path && !nfa) {
+                    path = PathMatcher::compile(tokens);
+                    if (!path) {
+                        nfa.emplace(NfaMatcher::compile(tokens));
+                    }
+                }
+                return path ? timeMatch(*path, s, time_elapsed_ns)
+                            : timeMatch(*nfa, s, time_elapsed_ns);
+            case Engine::RECURSIVE:
+            case Engine::MEMO:
+            case Engine::DP:
+            case Engine::GREEDY:
+                break;
+        }
+        auto start_time = std::chrono::high_resolution_clock::now();
+        SolverProfile profile = AutoSolver::runEngine(engine, s, tokens);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        time_elapsed_ns = elapsedNs(start_time, end_time);
+        return profile;
+    }
+
+    /**
+     * @brief [private] Times one match of a compiled program.
+     */
+    template <typename Program>
+    static SolverProfile timeMatch(const Program& program, std::string_view s,
+                                   std::uint64_t& time_elapsed_ns) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        bool result = program.match(s);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        time_elapsed_ns = elapsedNs(start_time, end_time);
+        return {result, static_cast<long long>(time_elapsed_ns / 1000), program.spaceUsed()};
+    }
+
+    /**
+     * @brief [private] Returns the nanoseconds between two time points.
+     */
+    template <typename TimePoint>
+    static std::uint64_t elapsedNs(TimePoint start_time, TimePoint end_time) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+    }
+
+    /**
+     * @brief [private] Parses a whole field as a non-negative decimal number.
+     */
+    template <typename T>
+    static bool parseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && text.front() != '-' && error == std::errc() &&
+               end == text.data() + text.size();
+    }
+
+    /**
+     * @brief [private] Picks the engine for the next call, sampling an alternative on schedule.
+     */
+    Engine nextEngine(std::string_view s) {
+        if (!has_best) {
+            best = Planner::choose(shape, s.length(), true);
+            if (!isCandidate(best)) {
+                best = options.candidates.front();
+            }
+            has_best = true;
+        }
+        if (++calls % options.sample_interval != 0 || options.candidates.size() < 2) {
+            return best;
+        }
+
+        // Visit the candidates in turn, skipping the current best one
+        for (std::size_t tries = 0; tries < options.candidates.size(); ++tries) {
+            const Engine candidate = options.candidates[next_sample++ % options.candidates.size()];
+            if (candidate != best) {
+                return candidate;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief [private] Promotes the sufficiently sampled candidate with the lowest mean latency.
+     */
+    void updateBest() {
+        const EngineStats& current = stats[index(best)];
+        double best_mean = current.calls >= options.min_samples ? current.meanNs() : -1.0;
+        for (Engine candidate : options.candidates) {
+            const EngineStats& entry = stats[index(candidate)];
+            if (candidate == best || entry.calls < options.min_samples) {
+                continue;
+            }
+            if (best_mean < 0.0 || entry.meanNs() < best_mean) {
+                best = candidate;
+                best_mean = entry.meanNs();
+            }
+        }
+    }
+};
+
+/**
+ * @brief A collection of AdaptiveMatchers keyed by their pattern string, whose learned state can be
+ * saved to and loaded from a stream in one go.
+ *
+ * Each pattern occupies one line of the form `<length>:<pattern> <state>`, where `<state>` is the
+ * output of AdaptiveMatcher::exportState(). The length prefix keeps arbitrary pattern bytes intact.
+ */
+class AdaptiveMatcherCache {
+   public:
+    explicit AdaptiveMatcherCache(AdaptiveOptions options_in = {})
+        : options(std::move(options_in)) {}
+
+    /**
+     * @brief Returns the matcher of a pattern, creating it on first use.
+     * @param pattern A pattern that has already passed validation.
+     * @return The adaptive matcher of the pattern.
+     */
+    AdaptiveMatcher& get(const std::string& pattern) {
+        auto it = matchers.find(pattern);
+        if (it == matchers.end()) {
+            it = matchers
+                     .emplace(pattern,
+                              AdaptiveMatcher::create(Parser::parse(pattern).tokens, options))
+                     .first;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Writes the learned state of every pattern that has one.
+     * @param out The output stream.
+     */
+    void exportState(std::ostream& out) const {
+        for (const auto& [pattern, matcher] : matchers) {
+            const std::string state = matcher.exportState();
+            if (!state.empty()) {
+                out << pattern.length() << ':' << pattern << ' ' << state << '\n';
+            }
+        }
+    }
+
+    /**
+     * @brief Loads a state written by exportState(), creating matchers as needed.
+     * @param in The input stream.
+     * @return true if every record was restored, false if a malformed record was skipped.
+     */
+    bool importState(std::istream& in) {
+        bool all_restored = true;
+        std::size_t length = 0;
+        while (in >> length) {
+            std::string pattern(length, '\0');
+            std::string state;
+            if (in.get() != ':' || !in.read(pattern.data(), static_cast<std::streamsize>(length)) ||
+                in.get() != ' ' || !std::getline(in, state)) {
+                return false;
+            }
+            all_restored = get(pattern).importState(state) && all_restored;
+        }
+        return all_restored && in.eof();
+    }
+
+    /**
+     * @brief Returns the number of patterns in the cache.
+     */
+    std::size_t size() const { return matchers.size(); }
+
+   private:
+    AdaptiveOptions options;
+    std::map<std::string, AdaptiveMatcher> matchers;
+};
\ No newline at end of file
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/nfa.hpp"
+#include "utils/compiler.hpp"
+#include "utils/masked_literal.hpp"
+#include "utils/parser.hpp"
+#include "utils/simd.hpp"
+
+/**
+ * @brief The instruction set of the compiled pattern bytecode.
+ *
+ * A pattern is split at its ANY_SEQUENCE tokens into fixed-width segments. The first segment is
+ * anchored at the start of the text, the last one at the end, and every segment in between is
+ * searched for at its leftmost occurrence, which is always the optimal choice for glob patterns.
+ */
+enum class OpCode : std::uint8_t {
+    MATCH_LIT,         // Anchored: the text at `pos` must equal the literal at `offset`.
+    MATCH_MASKED,      // Anchored: the text at `pos` must match the masked window at `offset`.
+    SKIP,              // Anchored: consume `length` arbitrary characters (a run of '?').
+    STAR_FIND_LIT,     // Search: find the leftmost occurrence of a literal at or after `pos`.
+    STAR_FIND_MASKED,  // Search: find the leftmost occurrence of a masked window at or after `pos`.
+    MATCH_TAIL,        // The masked window must match the last `length` characters of the text.
+    ANCHOR_END,        // Succeed if and only if the whole text has been consumed.
+    ACCEPT             // Succeed unconditionally (the pattern ends with a '*').
+};
+
+/**
+ * @brief Provides a string representation for an OpCode.
+ * @param op The opcode.
+ * @return A string_view literal for the specified opcode.
+ */
+inline std::string_view opCodeToString(OpCode op) {
+    switch (op) {
+        case OpCode::MATCH_LIT:
+            return "MATCH_LIT";
+        case OpCode::MATCH_MASKED:
+            return "MATCH_MASKED";
+        case OpCode::SKIP:
+            return "SKIP";
+        case OpCode::STAR_FIND_LIT:
+            return "STAR_FIND_LIT";
+        case OpCode::STAR_FIND_MASKED:
+            return "STAR_FIND_MASKED";
+        case OpCode::MATCH_TAIL:
+            return "MATCH_TAIL";
+        case OpCode::ANCHOR_END:
+            return "ANCHOR_END";
+        case OpCode::ACCEPT:
+            return "ACCEPT";
+    }
+    // This path is unreachable if all enum values are handled in the switch.
+    APP_UNREACHABLE();
+}
+
+/**
+ * @brief A single bytecode instruction. Operands index into the program's literal pool.
+ */
+struct Instruction {
+    OpCode op;
+    std::uint32_t offset = 0;  // Start of the operand bytes in the literal and mask pools.
+    std::uint32_t length = 0;  // Number of text characters covered by the operand.
+    bool operator==(const Instruction& other) const = default;
+};
+
+/**
+ * @brief A pattern compiled into compact bytecode, executed by a direct-threaded interpreter.
+ *
+ * The program is compiled once and can then be matched against any number of texts without
+ * further allocation. On GCC and Clang the interpreter dispatches with computed gotos, giving every
+ * opcode its own indirect branch; other compilers fall back to a `switch` loop.
+ *
+ * Dialect tokens have no bytecode: a pattern using them compiles into an NfaMatcher instead, which
+ * the program runs in place of the interpreter, so every user of a program gets correct answers.
+ */
+class BytecodeProgram {
+   public:
+    /**
+     * @brief Compiles a token vector into bytecode, or into an automaton if it uses dialect
+     * tokens.
+     * @param p_tokens The tokenized pattern vector.
+     * @return The compiled program.
+     */
+    static BytecodeProgram compile(const std::vector<Token>& p_tokens) {
+        BytecodeProgram program;
+        if (usesDialectTokens(p_tokens)) {
+            program.automaton = NfaMatcher::compile(p_tokens);
+            return program;
+        }
+        const std::vector<MaskedLiteral> windows = MaskedLiteralCompiler::compile(p_tokens);
+
+        // Locate the first and last '*' to know which segments are anchored
+        size_t first_star = p_tokens.size();
+        size_t last_star = p_tokens.size();
+        for (size_t j = 0; j < p_tokens.size(); ++j) {
+            if (p_tokens[j].type == TokenType::ANY_SEQUENCE) {
+                if (first_star == p_tokens.size()) {
+                    first_star = j;
+                }
+                last_star = j;
+            }
+        }
+        const bool has_star = first_star != p_tokens.size();
+
+        for (size_t j = 0; j < p_tokens.size(); ++j) {
+            const MaskedLiteral& window = windows[j];
+            if (window.token_count == 0) {
+                continue;  // A '*' or a token inside an already emitted window
+            }
+
+            if (!has_star || j < first_star) {
+                program.emitAnchored(window);
+            } else if (j > last_star) {
+                program.emit(OpCode::MATCH_TAIL, window);
+            } else if (window.isWildcard()) {
+                // A run of '?' between two stars: its leftmost occurrence is the current position
+                program.code.push_back(
+                    {OpCode::SKIP, 0, static_cast<std::uint32_t>(window.length())});
+            } else if (window.isExact()) {
+                program.emit(OpCode::STAR_FIND_LIT, window);
+            } else {
+                program.emit(OpCode::STAR_FIND_MASKED, window);
+            }
+        }
+
+        // A trailing '*' absorbs the rest of the text; otherwise the text must be fully consumed
+        const bool trailing_star = has_star && p_tokens.back().type == TokenType::ANY_SEQUENCE;
+        program.code.push_back({trailing_star ? OpCode::ACCEPT : OpCode::ANCHOR_END});
+
+        return program;
+    }
+
+    /**
+     * @brief Executes the program against a text.
+     * @param s The text string view to match.
+     * @return true if the text matches the compiled pattern, false otherwise.
+     */
+    bool match(std::string_view s) const {
+        if (automaton) {
+            return automaton->match(s);
+        }
+        const Instruction* ip = code.data();
+        const char* const text = s.data();
+        const size_t m = s.length();
+        size_t pos = 0;
+
+#if defined(APP_HAS_COMPUTED_GOTO)
+        // Labels as values are a GNU extension; keep the header clean under -Wpedantic
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+        // The table order must follow the declaration order of OpCode
+        static const void* const dispatch_table[] = {
+            &&op_MATCH_LIT,        &&op_MATCH_MASKED, &&op_SKIP,        &&op_STAR_FIND_LIT,
+            &&op_STAR_FIND_MASKED, &&op_MATCH_TAIL,   &&op_ANCHOR_END, &&op_ACCEPT};
+#define BYTECODE_CASE(name) op_##name:
+#define BYTECODE_DISPATCH() goto* dispatch_table[static_cast<size_t>(ip->op)]
+        BYTECODE_DISPATCH();
+        {
+#else
+#define BYTECODE_CASE(name) case OpCode::name:
+#define BYTECODE_DISPATCH() goto dispatch
+    dispatch:
+        switch (ip->op) {
+#endif
+            BYTECODE_CASE(MATCH_LIT) {
+                if (m - pos < ip->length ||
+                    std::memcmp(text + pos, literals.data() + ip->offset, ip->length) != 0) {
+                    return false;
+                }
+                pos += ip->length;
+                ++ip;
+                BYTECODE_DISPATCH();
+            }
+            BYTECODE_CASE(MATCH_MASKED) {
+                if (m - pos < ip->length || !windowMatches(text + pos, *ip)) {
+                    return false;
+                }
+                pos += ip->length;
+                ++ip;
+                BYTECODE_DISPATCH();
+            }
+            BYTECODE_CASE(SKIP) {
+                if (m - pos < ip->length) {
+                    return false;
+                }
+                pos += ip->length;
+                ++ip;
+                BYTECODE_DISPATCH();
+            }
+            BYTECODE_CASE(STAR_FIND_LIT) {
+                const size_t found =
+                    s.find(std::string_view(literals.data() + ip->offset, ip->length), pos);
+                if (found == std::string_view::npos) {
+                    return false;
+                }
+                pos = found + ip->length;
+                ++ip;
+                BYTECODE_DISPATCH();
+            }
+            BYTECODE_CASE(STAR_FIND_MASKED) {
+                const size_t found =
+                    findMaskedWindow(text, m, pos, literals.data() + ip->offset,
+                                     masks.data() + ip->offset, ip->length);
+                if (found == static_cast<size_t>(-1)) {
+                    return false;
+                }
+                pos = found + ip->length;
+                ++ip;
+                BYTECODE_DISPATCH();
+            }
+            BYTECODE_CASE(MATCH_TAIL) {
+                if (m - pos < ip->length || !windowMatches(text + m - ip->length, *ip)) {
+                    return false;
+                }
+                pos = m;
+                ++ip;
+                BYTECODE_DISPATCH();
+            }
+            BYTECODE_CASE(ANCHOR_END) { return pos == m; }
+            BYTECODE_CASE(ACCEPT) { return true; }
+        }
+#if defined(APP_HAS_COMPUTED_GOTO)
+#pragma GCC diagnostic pop
+#endif
+#undef BYTECODE_CASE
+#undef BYTECODE_DISPATCH
+
+        // Every program ends with ANCHOR_END or ACCEPT, so the interpreter never falls through.
+        APP_UNREACHABLE();
+    }
+
+    /**
+     * @brief Returns true if the pattern runs on an automaton instead of bytecode.
+     */
+    bool usesAutomaton() const { return automaton.has_value(); }
+
+    /**
+     * @brief Returns the compiled instruction sequence, empty if usesAutomaton().
+     */
+    const std::vector<Instruction>& instructions() const { return code; }
+
+    /**
+     * @brief Returns the number of bytes held by the program (instructions and operand pools).
+     */
+    size_t spaceUsed() const {
+        return code.capacity() * sizeof(Instruction) + literals.capacity() + masks.capacity() +
+               (automaton ? automaton->spaceUsed() : 0);
+    }
+
+   private:
+    std::vector<Instruction> code;
+    std::string literals;  // Operand bytes of all instructions, concatenated.
+    std::string masks;     // Per-byte masks parallel to `literals` (see MaskedLiteral).
+    std::optional<NfaMatcher> automaton;  // Runs a pattern with dialect tokens instead of `code`.
+
+    /**
+     * @brief [private] Appends a window to the operand pools and emits an instruction for it.
+     */
+    void emit(OpCode op, const MaskedLiteral& window) {
+        const auto offset = static_cast<std::uint32_t>(literals.size());
+        literals += window.bytes;
+        masks += window.mask;
+        code.push_back({op, offset, static_cast<std::uint32_t>(window.length())});
+    }
+
+    /**
+     * @brief [private] Emits the cheapest anchored instruction for a window.
+     */
+    void emitAnchored(const MaskedLiteral& window) {
+        if (window.isExact()) {
+            emit(OpCode::MATCH_LIT, window);
+        } else if (window.isWildcard()) {
+            code.push_back({OpCode::SKIP, 0, static_cast<std::uint32_t>(window.length())});
+        } else {
+            emit(OpCode::MATCH_MASKED, window);
+        }
+    }
+
+    /**
+     * @brief [private] Compares the masked window of an instruction against the text.
+     */
+    bool windowMatches(const char* text, const Instruction& instr) const {
+        return maskedEquals(text, literals.data() + instr.offset, masks.data() + instr.offset,
+                            instr.length);
+    }
+};
\ No newline at end of file
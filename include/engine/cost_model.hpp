@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "engine/bytecode.hpp"
+#include "engine/engines.hpp"
+#include "engine/pattern_shape.hpp"
+#include "utils/compiler.hpp"
+#include "utils/masked_literal.hpp"
+#include "utils/parser.hpp"
+#include "utils/simd.hpp"
+
+/**
+ * @brief The estimated worst-case cost of matching a pattern on one engine.
+ */
+struct EngineCost {
+    Engine engine;
+    std::uint64_t steps;  // Upper bound on elementary comparisons, saturating at UINT64_MAX.
+    std::uint64_t bytes;  // Upper bound on extra memory, as reported in space_used_bytes.
+};
+
+/**
+ * @brief Budget for admitting a pattern, see CostModel::admit.
+ */
+struct CostLimits {
+    std::uint64_t max_steps = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_bytes = std::numeric_limits<std::uint64_t>::max();
+    // If true, a pattern over budget on the requested engine may run on a cheaper one instead.
+    bool allow_downgrade = true;
+};
+
+/**
+ * @brief The outcome of CostModel::admit.
+ */
+struct AdmissionDecision {
+    bool admitted;              // False if no allowed engine fits the budget.
+    Engine requested;           // The engine the caller asked for.
+    Engine engine;              // The engine to run on (equals `requested` unless downgraded).
+    EngineCost cost;            // The estimated cost on `engine`.
+    EngineCost requested_cost;  // The estimated cost on `requested`.
+    std::size_t text_length;    // The expected text length the estimate was made for.
+
+    // Helper to check if the pattern was moved to a cheaper engine.
+    bool isDowngraded() const { return admitted && engine != requested; }
+};
+
+/**
+ * @brief Estimates the worst-case cost of a pattern on every engine from its tokens alone.
+ *
+ * With m the text length, n the token count, L the number of fixed-width characters and k the
+ * number of '*' tokens, the bounds are:
+ * - recursive: (m+1)^k * (L+1) steps, a stack of m+n+1 frames;
+ * - memo: (m+1)*(n+1) states, plus the same stack;
+ * - dp: (m+1)*(n+1) cells of the DP table;
+ * - recursive, memo and dp additionally hold the masked windows of the runs they reach;
+ * - greedy, bytecode, jit: (m+1)*(L+1) steps for restarting the segment after each '*', and
+ *   memory for the compiled pattern only;
+ * - nfa: m*(P+1)*W steps for P automaton positions in W = ceil(P/64) words (min(m,P)*(P+1)*W
+ *   without '*'), and P+260 rows of W words for the follow and accept tables and the state sets,
+ *   plus at most one skip table per position.
+ * Patterns without '*' cost L steps on every other engine. Patterns using dialect tokens can
+ * only run on nfa; every other engine reports UINT64_MAX for them and is never admitted. The
+ * space bounds follow the accounting the solvers use for SolverProfile::space_used_bytes, so
+ * estimates and measurements are comparable.
+ */
+class CostModel {
+   public:
+    // The engines in the order of preference when downgrading an expensive pattern.
+    static constexpr std::array<Engine, 7> downgrade_order = {
+        Engine::GREEDY, Engine::BYTECODE, Engine::JIT,      Engine::NFA,
+        Engine::DP,     Engine::MEMO,     Engine::RECURSIVE};
+
+    /**
+     * @brief Estimates the cost of a pattern on one engine.
+     * @param engine The engine.
+     * @param p_tokens The tokenized pattern vector.
+     * @param text_length The expected length of the texts.
+     * @return The estimated EngineCost.
+     */
+    static EngineCost estimate(Engine engine, const std::vector<Token>& p_tokens,
+                               std::size_t text_length) {
+        return estimate(engine, analyzePattern(p_tokens), text_length);
+    }
+
+    /**
+     * @brief Estimates the cost of a pattern of the given shape on one engine.
+     * @param engine The engine.
+     * @param shape The PatternShape of the pattern.
+     * @param text_length The expected length of the texts.
+     * @return The estimated EngineCost.
+     */
+    static EngineCost estimate(Engine engine, const PatternShape& shape,
+                               std::size_t text_length) {
+        const std::uint64_t m = text_length;
+        const std::uint64_t n = shape.token_count;
+        const std::uint64_t fixed = shape.min_text_length;
+        const std::uint64_t frame = sizeof(std::size_t) * 2 + sizeof(void*);
+        const std::uint64_t table = mul(m + 1, n + 1);
+        const std::uint64_t stack = mul(m + n + 1, frame);
+
+        constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+        const std::uint64_t words = (shape.position_count + 63) / 64;
+        if (engine == Engine::NFA) {
+            // Without a loop the state set dies out after P characters
+            const std::uint64_t reach = shape.usesDialect() || shape.star_count > 0
+                                            ? m
+                                            : std::min<std::uint64_t>(m, shape.position_count);
+            const std::uint64_t skips =
+                mul(shape.position_count, sizeof(ByteClassTable) + sizeof(std::uint32_t));
+            return {engine, mul(reach, mul(shape.position_count + 1, words)),
+                    add(mul(shape.position_count + 260, mul(words, sizeof(std::uint64_t))), skips)};
+        }
+        if (shape.usesDialect()) {
+            return {engine, max, max};
+        }
+
+        // Without '*' every engine compares the fixed characters once
+        const std::uint64_t linear = shape.star_count == 0 ? fixed : mul(m + 1, fixed + 1);
+
+        switch (engine) {
+            case Engine::RECURSIVE: {
+                std::uint64_t steps = fixed + 1;
+                for (std::size_t k = 0; k < shape.star_count; ++k) {
+                    steps = mul(steps, m + 1);
+                }
+                return {engine, shape.star_count == 0 ? fixed : steps,
+                        add(stack, windowBytes(shape))};
+            }
+            case Engine::MEMO:
+                return {engine, shape.star_count == 0 ? fixed : table,
+                        add(add(mul(table, sizeof(std::optional<bool>)), stack),
+                            windowBytes(shape))};
+            case Engine::DP:
+                return {engine, shape.star_count == 0 ? fixed : table,
+                        add(table, windowBytes(shape))};
+            case Engine::GREEDY:
+                // Two indices, the backtrack point and the masked windows
+                return {engine, linear, sizeof(std::size_t) * 5 + windowBytes(shape)};
+            case Engine::BYTECODE:
+                return {engine, linear, programBytes(shape) + sizeof(std::size_t)};
+            case Engine::JIT:
+                // The interpreter fallback, the segments and code rounded up to whole pages
+                return {engine, linear,
+                        programBytes(shape) + windowBytes(shape) + jit_page_size +
+                            n * jit_bytes_per_token};
+            case Engine::NFA:
+                break;  // Handled above
+        }
+        // This path is unreachable if all enum values are handled in the switch.
+        APP_UNREACHABLE();
+    }
+
+    /**
+     * @brief Estimates the cost of a pattern on every engine.
+     * @param p_tokens The tokenized pattern vector.
+     * @param text_length The expected length of the texts.
+     * @return One EngineCost per engine, in the order of Engine.
+     */
+    static std::vector<EngineCost> estimateAll(const std::vector<Token>& p_tokens,
+                                               std::size_t text_length) {
+        const PatternShape shape = analyzePattern(p_tokens);
+        std::vector<EngineCost> costs;
+        for (Engine engine : {Engine::RECURSIVE, Engine::MEMO, Engine::DP, Engine::GREEDY,
+                              Engine::BYTECODE, Engine::JIT, Engine::NFA}) {
+            costs.push_back(estimate(engine, shape, text_length));
+        }
+        return costs;
+    }
+
+    /**
+     * @brief Decides at submission time whether a pattern may run on the requested engine.
+     *
+     * If the requested engine is over budget and downgrading is allowed, the first engine of
+     * `downgrade_order` within budget is chosen instead. Pass the decision to
+     * PerformanceLinter::validateAdmission to report it.
+     *
+     * @param p_tokens The tokenized pattern vector.
+     * @param text_length The expected (or maximum accepted) length of the texts.
+     * @param requested The engine the caller intends to use.
+     * @param limits The budget.
+     * @return The AdmissionDecision.
+     */
+    static AdmissionDecision admit(const std::vector<Token>& p_tokens, std::size_t text_length,
+                                   Engine requested, const CostLimits& limits) {
+        const PatternShape shape = analyzePattern(p_tokens);
+        const EngineCost requested_cost = estimate(requested, shape, text_length);
+        if (runs(requested, shape) && fits(requested_cost, limits)) {
+            return {true, requested, requested, requested_cost, requested_cost, text_length};
+        }
+        if (limits.allow_downgrade) {
+            for (Engine engine : downgrade_order) {
+                const EngineCost cost = estimate(engine, shape, text_length);
+                if (runs(engine, shape) && fits(cost, limits)) {
+                    return {true, requested, engine, cost, requested_cost, text_length};
+                }
+            }
+        }
+        return {false, requested, requested, requested_cost, requested_cost, text_length};
+    }
+
+    /**
+     * @brief Checks whether an engine can run a pattern at all.
+     * @param engine The engine.
+     * @param shape The PatternShape of the pattern.
+     * @return false if the pattern uses dialect tokens and the engine is not NFA.
+     */
+    static bool runs(Engine engine, const PatternShape& shape) {
+        return engine == Engine::NFA || !shape.usesDialect();
+    }
+
+   private:
+    // Estimated size of the generated machine code per token, and the page it is rounded up to.
+    static constexpr std::uint64_t jit_bytes_per_token = 64;
+    static constexpr std::uint64_t jit_page_size = 4096;
+
+    /**
+     * @brief [private] Bounds the memory of the masked windows compiled from a pattern: one
+     * MaskedLiteral per token, whose bytes and mask strings hold at least the inline capacity and
+     * grow geometrically up to twice the fixed-width characters.
+     */
+    static std::uint64_t windowBytes(const PatternShape& shape) {
+        const std::uint64_t inline_capacity = std::string().capacity();
+        return shape.token_count * (sizeof(MaskedLiteral) + 2 * inline_capacity) +
+               4 * shape.min_text_length;
+    }
+
+    /**
+     * @brief [private] Bounds the memory of a bytecode program: at most one instruction per token
+     * plus the final one, and two operand pools, all grown geometrically up to twice their size.
+     */
+    static std::uint64_t programBytes(const PatternShape& shape) {
+        const std::uint64_t inline_capacity = std::string().capacity();
+        return 2 * (shape.token_count + 1) * sizeof(Instruction) +
+               2 * (inline_capacity + 2 * shape.min_text_length);
+    }
+
+    /**
+     * @brief [private] Returns true if a cost is within the limits.
+     */
+    static bool fits(const EngineCost& cost, const CostLimits& limits) {
+        return cost.steps <= limits.max_steps && cost.bytes <= limits.max_bytes;
+    }
+
+    /**
+     * @brief [private] Multiplies, saturating at UINT64_MAX instead of overflowing.
+     */
+    static std::uint64_t mul(std::uint64_t a, std::uint64_t b) {
+        constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+        return (a != 0 && b > max / a) ? max : a * b;
+    }
+
+    /**
+     * @brief [private] Adds, saturating at UINT64_MAX instead of overflowing.
+     */
+    static std::uint64_t add(std::uint64_t a, std::uint64_t b) {
+        constexpr std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+        return a > max - b ? max : a + b;
+    }
+};
\ No newline at end of file
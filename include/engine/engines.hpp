@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "utils/compiler.hpp"
+
+/**
+ * @brief The matching engines a pattern can be executed on.
+ *
+ * Every engine runs the basic pattern language; patterns using opt-in dialect tokens (see
+ * ParseOptions) run on NFA only.
+ */
+enum class Engine { RECURSIVE, MEMO, DP, GREEDY, BYTECODE, JIT, NFA };
+
+/**
+ * @brief The number of Engine values, for tables indexed by engine. Derived from the last
+ * enumerator, so it must be updated whenever an engine is appended.
+ */
+inline constexpr std::size_t engine_count = static_cast<std::size_t>(Engine::NFA) + 1;
+
+/**
+ * @brief Provides a string representation for an Engine, matching its solver registry name.
+ * @param engine The engine.
+ * @return A string_view literal for the specified engine.
+ */
+inline std::string_view engineToString(Engine engine) {
+    switch (engine) {
+        case Engine::RECURSIVE:
+            return "recursive";
+        case Engine::MEMO:
+            return "memo";
+        case Engine::DP:
+            return "dp";
+        case Engine::GREEDY:
+            return "greedy";
+        case Engine::BYTECODE:
+            return "bytecode";
+        case Engine::JIT:
+            return "jit";
+        case Engine::NFA:
+            return "nfa";
+    }
+    // This path is unreachable if all enum values are handled in the switch.
+    APP_UNREACHABLE();
+}
+
+/**
+ * @brief Looks up an Engine by the name returned from engineToString.
+ * @param name The engine name.
+ * @return The Engine, or std::nullopt if the name is unknown.
+ */
+inline std::optional<Engine> engineFromString(std::string_view name) {
+    for (Engine engine : {Engine::RECURSIVE, Engine::MEMO, Engine::DP, Engine::GREEDY,
+                          Engine::BYTECODE, Engine::JIT, Engine::NFA}) {
+        if (engineToString(engine) == name) {
+            return engine;
+        }
+    }
+    return std::nullopt;
+}
\ No newline at end of file
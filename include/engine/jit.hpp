@@ -0,0 +1,433 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "engine/bytecode.hpp"
+#include "utils/masked_literal.hpp"
+#include "utils/parser.hpp"
+#include "utils/simd.hpp"
+
+/**
+ * @brief Enables the native code generator on x86-64 Linux; every other target uses the bytecode
+ * interpreter.
+ */
+#if defined(__x86_64__) && defined(__linux__)
+#define APP_JIT_X86_64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Options controlling how a pattern is JIT-compiled.
+ */
+struct JitOptions {
+    // Append the generated code to /tmp/perf-<pid>.map so that `perf` can symbolize it.
+    bool write_perf_map = false;
+    // The symbol name reported in the perf map.
+    std::string symbol_name = "wildcard_jit";
+};
+
+/**
+ * @brief A pattern JIT-compiled into native x86-64 code.
+ *
+ * The generated function has the signature `bool(const char*, size_t)`. Anchored literals are
+ * compared against immediates embedded in the instruction stream (8, 4, 2 and 1 byte at a time),
+ * '?' runs become fixed offsets, and every segment between two '*' is located through a call into
+ * the shared vectorized window search. When native code cannot be generated (another architecture
+ * or operating system, executable memory is unavailable, or the pattern has case-folded literals
+ * or dialect tokens) the matcher transparently falls back to the BytecodeProgram, which runs
+ * dialect patterns on its automaton.
+ */
+class JitMatcher {
+   public:
+    using MatchFunction = bool (*)(const char*, std::size_t);
+
+    /**
+     * @brief Compiles a token vector into native code, or into bytecode as a fallback.
+     * @param p_tokens The tokenized pattern vector.
+     * @param options Options controlling code generation.
+     * @return The compiled matcher.
+     */
+    static JitMatcher compile(const std::vector<Token>& p_tokens, const JitOptions& options = {}) {
+        JitMatcher matcher;
+        matcher.program = BytecodeProgram::compile(p_tokens);
+#if defined(APP_JIT_X86_64)
+        matcher.generate(p_tokens, options);
+#else
+        (void)options;
+#endif
+        return matcher;
+    }
+
+    JitMatcher(JitMatcher&& other) noexcept { *this = std::move(other); }
+
+    JitMatcher& operator=(JitMatcher&& other) noexcept {
+        if (this != &other) {
+            release();
+            program = std::move(other.program);
+            segments = std::move(other.segments);
+            native = std::exchange(other.native, nullptr);
+            code_memory = std::exchange(other.code_memory, nullptr);
+            code_size = std::exchange(other.code_size, 0);
+        }
+        return *this;
+    }
+
+    JitMatcher(const JitMatcher&) = delete;
+    JitMatcher& operator=(const JitMatcher&) = delete;
+
+    ~JitMatcher() { release(); }
+
+    /**
+     * @brief Matches a text against the compiled pattern.
+     * @param s The text string view to match.
+     * @return true if the text matches, false otherwise.
+     */
+    bool match(std::string_view s) const {
+        return native != nullptr ? native(s.data(), s.length()) : program.match(s);
+    }
+
+    /**
+     * @brief Returns true if the pattern was compiled into native code.
+     */
+    bool isNative() const { return native != nullptr; }
+
+    /**
+     * @brief Returns the generated function, or nullptr if the interpreter is used.
+     */
+    MatchFunction function() const { return native; }
+
+    /**
+     * @brief Returns the number of bytes held by the matcher (code, segments and fallback).
+     */
+    std::size_t spaceUsed() const {
+        std::size_t space =
+            code_size + program.spaceUsed() + segments.capacity() * sizeof(Segment);
+        for (const auto& segment : segments) {
+            space += segment.window.bytes.capacity() + segment.window.mask.capacity();
+        }
+        return space;
+    }
+
+   private:
+    /**
+     * @brief A segment between two '*' that the generated code searches for through a call.
+     */
+    struct Segment {
+        MaskedLiteral window;
+        bool is_literal;  // True if the window has no '?' and can use a plain substring search.
+    };
+
+    BytecodeProgram program;        // The interpreter fallback, always available.
+    std::vector<Segment> segments;  // Referenced by address from the generated code.
+    MatchFunction native = nullptr;
+    void* code_memory = nullptr;
+    std::size_t code_size = 0;
+
+    JitMatcher() = default;
+
+    /**
+     * @brief [private] Unmaps the generated code, if any.
+     */
+    void release() {
+#if defined(APP_JIT_X86_64)
+        if (code_memory != nullptr) {
+            munmap(code_memory, code_size);
+        }
+#endif
+        code_memory = nullptr;
+        code_size = 0;
+        native = nullptr;
+    }
+
+    /**
+     * @brief [private] Called from the generated code to find the segment at or after `pos`.
+     * @return The text index just past the occurrence, or SIZE_MAX if there is none.
+     */
+    static std::size_t findSegment(const char* text, std::size_t m, std::size_t pos,
+                                   const Segment* segment) {
+        const MaskedLiteral& window = segment->window;
+        std::size_t found;
+        if (segment->is_literal) {
+            found = std::string_view(text, m).find(window.bytes, pos);
+        } else {
+            found = findMaskedWindow(text, m, pos, window.bytes.data(), window.mask.data(),
+                                     window.length());
+        }
+        return found == std::string_view::npos ? found : found + window.length();
+    }
+
+#if defined(APP_JIT_X86_64)
+    /**
+     * @brief [private] A minimal x86-64 machine code assembler for the generated matcher.
+     *
+     * Register usage: rbx = text, r12 = text length, r13 = current position, r9 = base of the tail
+     * segment. rbx, r12 and r13 are callee-saved, so they survive calls into `findSegment`.
+     */
+    class Assembler {
+       public:
+        std::vector<std::uint8_t> buffer;
+        std::vector<std::size_t> fail_fixups;  // rel32 fields that must jump to the fail label.
+
+        enum class Base { TEXT, TAIL };  // [rbx + disp] or [r9 + disp]
+
+        void bytes(std::initializer_list<std::uint8_t> values) {
+            buffer.insert(buffer.end(), values);
+        }
+
+        template <typename T>
+        void imm(T value) {
+            std::uint8_t raw[sizeof(T)];
+            std::memcpy(raw, &value, sizeof(T));
+            buffer.insert(buffer.end(), raw, raw + sizeof(T));
+        }
+
+        // Emits a jcc/jmp rel32 to the fail label; `opcode` is the full opcode byte sequence
+        void jumpToFail(std::initializer_list<std::uint8_t> opcode) {
+            bytes(opcode);
+            fail_fixups.push_back(buffer.size());
+            imm<std::int32_t>(0);
+        }
+
+        void bindFail() {
+            for (std::size_t at : fail_fixups) {
+                const auto rel = static_cast<std::int32_t>(buffer.size() - (at + 4));
+                std::memcpy(buffer.data() + at, &rel, sizeof(rel));
+            }
+        }
+
+        // cmp [base + disp32], imm (1, 2, 4 or 8 bytes of the literal); jne fail
+        void compareLiteral(Base base, std::int32_t disp, const char* literal, std::size_t len) {
+            const bool tail = base == Base::TAIL;
+            // ModRM byte: mod = 10 (disp32), rm = rbx (011) or r9 (001 + REX.B)
+            const auto modrm = [tail](std::uint8_t reg) {
+                return static_cast<std::uint8_t>(0x80 | (reg << 3) | (tail ? 0x01 : 0x03));
+            };
+            std::size_t i = 0;
+            for (; i + 8 <= len; i += 8) {
+                std::uint64_t value;
+                std::memcpy(&value, literal + i, 8);
+                bytes({0x48, 0xB8});  // mov rax, imm64
+                imm(value);
+                bytes({static_cast<std::uint8_t>(tail ? 0x49 : 0x48), 0x39, modrm(0)});  // cmp
+                imm(static_cast<std::int32_t>(disp + i));
+                jumpToFail({0x0F, 0x85});
+            }
+            if (i + 4 <= len) {
+                std::uint32_t value;
+                std::memcpy(&value, literal + i, 4);
+                if (tail) {
+                    bytes({0x41});
+                }
+                bytes({0x81, modrm(7)});  // cmp dword [base + disp32], imm32
+                imm(static_cast<std::int32_t>(disp + i));
+                imm(value);
+                jumpToFail({0x0F, 0x85});
+                i += 4;
+            }
+            if (i + 2 <= len) {
+                std::uint16_t value;
+                std::memcpy(&value, literal + i, 2);
+                bytes({0x66});
+                if (tail) {
+                    bytes({0x41});
+                }
+                bytes({0x81, modrm(7)});  // cmp word [base + disp32], imm16
+                imm(static_cast<std::int32_t>(disp + i));
+                imm(value);
+                jumpToFail({0x0F, 0x85});
+                i += 2;
+            }
+            if (i < len) {
+                if (tail) {
+                    bytes({0x41});
+                }
+                bytes({0x80, modrm(7)});  // cmp byte [base + disp32], imm8
+                imm(static_cast<std::int32_t>(disp + i));
+                imm(static_cast<std::uint8_t>(literal[i]));
+                jumpToFail({0x0F, 0x85});
+            }
+        }
+
+        // Compares every literal of a fixed-width window; '?' positions are simply skipped
+        void compareWindow(Base base, const MaskedLiteral& window) {
+            std::size_t i = 0;
+            while (i < window.length()) {
+                if (window.mask[i] == '\0') {
+                    ++i;
+                    continue;
+                }
+                std::size_t end = i;
+                while (end < window.length() && window.mask[end] != '\0') {
+                    ++end;
+                }
+                compareLiteral(base, static_cast<std::int32_t>(i), window.bytes.data() + i,
+                               end - i);
+                i = end;
+            }
+        }
+    };
+
+    /**
+     * @brief [private] Generates native code for the pattern and maps it as executable.
+     */
+    void generate(const std::vector<Token>& p_tokens, const JitOptions& options) {
+        if (program.usesAutomaton()) {
+            return;  // Dialect tokens are left to the program's automaton
+        }
+        const std::vector<MaskedLiteral> windows = MaskedLiteralCompiler::compile(p_tokens);
+        for (const auto& window : windows) {
+            if (window.mask.find('\xDF') != std::string::npos) {
+                return;  // Case-folded letters are left to the interpreter's masked compares
+            }
+        }
+
+        // Split the pattern into the anchored head, the searched middle segments and the tail
+        bool has_star = false;
+        bool trailing_star = false;
+        const MaskedLiteral* head = nullptr;
+        const MaskedLiteral* tail = nullptr;
+        std::vector<const MaskedLiteral*> middle;
+        for (std::size_t j = 0; j < p_tokens.size(); ++j) {
+            if (p_tokens[j].type == TokenType::ANY_SEQUENCE) {
+                has_star = true;
+                trailing_star = j + 1 == p_tokens.size();
+            } else if (windows[j].token_count > 0) {
+                if (!has_star) {
+                    head = &windows[j];
+                } else {
+                    middle.push_back(&windows[j]);
+                }
+            }
+        }
+        if (has_star && !trailing_star && !middle.empty()) {
+            tail = middle.back();
+            middle.pop_back();
+        }
+
+        // Every displacement and length must fit in a signed 32-bit immediate
+        std::size_t min_length = 0;
+        for (const auto* window : {head, tail}) {
+            min_length += window != nullptr ? window->length() : 0;
+        }
+        for (const auto* window : middle) {
+            min_length += window->length();
+        }
+        if (min_length > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+            return;
+        }
+
+        segments.reserve(middle.size());
+        Assembler a;
+        using Base = Assembler::Base;
+
+        // Prologue: save callee-saved registers and move the arguments into them
+        a.bytes({0x53, 0x41, 0x54, 0x41, 0x55});  // push rbx; push r12; push r13
+        a.bytes({0x48, 0x89, 0xFB});              // mov rbx, rdi
+        a.bytes({0x49, 0x89, 0xF4});              // mov r12, rsi
+        a.bytes({0x45, 0x31, 0xED});              // xor r13d, r13d
+
+        // Reject texts shorter than the pattern's minimum length (or of a different length if the
+        // pattern contains no '*')
+        a.bytes({0x49, 0x81, 0xFC});  // cmp r12, imm32
+        a.imm(static_cast<std::int32_t>(min_length));
+        if (has_star) {
+            a.jumpToFail({0x0F, 0x82});  // jb fail
+        } else {
+            a.jumpToFail({0x0F, 0x85});  // jne fail
+        }
+
+        if (head != nullptr) {
+            a.compareWindow(Base::TEXT, *head);
+            a.bytes({0x49, 0xC7, 0xC5});  // mov r13, imm32
+            a.imm(static_cast<std::int32_t>(head->length()));
+        }
+
+        for (const auto* window : middle) {
+            if (window->isWildcard()) {
+                // A run of '?' between two stars consumes a fixed number of characters
+                a.bytes({0x49, 0x81, 0xC5});  // add r13, imm32
+                a.imm(static_cast<std::int32_t>(window->length()));
+                a.bytes({0x4D, 0x39, 0xE5});  // cmp r13, r12
+                a.jumpToFail({0x0F, 0x87});   // ja fail
+                continue;
+            }
+            segments.push_back({*window, window->isExact()});
+            a.bytes({0x48, 0x89, 0xDF});  // mov rdi, rbx
+            a.bytes({0x4C, 0x89, 0xE6});  // mov rsi, r12
+            a.bytes({0x4C, 0x89, 0xEA});  // mov rdx, r13
+            a.bytes({0x48, 0xB9});        // mov rcx, imm64 (segment)
+            a.imm(reinterpret_cast<std::uint64_t>(&segments.back()));
+            a.bytes({0x48, 0xB8});  // mov rax, imm64 (findSegment)
+            a.imm(reinterpret_cast<std::uint64_t>(&JitMatcher::findSegment));
+            a.bytes({0xFF, 0xD0});              // call rax
+            a.bytes({0x48, 0x83, 0xF8, 0xFF});  // cmp rax, -1
+            a.jumpToFail({0x0F, 0x84});         // je fail
+            a.bytes({0x49, 0x89, 0xC5});        // mov r13, rax
+        }
+
+        if (tail != nullptr) {
+            // The tail starts at m - len, which must not precede the current position
+            a.bytes({0x4D, 0x89, 0xE0});  // mov r8, r12
+            a.bytes({0x49, 0x81, 0xE8});  // sub r8, imm32
+            a.imm(static_cast<std::int32_t>(tail->length()));
+            a.bytes({0x4D, 0x39, 0xE8});        // cmp r8, r13
+            a.jumpToFail({0x0F, 0x82});         // jb fail
+            a.bytes({0x4E, 0x8D, 0x0C, 0x03});  // lea r9, [rbx + r8]
+            a.compareWindow(Base::TAIL, *tail);
+        }
+
+        // Success and failure epilogues
+        a.bytes({0xB8, 0x01, 0x00, 0x00, 0x00});  // mov eax, 1
+        a.bytes({0xEB, 0x02});                    // jmp +2 (over the xor)
+        a.bindFail();
+        a.bytes({0x31, 0xC0});                          // xor eax, eax
+        a.bytes({0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3});  // pop r13; pop r12; pop rbx; ret
+
+        // Map the code writable, copy it in, then flip the pages to read + execute (W^X)
+        const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t size = (a.buffer.size() + page - 1) / page * page;
+        void* memory =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            segments.clear();
+            return;
+        }
+        std::memcpy(memory, a.buffer.data(), a.buffer.size());
+        if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+            munmap(memory, size);
+            segments.clear();
+            return;
+        }
+
+        code_memory = memory;
+        code_size = size;
+        native = reinterpret_cast<MatchFunction>(memory);
+
+        if (options.write_perf_map) {
+            writePerfMap(memory, a.buffer.size(), options.symbol_name);
+        }
+    }
+
+    /**
+     * @brief [private] Appends a symbol for the generated code to the perf map of this process.
+     */
+    static void writePerfMap(const void* start, std::size_t size, const std::string& name) {
+        const std::string path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+        if (std::FILE* file = std::fopen(path.c_str(), "a")) {
+            std::fprintf(file, "%lx %zx %s\n", reinterpret_cast<unsigned long>(start), size,
+                         name.c_str());
+            std::fclose(file);
+        }
+    }
+#endif
+};
\ No newline at end of file
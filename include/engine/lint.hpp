@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "engine/cost_model.hpp"
+#include "engine/engines.hpp"
+#include "engine/pattern_shape.hpp"
+#include "utils/issues.hpp"
+#include "utils/parser.hpp"
+#include "utils/validator.hpp"
+
+/**
+ * @brief Thresholds for PerformanceLinter::lintPerformance.
+ */
+struct LintOptions {
+    // The longest text the pattern will be matched against; 0 disables the length check.
+    size_t max_text_length = 0;
+    // Number of '*' wildcards separated by short literals from which a pattern is reported.
+    size_t star_threshold = 4;
+    // Literals up to this many characters are considered short (and common in typical texts).
+    size_t short_literal_length = 2;
+};
+
+/**
+ * @brief Reports patterns that are valid but expensive to match.
+ *
+ * The checks need the shape analysis and the cost model of the engine layer, so they live here
+ * rather than in Validator; the findings are still turned into Issues by Validator.
+ */
+class PerformanceLinter {
+   public:
+    /**
+     * @brief Reports patterns that are valid but known to trigger slow matching paths.
+     *
+     * All findings are warnings positioned at the offending token, using the token positions
+     * recorded by Parser::parse:
+     * - MANY_STARS_WITH_SHORT_LITERALS at the '*' where `star_threshold` wildcards separated by
+     *   short literals are reached; every occurrence of such a literal restarts the search;
+     * - LEADING_STAR_SHORT_LITERAL at a short literal that directly follows a leading '*' and is
+     *   not the end of the pattern, so it is searched for all over the text;
+     * - PATTERN_LONGER_THAN_TEXT at the token where the minimum match length first exceeds
+     *   `max_text_length`, so the pattern can never match.
+     *
+     * @param parse_result The result from Parser::parse.
+     * @param options The lint thresholds.
+     * @return A vector of warnings.
+     */
+    static std::vector<Issue> lintPerformance(const ParseResult& parse_result,
+                                              const LintOptions& options = {}) {
+        const auto& tokens = parse_result.tokens;
+        const auto& positions = parse_result.token_positions;
+        const auto is_short_literal = [&](size_t j) {
+            return j < tokens.size() && tokens[j].type == TokenType::LITERAL_SEQUENCE &&
+                   tokens[j].value && tokens[j].value->length() <= options.short_literal_length;
+        };
+
+        std::vector<ParseEvent> events;
+        size_t stars = 0;
+        size_t short_literals = 0;        // Literals after the first '*' ...
+        bool only_short_literals = true;  // ... and whether all of them are short
+        size_t min_length = 0;
+        bool too_long_reported = false;
+        for (size_t j = 0; j < tokens.size() && j < positions.size(); ++j) {
+            switch (tokens[j].type) {
+                case TokenType::ANY_SEQUENCE:
+                    stars++;
+                    if (stars == options.star_threshold && short_literals > 0 &&
+                        only_short_literals) {
+                        events.push_back({IssueCode::MANY_STARS_WITH_SHORT_LITERALS, positions[j],
+                                          std::to_string(options.short_literal_length)});
+                    }
+                    break;
+                case TokenType::LITERAL_SEQUENCE:
+                    if (stars > 0) {
+                        short_literals += is_short_literal(j) ? 1 : 0;
+                        only_short_literals = only_short_literals && is_short_literal(j);
+                    }
+                    min_length += tokens[j].value ? tokens[j].value->length() : 0;
+                    break;
+                case TokenType::ANY_CHAR:
+                case TokenType::CHAR_CLASS:
+                    min_length++;
+                    break;
+                case TokenType::ALTERNATION:
+                    min_length += shortestAlternative(tokens[j]);
+                    break;
+                case TokenType::SEGMENT_SEQUENCE:
+                case TokenType::ANY_SEGMENTS:
+                    break;
+            }
+
+            if (j == 1 && tokens[0].type == TokenType::ANY_SEQUENCE && is_short_literal(1) &&
+                tokens.size() > 2) {
+                events.push_back({IssueCode::LEADING_STAR_SHORT_LITERAL, positions[j],
+                                  *tokens[j].value});
+            }
+            if (options.max_text_length > 0 && min_length > options.max_text_length &&
+                !too_long_reported) {
+                events.push_back({IssueCode::PATTERN_LONGER_THAN_TEXT, positions[j],
+                                  std::to_string(options.max_text_length)});
+                too_long_reported = true;
+            }
+        }
+
+        return Validator::validateEvents(events);
+    }
+
+    /**
+     * @brief Reports the outcome of CostModel::admit as Issues.
+     *
+     * A rejected pattern yields a PATTERN_TOO_EXPENSIVE error and a pattern moved to a cheaper
+     * engine an ENGINE_DOWNGRADED warning. Both concern the pattern as a whole rather than one
+     * position in it.
+     *
+     * @param decision The admission decision.
+     * @return A vector of issues found.
+     */
+    static std::vector<Issue> validateAdmission(const AdmissionDecision& decision) {
+        std::vector<ParseEvent> events;
+        if (!decision.admitted) {
+            const EngineCost& cost = decision.requested_cost;
+            events.push_back(
+                {IssueCode::PATTERN_TOO_EXPENSIVE, 0,
+                 std::format("{} steps and {} bytes on the '{}' engine for a text of {} characters",
+                             cost.steps, cost.bytes, engineToString(cost.engine),
+                             decision.text_length)});
+        } else if (decision.isDowngraded()) {
+            events.push_back({IssueCode::ENGINE_DOWNGRADED, 0,
+                              std::format("'{}' to '{}'", engineToString(decision.requested),
+                                          engineToString(decision.engine))});
+        }
+        return Validator::validateEvents(events);
+    }
+};
\ No newline at end of file
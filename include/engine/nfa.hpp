@@ -0,0 +1,415 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "utils/parser.hpp"
+#include "utils/simd.hpp"
+
+/**
+ * @brief A pattern compiled into a position automaton and simulated bit-parallel.
+ *
+ * Every character the pattern can consume (each literal byte, '?' and '*') is one position of a
+ * Glushkov automaton, which has no epsilon moves: `follow` holds for each position the positions
+ * that may consume the next character, and `accepts` for each byte the positions that can consume
+ * it. A text byte advances the whole state set with a union of follow sets and a single AND.
+ *
+ * This is the engine for the opt-in dialect tokens. An ALTERNATION contributes the positions of
+ * each of its alternatives once, so the automaton grows with the pattern text rather than with the
+ * number of strings the braces would expand to. A CHAR_CLASS is a single position whose accept
+ * bits come straight from the class bitmap. A path '*' (SEGMENT_SEQUENCE) is a '*' that does not
+ * accept '/', and a '**' segment (ANY_SEGMENTS) is an optional '*' followed by a '/' position.
+ *
+ * While a '*' is the only active position, every byte that no position after it can consume leaves
+ * the state unchanged. Such runs are skipped with a vectorized byte-class search, so `*[0-9]` or
+ * `*.{jpg,png}` only simulate the automaton at the candidate bytes, and a leading '**' jumps from
+ * one '/' to the next.
+ */
+class NfaMatcher {
+   public:
+    /**
+     * @brief Compiles a token vector into an automaton.
+     * @param p_tokens The tokenized pattern vector.
+     * @return The compiled matcher.
+     */
+    static NfaMatcher compile(const std::vector<Token>& p_tokens) {
+        NfaMatcher matcher;
+        matcher.position_count = countPositions(p_tokens);
+        matcher.word_count = (matcher.position_count + 63) / 64;
+        matcher.follow.assign(matcher.position_count * matcher.word_count, 0);
+        matcher.accepts.assign(256 * matcher.word_count, 0);
+
+        const Fragment pattern = matcher.compileSequence(p_tokens);
+        matcher.initial = pattern.first;
+        matcher.final = pattern.last;
+        matcher.nullable = pattern.nullable;
+        matcher.buildSkipTables();
+        return matcher;
+    }
+
+    /**
+     * @brief Matches a text against the automaton.
+     * @param s The text string view to match.
+     * @return true if the whole text matches the pattern, false otherwise.
+     */
+    bool match(std::string_view s) const {
+        if (s.empty()) {
+            return nullable;
+        }
+        if (word_count == 1) {
+            return matchSingleWord(s);
+        }
+
+        std::vector<Word> current(word_count);
+        std::vector<Word> next(word_count);
+        size_t single = none;  // The only active position, if there is just one
+        for (size_t i = 0; i < s.length(); ++i) {
+            if (single != none && skip_of[single] != none) {
+                i = findByteInClass(s.data(), s.length(), i, skip_tables[skip_of[single]]);
+                if (i == not_found) {
+                    break;
+                }
+            }
+
+            // The states reachable by consuming s[i], restricted to those accepting it
+            if (i == 0) {
+                next = initial;
+            } else {
+                std::fill(next.begin(), next.end(), 0);
+                forEachPosition(current.data(), [&](size_t p) {
+                    const Word* set = follow.data() + p * word_count;
+                    for (size_t w = 0; w < word_count; ++w) {
+                        next[w] |= set[w];
+                    }
+                });
+            }
+
+            const Word* accept = acceptsOf(s[i]);
+            size_t active = 0;
+            single = none;
+            for (size_t w = 0; w < word_count; ++w) {
+                next[w] &= accept[w];
+                if (next[w] != 0) {
+                    active += static_cast<size_t>(std::popcount(next[w]));
+                    single = w * 64 + static_cast<size_t>(std::countr_zero(next[w]));
+                }
+            }
+            if (active == 0) {
+                return false;
+            }
+            single = active == 1 && !skip_of.empty() ? single : none;
+            current.swap(next);
+        }
+
+        for (size_t w = 0; w < word_count; ++w) {
+            if ((current[w] & final[w]) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the number of positions (states other than the start state).
+     */
+    size_t positionCount() const { return position_count; }
+
+    /**
+     * @brief Returns the number of bytes held by the automaton.
+     */
+    size_t spaceUsed() const {
+        return (follow.capacity() + accepts.capacity() + initial.capacity() + final.capacity()) *
+                   sizeof(Word) +
+               skip_tables.capacity() * sizeof(ByteClassTable) +
+               skip_of.capacity() * sizeof(std::uint32_t);
+    }
+
+   private:
+    using Word = std::uint64_t;
+    static constexpr std::uint32_t none = static_cast<std::uint32_t>(-1);
+    static constexpr size_t not_found = static_cast<size_t>(-1);
+
+    // The first and last positions of a sub-pattern and whether it matches the empty text.
+    struct Fragment {
+        std::vector<Word> first;
+        std::vector<Word> last;
+        bool nullable = true;
+    };
+
+    size_t position_count = 0;
+    size_t word_count = 0;
+    std::vector<Word> follow;   // position_count rows of word_count words.
+    std::vector<Word> accepts;  // 256 rows of word_count words, one per byte value.
+    std::vector<Word> initial;  // Positions that may consume the first character.
+    std::vector<Word> final;    // Positions that may consume the last character.
+    bool nullable = true;       // True if the pattern matches the empty text.
+    size_t next_position = 0;   // Used while compiling.
+    std::vector<ByteClassTable> skip_tables;  // Bytes that move the state off a lone '*'.
+    std::vector<std::uint32_t> skip_of;       // Skip table per position, or `none`; may be empty.
+
+    NfaMatcher() = default;
+
+    /**
+     * @brief [private] Counts the positions a token sequence needs.
+     */
+    static size_t countPositions(const std::vector<Token>& p_tokens) {
+        size_t count = 0;
+        for (const auto& token : p_tokens) {
+            switch (token.type) {
+                case TokenType::LITERAL_SEQUENCE:
+                    count += token.value->length();
+                    break;
+                case TokenType::ANY_CHAR:
+                case TokenType::ANY_SEQUENCE:
+                case TokenType::CHAR_CLASS:
+                case TokenType::SEGMENT_SEQUENCE:
+                    count++;
+                    break;
+                case TokenType::ANY_SEGMENTS:
+                    count += 2;
+                    break;
+                case TokenType::ALTERNATION:
+                    for (const auto& alternative : token.alternatives) {
+                        count += countPositions(alternative);
+                    }
+                    break;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief [private] Compiles a token sequence into a fragment.
+     */
+    Fragment compileSequence(const std::vector<Token>& p_tokens) {
+        Fragment sequence = emptyFragment();
+        for (const auto& token : p_tokens) {
+            switch (token.type) {
+                case TokenType::LITERAL_SEQUENCE:
+                    for (char c : *token.value) {
+                        const size_t p = addPosition();
+                        setBit(acceptsOf(c), p);
+                        if (token.fold_case && c >= 'a' && c <= 'z') {
+                            setBit(acceptsOf(static_cast<char>(c - 'a' + 'A')), p);
+                        }
+                        append(sequence, singleFragment(p));
+                    }
+                    break;
+                case TokenType::ANY_CHAR:
+                    append(sequence, singleFragment(addAnyPosition()));
+                    break;
+                case TokenType::CHAR_CLASS: {
+                    const size_t p = addPosition();
+                    for (size_t c = 0; c < 256; ++c) {
+                        if (token.char_class.contains(static_cast<unsigned char>(c))) {
+                            setBit(accepts.data() + c * word_count, p);
+                        }
+                    }
+                    append(sequence, singleFragment(p));
+                    break;
+                }
+                case TokenType::ANY_SEQUENCE: {
+                    const size_t p = addAnyPosition();
+                    setBit(followOf(p), p);
+                    Fragment star = singleFragment(p);
+                    star.nullable = true;
+                    append(sequence, star);
+                    break;
+                }
+                case TokenType::SEGMENT_SEQUENCE: {
+                    const size_t p = addAnyPosition();
+                    clearBit(acceptsOf('/'), p);
+                    setBit(followOf(p), p);
+                    Fragment star = singleFragment(p);
+                    star.nullable = true;
+                    append(sequence, star);
+                    break;
+                }
+                case TokenType::ANY_SEGMENTS: {
+                    // ('*' '/')?: the '*' may be skipped, but the '/' ends every match
+                    const size_t star = addAnyPosition();
+                    const size_t slash = addPosition();
+                    setBit(acceptsOf('/'), slash);
+                    setBit(followOf(star), star);
+                    setBit(followOf(star), slash);
+                    Fragment segments = singleFragment(slash);
+                    setBit(segments.first.data(), star);
+                    segments.nullable = true;
+                    append(sequence, segments);
+                    break;
+                }
+                case TokenType::ALTERNATION: {
+                    Fragment alternation = emptyFragment();
+                    alternation.nullable = token.alternatives.empty();
+                    for (const auto& alternative : token.alternatives) {
+                        const Fragment branch = compileSequence(alternative);
+                        unite(alternation.first, branch.first);
+                        unite(alternation.last, branch.last);
+                        alternation.nullable = alternation.nullable || branch.nullable;
+                    }
+                    append(sequence, alternation);
+                    break;
+                }
+            }
+        }
+        return sequence;
+    }
+
+    /**
+     * @brief [private] Concatenates a fragment to the end of a sequence.
+     */
+    void append(Fragment& sequence, const Fragment& next) {
+        forEachPosition(sequence.last.data(), [&](size_t p) { unite(followOf(p), next.first); });
+        if (sequence.nullable) {
+            unite(sequence.first, next.first);
+        }
+        if (next.nullable) {
+            unite(sequence.last, next.last);
+        } else {
+            sequence.last = next.last;
+        }
+        sequence.nullable = sequence.nullable && next.nullable;
+    }
+
+    /**
+     * @brief [private] Allocates a position that accepts every byte.
+     */
+    size_t addAnyPosition() {
+        const size_t p = addPosition();
+        for (size_t c = 0; c < 256; ++c) {
+            setBit(accepts.data() + c * word_count, p);
+        }
+        return p;
+    }
+
+    /**
+     * @brief [private] Allocates the next position.
+     */
+    size_t addPosition() { return next_position++; }
+
+    /**
+     * @brief [private] Returns a fragment that matches only the empty text.
+     */
+    Fragment emptyFragment() const {
+        return {std::vector<Word>(word_count, 0), std::vector<Word>(word_count, 0), true};
+    }
+
+    /**
+     * @brief [private] Returns a fragment consisting of a single position.
+     */
+    Fragment singleFragment(size_t p) const {
+        Fragment fragment = emptyFragment();
+        setBit(fragment.first.data(), p);
+        setBit(fragment.last.data(), p);
+        fragment.nullable = false;
+        return fragment;
+    }
+
+    /**
+     * @brief [private] Builds the skip table of every '*' position: the bytes on which the state
+     * {p} moves anywhere but back to {p}.
+     */
+    void buildSkipTables() {
+        for (size_t p = 0; p < position_count; ++p) {
+            const Word* set = follow.data() + p * word_count;
+            if (((set[p / 64] >> (p % 64)) & 1) == 0) {
+                continue;  // Only a '*' follows itself
+            }
+            std::uint64_t leaving[4] = {};
+            size_t leaving_count = 0;
+            for (size_t c = 0; c < 256; ++c) {
+                const Word* accept = accepts.data() + c * word_count;
+                for (size_t w = 0; w < word_count; ++w) {
+                    const Word self = w == p / 64 ? Word{1} << (p % 64) : 0;
+                    if ((set[w] & accept[w]) != self) {
+                        leaving[c / 64] |= std::uint64_t{1} << (c % 64);
+                        leaving_count++;
+                        break;
+                    }
+                }
+            }
+            if (leaving_count == 256) {
+                continue;  // Every byte leaves the state, nothing to skip
+            }
+            skip_of.resize(position_count, none);
+            skip_of[p] = static_cast<std::uint32_t>(skip_tables.size());
+            skip_tables.push_back(ByteClassTable::build(leaving));
+        }
+    }
+
+    /**
+     * @brief [private] Simulates the automaton when all positions fit into one word.
+     */
+    bool matchSingleWord(std::string_view s) const {
+        const Word* follow_sets = follow.data();
+        Word current = initial[0] & accepts[static_cast<unsigned char>(s[0])];
+        for (size_t i = 1; i < s.length() && current != 0; ++i) {
+            if (!skip_of.empty() && std::has_single_bit(current)) {
+                const std::uint32_t skip = skip_of[std::countr_zero(current)];
+                if (skip != none) {
+                    i = findByteInClass(s.data(), s.length(), i, skip_tables[skip]);
+                    if (i == not_found) {
+                        break;
+                    }
+                }
+            }
+            Word next = 0;
+            for (Word rest = current; rest != 0; rest &= rest - 1) {
+                next |= follow_sets[std::countr_zero(rest)];
+            }
+            current = next & accepts[static_cast<unsigned char>(s[i])];
+        }
+        return (current & final[0]) != 0;
+    }
+
+    /**
+     * @brief [private] Calls a function for every position in a set.
+     */
+    template <typename Callback>
+    void forEachPosition(const Word* set, Callback&& callback) const {
+        for (size_t w = 0; w < word_count; ++w) {
+            for (Word rest = set[w]; rest != 0; rest &= rest - 1) {
+                callback(w * 64 + static_cast<size_t>(std::countr_zero(rest)));
+            }
+        }
+    }
+
+    /**
+     * @brief [private] Adds every position of `other` to `set`.
+     */
+    void unite(Word* set, const std::vector<Word>& other) const {
+        for (size_t w = 0; w < word_count; ++w) {
+            set[w] |= other[w];
+        }
+    }
+    void unite(std::vector<Word>& set, const std::vector<Word>& other) const {
+        unite(set.data(), other);
+    }
+
+    /**
+     * @brief [private] Returns the follow set of a position.
+     */
+    Word* followOf(size_t p) { return follow.data() + p * word_count; }
+
+    /**
+     * @brief [private] Returns the set of positions accepting a byte.
+     */
+    Word* acceptsOf(char c) { return accepts.data() + static_cast<unsigned char>(c) * word_count; }
+    const Word* acceptsOf(char c) const {
+        return accepts.data() + static_cast<unsigned char>(c) * word_count;
+    }
+
+    /**
+     * @brief [private] Adds a position to a set.
+     */
+    static void setBit(Word* set, size_t p) { set[p / 64] |= Word{1} << (p % 64); }
+
+    /**
+     * @brief [private] Removes a position from a set.
+     */
+    static void clearBit(Word* set, size_t p) { set[p / 64] &= ~(Word{1} << (p % 64)); }
+};
\ No newline at end of file
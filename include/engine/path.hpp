@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "engine/nfa.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief Matches a path pattern (ParseOptions::path) one path segment at a time.
+ *
+ * The pattern is split at its '/' characters into segment patterns, and every ANY_SEGMENTS token
+ * ('**' as a whole segment) becomes a wildcard over whole segments. The text is split into
+ * segments once. Matching then runs the greedy two-pointer algorithm over segments instead of
+ * characters: every segment pattern consumes exactly one text segment, and on a mismatch the last
+ * '**' absorbs one more segment, so a failing segment skips the whole path component rather than
+ * being retried at every character. Without a '**' a text with a different number of segments is
+ * rejected before any segment is compared.
+ *
+ * A segment pattern that is an exact literal is compared directly; any other segment pattern runs
+ * on its own NfaMatcher, in which a path '*' is an ordinary '*' since a segment holds no '/'.
+ */
+class PathMatcher {
+   public:
+    /**
+     * @brief Compiles a token vector into segment patterns.
+     * @param p_tokens The tokenized pattern vector, parsed with ParseOptions::path.
+     * @return The matcher, or std::nullopt if the pattern uses no path wildcards or cannot be split
+     * at '/': a '/' inside an alternation, a '**' that is not a whole segment, or a basic '?' or
+     * '*', which may match a '/'. Such patterns are left to the NfaMatcher of the whole pattern.
+     */
+    static std::optional<PathMatcher> compile(const std::vector<Token>& p_tokens) {
+        PathMatcher matcher;
+        std::vector<Token> current;  // The tokens of the segment being built
+        bool uses_path = false;
+        for (const auto& token : p_tokens) {
+            if (token.type == TokenType::ANY_SEGMENTS) {
+                if (!current.empty()) {
+                    return std::nullopt;  // Always a whole segment when parsed in path mode
+                }
+                Segment segment;
+                segment.any_segments = true;
+                matcher.segments.push_back(std::move(segment));
+                matcher.any_segments = true;
+                uses_path = true;
+                continue;
+            }
+            if (token.type != TokenType::LITERAL_SEQUENCE) {
+                uses_path = uses_path || token.type == TokenType::SEGMENT_SEQUENCE;
+                if (!appendSegmentToken(token, current)) {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            // Every '/' of a literal ends the current segment
+            std::string_view literal = *token.value;
+            for (size_t slash = literal.find('/'); slash != std::string_view::npos;
+                 slash = literal.find('/')) {
+                appendLiteral(token, literal.substr(0, slash), current);
+                matcher.addSegment(std::move(current));
+                current.clear();
+                literal.remove_prefix(slash + 1);
+            }
+            appendLiteral(token, literal, current);
+        }
+        if (!uses_path) {
+            return std::nullopt;
+        }
+        matcher.addSegment(std::move(current));
+        return matcher;
+    }
+
+    /**
+     * @brief Splits a text into its '/'-separated segments, so one text can be matched against
+     * several path patterns without searching for its separators again.
+     * @param s The text string view.
+     * @return The segments; a text with k '/' characters has k+1 of them.
+     */
+    static std::vector<std::string_view> splitSegments(std::string_view s) {
+        std::vector<std::string_view> text_segments;
+        size_t begin = 0;
+        for (size_t slash = s.find('/'); slash != std::string_view::npos;
+             slash = s.find('/', begin)) {
+            text_segments.push_back(s.substr(begin, slash - begin));
+            begin = slash + 1;
+        }
+        text_segments.push_back(s.substr(begin));
+        return text_segments;
+    }
+
+    /**
+     * @brief Matches a text against the pattern.
+     * @param s The text string view to match.
+     * @return true if the whole text matches the pattern, false otherwise.
+     */
+    bool match(std::string_view s) const { return match(splitSegments(s)); }
+
+    /**
+     * @brief Matches a text given by its segments (see splitSegments()) against the pattern.
+     * @param text_segments The segments of the text.
+     * @return true if the whole text matches the pattern, false otherwise.
+     */
+    bool match(const std::vector<std::string_view>& text_segments) const {
+        const size_t m = text_segments.size();
+        const size_t n = segments.size();
+        if (m < fixed_segments || (!any_segments && m != fixed_segments)) {
+            return false;
+        }
+
+        size_t i = 0;
+        size_t j = 0;
+        size_t star_j = none;  // Index of the last '**' seen
+        size_t star_i = 0;     // Text segment the last '**' currently stops at
+        while (true) {
+            if (j < n) {
+                if (segments[j].any_segments) {
+                    star_j = j++;
+                    star_i = i;
+                    continue;
+                }
+                if (i < m && segments[j].matches(text_segments[i])) {
+                    ++i;
+                    ++j;
+                    continue;
+                }
+            } else if (i == m) {
+                return true;
+            }
+
+            // Mismatch or leftover segments: let the last '**' absorb one more segment
+            if (star_j == none || star_i >= m) {
+                return false;
+            }
+            i = ++star_i;
+            j = star_j + 1;
+        }
+    }
+
+    /**
+     * @brief Returns the number of segment patterns, including '**' segments.
+     */
+    size_t segmentCount() const { return segments.size(); }
+
+    /**
+     * @brief Returns the number of bytes held by the matcher.
+     */
+    size_t spaceUsed() const {
+        size_t space = segments.capacity() * sizeof(Segment);
+        for (const auto& segment : segments) {
+            space += segment.literal.capacity() +
+                     (segment.automaton ? segment.automaton->spaceUsed() : 0);
+        }
+        return space;
+    }
+
+   private:
+    static constexpr size_t none = static_cast<size_t>(-1);
+
+    struct Segment {
+        bool any_segments = false;            // A '**' that matches zero or more segments.
+        bool exact = false;                   // The segment pattern is the literal `literal`.
+        std::string literal;                  // The exact literal, if `exact`.
+        std::optional<NfaMatcher> automaton;  // Otherwise the automaton of the segment pattern.
+
+        bool matches(std::string_view text_segment) const {
+            return exact ? text_segment == literal : automaton->match(text_segment);
+        }
+    };
+
+    std::vector<Segment> segments;
+    size_t fixed_segments = 0;  // Number of segments other than '**'.
+    bool any_segments = false;  // True if there is at least one '**'.
+
+    PathMatcher() = default;
+
+    /**
+     * @brief [private] Adds the segment pattern made of a token vector.
+     */
+    void addSegment(std::vector<Token> segment_tokens) {
+        Segment segment;
+        if (segment_tokens.empty() ||
+            (segment_tokens.size() == 1 &&
+             segment_tokens.front().type == TokenType::LITERAL_SEQUENCE &&
+             !segment_tokens.front().fold_case)) {
+            segment.exact = true;
+            segment.literal = segment_tokens.empty() ? "" : *segment_tokens.front().value;
+        } else {
+            segment.automaton = NfaMatcher::compile(segment_tokens);
+        }
+        segments.push_back(std::move(segment));
+        fixed_segments++;
+    }
+
+    /**
+     * @brief [private] Appends a part of a literal that contains no '/' to a segment.
+     */
+    static void appendLiteral(const Token& source, std::string_view part,
+                              std::vector<Token>& segment_tokens) {
+        if (part.empty()) {
+            return;
+        }
+        Token literal = {TokenType::LITERAL_SEQUENCE, std::string(part)};
+        literal.fold_case = source.fold_case;
+        segment_tokens.push_back(std::move(literal));
+    }
+
+    /**
+     * @brief [private] Appends the segment-local form of a token to a segment: a path '*' becomes
+     * a plain '*' and a class of every byte but '/' a plain '?'.
+     * @return false if the token may match a '/' or span segments.
+     */
+    static bool appendSegmentToken(const Token& token, std::vector<Token>& segment_tokens) {
+        switch (token.type) {
+            case TokenType::SEGMENT_SEQUENCE:
+                segment_tokens.push_back({TokenType::ANY_SEQUENCE});
+                return true;
+            case TokenType::CHAR_CLASS: {
+                if (token.char_class.contains('/')) {
+                    return false;
+                }
+                CharClass any_but_slash;
+                any_but_slash.invert();
+                any_but_slash.remove('/');
+                segment_tokens.push_back(token.char_class == any_but_slash
+                                             ? Token{TokenType::ANY_CHAR}
+                                             : token);
+                return true;
+            }
+            case TokenType::LITERAL_SEQUENCE:
+                if (token.value->find('/') != std::string::npos) {
+                    return false;
+                }
+                segment_tokens.push_back(token);
+                return true;
+            case TokenType::ALTERNATION: {
+                Token alternation = {TokenType::ALTERNATION};
+                for (const auto& alternative : token.alternatives) {
+                    alternation.alternatives.emplace_back();
+                    for (const auto& inner : alternative) {
+                        if (!appendSegmentToken(inner, alternation.alternatives.back())) {
+                            return false;
+                        }
+                    }
+                }
+                segment_tokens.push_back(std::move(alternation));
+                return true;
+            }
+            case TokenType::ANY_CHAR:
+            case TokenType::ANY_SEQUENCE:
+            case TokenType::ANY_SEGMENTS:
+                break;
+        }
+        return false;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "utils/parser.hpp"
+
+/**
+ * @brief Structural statistics of a token stream, as used by the Planner and the CostModel.
+ */
+struct PatternShape {
+    std::size_t token_count = 0;        // Number of tokens.
+    std::size_t star_count = 0;         // Number of ANY_SEQUENCE tokens.
+    std::size_t any_char_count = 0;     // Number of ANY_CHAR tokens.
+    std::size_t literal_length = 0;     // Total number of literal characters.
+    std::size_t longest_literal = 0;    // Length of the longest LITERAL_SEQUENCE token.
+    std::size_t min_text_length = 0;    // Shortest text the pattern can possibly match.
+    std::size_t alternation_count = 0;  // Number of ALTERNATION tokens, including nested ones.
+    std::size_t char_class_count = 0;   // Number of CHAR_CLASS tokens, including nested ones.
+    std::size_t path_star_count = 0;    // Number of SEGMENT_SEQUENCE and ANY_SEGMENTS tokens.
+    std::size_t position_count = 0;     // Characters and wildcards over all alternatives.
+
+    /**
+     * @brief Returns true if the pattern uses opt-in dialect tokens, which only the NFA engine
+     * runs. The star, '?' and literal counts then cover the top level only.
+     */
+    bool usesDialect() const {
+        return alternation_count > 0 || char_class_count > 0 || path_star_count > 0;
+    }
+
+    /**
+     * @brief The fraction of fixed-width positions that are '?' rather than literal characters.
+     */
+    double anyCharDensity() const {
+        return min_text_length == 0 ? 0.0
+                                    : static_cast<double>(any_char_count) /
+                                          static_cast<double>(min_text_length);
+    }
+};
+
+/**
+ * @brief Computes the structural statistics of a token stream.
+ * @param p_tokens The tokenized pattern vector.
+ * @return The PatternShape of the pattern.
+ */
+inline PatternShape analyzePattern(const std::vector<Token>& p_tokens) {
+    PatternShape shape;
+    shape.token_count = p_tokens.size();
+    for (const auto& token : p_tokens) {
+        switch (token.type) {
+            case TokenType::ANY_SEQUENCE:
+                shape.star_count++;
+                shape.position_count++;
+                break;
+            case TokenType::ANY_CHAR:
+                shape.any_char_count++;
+                shape.min_text_length++;
+                shape.position_count++;
+                break;
+            case TokenType::SEGMENT_SEQUENCE:
+                shape.path_star_count++;
+                shape.position_count++;
+                break;
+            case TokenType::ANY_SEGMENTS:
+                shape.path_star_count++;
+                shape.position_count += 2;
+                break;
+            case TokenType::CHAR_CLASS:
+                shape.char_class_count++;
+                shape.min_text_length++;
+                shape.position_count++;
+                break;
+            case TokenType::LITERAL_SEQUENCE: {
+                const std::size_t length = token.value ? token.value->length() : 0;
+                shape.literal_length += length;
+                shape.min_text_length += length;
+                shape.position_count += length;
+                if (length > shape.longest_literal) {
+                    shape.longest_literal = length;
+                }
+                break;
+            }
+            case TokenType::ALTERNATION: {
+                std::size_t shortest = static_cast<std::size_t>(-1);
+                shape.alternation_count++;
+                for (const auto& alternative : token.alternatives) {
+                    const PatternShape inner = analyzePattern(alternative);
+                    shape.alternation_count += inner.alternation_count;
+                    shape.char_class_count += inner.char_class_count;
+                    shape.path_star_count += inner.path_star_count;
+                    shape.position_count += inner.position_count;
+                    shortest = std::min(shortest, inner.min_text_length);
+                }
+                shape.min_text_length += token.alternatives.empty() ? 0 : shortest;
+                break;
+            }
+        }
+    }
+    return shape;
+}
+
+/**
+ * @brief Returns the length of the shortest text an ALTERNATION token can match.
+ * @param token The ALTERNATION token.
+ * @return The minimum over its alternatives.
+ */
+inline std::size_t shortestAlternative(const Token& token) {
+    std::size_t shortest = static_cast<std::size_t>(-1);
+    for (const auto& alternative : token.alternatives) {
+        shortest = std::min(shortest, analyzePattern(alternative).min_text_length);
+    }
+    return token.alternatives.empty() ? 0 : shortest;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "engine/engines.hpp"
+#include "engine/jit.hpp"
+#include "engine/pattern_shape.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief Chooses the cheapest engine for a pattern and a text from their shape alone.
+ *
+ * The recursive, memoized and DP solvers are never chosen: the greedy solver answers the same
+ * question in O(1) extra space and is never asymptotically slower. The compiling engines only pay
+ * off once the text is long enough to amortize their setup cost and the pattern has literals long
+ * enough for their vectorized substring search to skip ahead. Generating native code costs two
+ * system calls on top of the code generation, so the JIT is only chosen when the caller keeps the
+ * compiled JitMatcher for many texts. Patterns using dialect tokens always run on the NFA engine.
+ */
+class Planner {
+   public:
+    // Texts shorter than this are matched by the greedy solver, which has no setup cost.
+    static constexpr std::size_t short_text_length = 64;
+    // Texts at least this long amortize the cost of generating native code that is reused.
+    static constexpr std::size_t jit_text_length = 64 * 1024;
+    // Above this fraction of '?' positions, literal searches no longer skip much of the text.
+    static constexpr double max_any_char_density = 0.5;
+
+    /**
+     * @brief Computes the structural statistics of a token stream.
+     * @param p_tokens The tokenized pattern vector.
+     * @return The PatternShape of the pattern.
+     */
+    static PatternShape analyze(const std::vector<Token>& p_tokens) {
+        return analyzePattern(p_tokens);
+    }
+
+    /**
+     * @brief Chooses the engine to run a pattern on.
+     * @param p_tokens The tokenized pattern vector.
+     * @param text_length The length of the text that will be matched.
+     * @param reuses_program True if the compiled program is kept for further texts.
+     * @return The chosen Engine.
+     */
+    static Engine choose(const std::vector<Token>& p_tokens, std::size_t text_length,
+                         bool reuses_program = false) {
+        return choose(analyze(p_tokens), text_length, reuses_program);
+    }
+
+    /**
+     * @brief Chooses the engine to run a pattern of the given shape on.
+     * @param shape The PatternShape of the pattern.
+     * @param text_length The length of the text that will be matched.
+     * @param reuses_program True if the compiled program is kept for further texts.
+     * @return The chosen Engine.
+     */
+    static Engine choose(const PatternShape& shape, std::size_t text_length,
+                         bool reuses_program = false) {
+        // Dialect tokens only run on the automaton
+        if (shape.usesDialect()) {
+            return Engine::NFA;
+        }
+
+        // Without '*' every engine makes a single linear pass; skip the setup
+        if (shape.star_count == 0 || text_length < short_text_length ||
+            text_length < shape.min_text_length) {
+            return Engine::GREEDY;
+        }
+
+        // Single-character literals or mostly '?' leave nothing for a substring search to skip
+        if (shape.longest_literal < 2 || shape.anyCharDensity() > max_any_char_density) {
+            return Engine::GREEDY;
+        }
+
+#if defined(APP_JIT_X86_64)
+        if (reuses_program && text_length >= jit_text_length) {
+            return Engine::JIT;
+        }
+#endif
+        return Engine::BYTECODE;
+    }
+};
\ No newline at end of file
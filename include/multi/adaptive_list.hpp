@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/bytecode.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief The counters an AdaptivePatternList keeps for one pattern.
+ */
+struct PatternCounters {
+    std::uint64_t tries = 0;    // Times the pattern was evaluated.
+    std::uint64_t hits = 0;     // Times the pattern matched.
+    std::uint64_t samples = 0;  // Evaluations whose latency was measured.
+    std::uint64_t cost_ns = 0;  // Total latency of the measured evaluations in nanoseconds.
+
+    /**
+     * @brief The estimated probability that an evaluation matches, smoothed so that rarely tried
+     * patterns start out in the middle.
+     */
+    double hitRate() const {
+        return (static_cast<double>(hits) + 1.0) / (static_cast<double>(tries) + 2.0);
+    }
+
+    /**
+     * @brief The mean measured latency per evaluation in nanoseconds (at least 1).
+     */
+    double meanCostNs() const {
+        return samples == 0 ? 1.0
+                            : std::max(1.0, static_cast<double>(cost_ns) /
+                                                static_cast<double>(samples));
+    }
+
+    /**
+     * @brief The expected hits per nanosecond; higher scores are evaluated first.
+     */
+    double score() const { return hitRate() / meanCostNs(); }
+};
+
+/**
+ * @brief Options controlling how an AdaptivePatternList learns its evaluation order.
+ */
+struct AdaptiveListOptions {
+    // Every n-th query measures the latency of each pattern it evaluates.
+    std::size_t sample_interval = 64;
+    // The evaluation order is recomputed every n queries.
+    std::size_t reorder_interval = 1024;
+};
+
+/**
+ * @brief Answers "does any of these patterns match?" over an unordered pattern list, learning the
+ * evaluation order that finds a match fastest.
+ *
+ * Patterns are tried one by one until the first hit. Every try and hit is counted, and every
+ * `sample_interval`-th query also times each evaluation. Every `reorder_interval` queries the
+ * patterns are re-sorted by hits per nanosecond, which is the order minimizing the expected cost of
+ * a sequential search. Reordering never changes whether a text matches; since the list carries no
+ * priority, the reported pattern is simply the first matching one in the current order. An
+ * AdaptivePatternList is not thread-safe; use one per thread or guard it externally.
+ */
+class AdaptivePatternList {
+   public:
+    /**
+     * @brief Creates a list from raw pattern strings.
+     * @param patterns The pattern strings, which must already have passed validation.
+     * @param options Options controlling the learning.
+     * @return The pattern list; IDs are the indices in `patterns`.
+     */
+    static AdaptivePatternList create(const std::vector<std::string>& patterns,
+                                      AdaptiveListOptions options = {}) {
+        AdaptivePatternList list;
+        list.options = options;
+        list.options.sample_interval = std::max<std::size_t>(list.options.sample_interval, 1);
+        list.options.reorder_interval = std::max<std::size_t>(list.options.reorder_interval, 1);
+        for (std::size_t id = 0; id < patterns.size(); ++id) {
+            list.programs.push_back(BytecodeProgram::compile(Parser::parse(patterns[id]).tokens));
+            list.evaluation_order.push_back(id);
+        }
+        list.pattern_counters.resize(patterns.size());
+        return list;
+    }
+
+    /**
+     * @brief Finds a pattern matching a text, trying patterns in the learned order.
+     * @param s The text string view to match.
+     * @return The ID of the first matching pattern in the current order, or std::nullopt.
+     */
+    std::optional<std::size_t> matchAny(std::string_view s) {
+        const bool sampled = queries % options.sample_interval == 0;
+        std::optional<std::size_t> found;
+        for (std::size_t id : evaluation_order) {
+            PatternCounters& counters = pattern_counters[id];
+            counters.tries++;
+
+            bool hit = false;
+            if (sampled) {
+                const auto start_time = std::chrono::high_resolution_clock::now();
+                hit = programs[id].match(s);
+                const auto end_time = std::chrono::high_resolution_clock::now();
+                counters.samples++;
+                counters.cost_ns += static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time)
+                        .count());
+            } else {
+                hit = programs[id].match(s);
+            }
+
+            if (hit) {
+                counters.hits++;
+                found = id;
+                break;
+            }
+        }
+
+        if (++queries % options.reorder_interval == 0) {
+            reorder();
+        }
+        return found;
+    }
+
+    /**
+     * @brief Returns true if any pattern matches a text, see matchAny().
+     */
+    bool matches(std::string_view s) { return matchAny(s).has_value(); }
+
+    /**
+     * @brief Recomputes the evaluation order from the counters right away.
+     */
+    void reorder() {
+        std::stable_sort(evaluation_order.begin(), evaluation_order.end(),
+                         [&](std::size_t a, std::size_t b) {
+                             return pattern_counters[a].score() > pattern_counters[b].score();
+                         });
+    }
+
+    /**
+     * @brief Returns the pattern IDs in their current evaluation order.
+     */
+    const std::vector<std::size_t>& order() const { return evaluation_order; }
+
+    /**
+     * @brief Returns the counters of a pattern.
+     */
+    const PatternCounters& counters(std::size_t id) const { return pattern_counters[id]; }
+
+    /**
+     * @brief Writes the counters of every pattern in evaluation order, one line per pattern, e.g.
+     * `3 tries=120 hits=90 samples=2 cost_ns=84 score=0.01`.
+     * @param out The output stream.
+     */
+    void exportCounters(std::ostream& out) const {
+        for (std::size_t id : evaluation_order) {
+            const PatternCounters& entry = pattern_counters[id];
+            out << id << " tries=" << entry.tries << " hits=" << entry.hits
+                << " samples=" << entry.samples << " cost_ns=" << entry.cost_ns
+                << " score=" << entry.score() << '\n';
+        }
+    }
+
+    /**
+     * @brief Returns the number of patterns in the list.
+     */
+    std::size_t size() const { return programs.size(); }
+
+   private:
+    AdaptiveListOptions options;
+    std::vector<BytecodeProgram> programs;          // Indexed by pattern ID.
+    std::vector<PatternCounters> pattern_counters;  // Indexed by pattern ID.
+    std::vector<std::size_t> evaluation_order;      // Pattern IDs, most promising first.
+    std::uint64_t queries = 0;
+
+    AdaptivePatternList() = default;
+};
\ No newline at end of file
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief An Aho-Corasick automaton that finds every occurrence of a set of literals in one scan.
+ *
+ * The root keeps a dense 256-entry transition table, since nearly every text byte passes through
+ * it; all other states store their outgoing edges as a small sorted run in one flat edge array.
+ * Each state records the literal ending in it (literals are deduplicated, so there is at most one)
+ * and a dictionary link to the nearest state on its failure chain that also ends a literal. The
+ * tables are plain arrays of fixed-size records, so they can also be scanned in place from a
+ * memory-mapped file with scanTables().
+ */
+class AhoCorasick {
+   public:
+    static constexpr std::uint32_t none = static_cast<std::uint32_t>(-1);
+
+    struct FlatState {
+        std::uint32_t edge_begin = 0;     // First edge in the edge array.
+        std::uint32_t edge_count = 0;     // Number of edges, sorted by byte; 0 for the root.
+        std::uint32_t fail = 0;           // Longest proper suffix that is also a trie state.
+        std::uint32_t dictionary = none;  // Nearest state on the failure chain ending a literal.
+        std::uint32_t literal = none;     // ID of the literal ending in this state.
+    };
+
+    struct FlatEdge {
+        std::uint32_t byte;
+        std::uint32_t target;
+    };
+
+    /**
+     * @brief Builds the automaton.
+     * @param literals The literals to search for; their index is the literal ID. Empty literals are
+     * ignored and duplicates are reported under the ID of their first occurrence.
+     * @return The automaton.
+     */
+    static AhoCorasick build(const std::vector<std::string>& literals) {
+        AhoCorasick automaton;
+        std::vector<State> trie(1);
+
+        // 1. Insert every literal into the trie
+        for (size_t id = 0; id < literals.size(); ++id) {
+            if (literals[id].empty()) {
+                continue;
+            }
+            std::uint32_t state = 0;
+            for (char c : literals[id]) {
+                std::uint32_t next = automaton.child(trie, state, static_cast<unsigned char>(c));
+                if (next == none) {
+                    next = static_cast<std::uint32_t>(trie.size());
+                    trie.emplace_back();
+                    automaton.addEdge(trie, state, static_cast<unsigned char>(c), next);
+                }
+                state = next;
+            }
+            if (trie[state].flat.literal == none) {
+                trie[state].flat.literal = static_cast<std::uint32_t>(id);
+            }
+        }
+
+        // 2. Compute failure and dictionary links in breadth-first order
+        std::queue<std::uint32_t> queue;
+        for (size_t c = 0; c < 256; ++c) {
+            const std::uint32_t next = automaton.root[c];
+            if (next != none) {
+                trie[next].flat.fail = 0;
+                queue.push(next);
+            }
+        }
+        while (!queue.empty()) {
+            const std::uint32_t state = queue.front();
+            queue.pop();
+            for (const auto& [c, next] : trie[state].edges) {
+                std::uint32_t fail = trie[state].flat.fail;
+                while (fail != 0 && automaton.child(trie, fail, c) == none) {
+                    fail = trie[fail].flat.fail;
+                }
+                const std::uint32_t target = automaton.child(trie, fail, c);
+                trie[next].flat.fail = (target != none && target != next) ? target : 0;
+
+                FlatState& next_state = trie[next].flat;
+                const FlatState& fail_state = trie[next_state.fail].flat;
+                next_state.dictionary =
+                    fail_state.literal != none ? next_state.fail : fail_state.dictionary;
+                queue.push(next);
+            }
+        }
+
+        // 3. Make the root total so the scan never has to fall back from it
+        for (auto& next : automaton.root) {
+            if (next == none) {
+                next = 0;
+            }
+        }
+
+        // 4. Lay the states and their edges out in flat arrays
+        automaton.states.reserve(trie.size());
+        for (auto& state : trie) {
+            state.flat.edge_begin = static_cast<std::uint32_t>(automaton.edges.size());
+            state.flat.edge_count = static_cast<std::uint32_t>(state.edges.size());
+            for (const auto& [c, next] : state.edges) {
+                automaton.edges.push_back({c, next});
+            }
+            automaton.states.push_back(state.flat);
+        }
+        return automaton;
+    }
+
+    /**
+     * @brief Reports every occurrence of every literal in a text.
+     * @param s The text string view to scan.
+     * @param on_match Called as `on_match(literal_id, end)` for each occurrence, where `end` is the
+     * text index just past the occurrence.
+     */
+    template <typename Callback>
+    void scan(std::string_view s, Callback&& on_match) const {
+        scanTables(root.data(), states.data(), edges.data(), s, on_match);
+    }
+
+    /**
+     * @brief Runs a scan directly on flat automaton tables, e.g. tables mapped from a file.
+     * @param root The 256-entry root transition table.
+     * @param states The state table.
+     * @param edges The edge table.
+     * @param s The text string view to scan.
+     * @param on_match Called as `on_match(literal_id, end)` for each occurrence.
+     */
+    template <typename Callback>
+    static void scanTables(const std::uint32_t* root, const FlatState* states,
+                           const FlatEdge* edges, std::string_view s, Callback&& on_match) {
+        std::uint32_t state = 0;
+        for (size_t i = 0; i < s.length(); ++i) {
+            const auto c = static_cast<unsigned char>(s[i]);
+            std::uint32_t next = flatChild(root, states, edges, state, c);
+            while (next == none) {
+                state = states[state].fail;
+                next = flatChild(root, states, edges, state, c);
+            }
+            state = next;
+
+            for (std::uint32_t out = states[state].literal != none ? state
+                                                                   : states[state].dictionary;
+                 out != none; out = states[out].dictionary) {
+                on_match(states[out].literal, i + 1);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of states of the automaton.
+     */
+    size_t stateCount() const { return states.size(); }
+
+    /**
+     * @brief Returns the flat tables, e.g. to serialize them.
+     */
+    const std::array<std::uint32_t, 256>& rootTable() const { return root; }
+    const std::vector<FlatState>& stateTable() const { return states; }
+    const std::vector<FlatEdge>& edgeTable() const { return edges; }
+
+    /**
+     * @brief Returns the number of bytes held by the automaton.
+     */
+    size_t spaceUsed() const {
+        return sizeof(root) + states.capacity() * sizeof(FlatState) +
+               edges.capacity() * sizeof(FlatEdge);
+    }
+
+   private:
+    // A state while the trie is being built.
+    struct State {
+        FlatState flat;
+        std::vector<std::pair<unsigned char, std::uint32_t>> edges;  // Unused for the root.
+    };
+
+    std::array<std::uint32_t, 256> root{};
+    std::vector<FlatState> states;
+    std::vector<FlatEdge> edges;
+
+    AhoCorasick() { root.fill(none); }
+
+    /**
+     * @brief [private] Returns the child of a flat state for a byte, or `none`.
+     */
+    static std::uint32_t flatChild(const std::uint32_t* root, const FlatState* states,
+                                   const FlatEdge* edges, std::uint32_t state, unsigned char c) {
+        if (state == 0) {
+            return root[c];
+        }
+        const FlatEdge* edge = edges + states[state].edge_begin;
+        for (const FlatEdge* end = edge + states[state].edge_count; edge != end; ++edge) {
+            if (edge->byte >= c) {
+                return edge->byte == c ? edge->target : none;
+            }
+        }
+        return none;
+    }
+
+    /**
+     * @brief [private] Returns the child of a trie state for a byte while building, or `none`.
+     */
+    std::uint32_t child(const std::vector<State>& trie, std::uint32_t state,
+                        unsigned char c) const {
+        if (state == 0) {
+            return root[c];
+        }
+        for (const auto& edge : trie[state].edges) {
+            if (edge.first >= c) {
+                return edge.first == c ? edge.second : none;
+            }
+        }
+        return none;
+    }
+
+    /**
+     * @brief [private] Adds an edge while building, keeping the edge list sorted.
+     */
+    void addEdge(std::vector<State>& trie, std::uint32_t state, unsigned char c,
+                 std::uint32_t next) {
+        if (state == 0) {
+            root[c] = next;
+            return;
+        }
+        auto& state_edges = trie[state].edges;
+        auto it = state_edges.begin();
+        while (it != state_edges.end() && it->first < c) {
+            ++it;
+        }
+        state_edges.insert(it, {c, next});
+    }
+};
\ No newline at end of file
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "multi/pattern_set.hpp"
+#include "utils/parser.hpp"
+#include "utils/simd.hpp"
+
+/**
+ * @brief Matches one text against a small group of patterns with a single bit-parallel NFA.
+ *
+ * Every pattern is laid out as a run of consecutive bits in one wide state vector: a start bit,
+ * followed by one bit per fixed-width character ('?', a character class or a literal byte). A '*'
+ * turns the bit before it into a self-loop. For each text byte all patterns advance at once
+ * (Shift-And):
+ *
+ *     D' = ((D << 1) & accepts[c]) | (D & loops)
+ *
+ * where `accepts[c]` holds the bits that may be entered on byte `c` and never contains a start
+ * bit, so the shift cannot carry one pattern's state into the next. A pattern matches when its
+ * last bit is set after the final byte. The throughput is one vector step per text byte no matter
+ * how many patterns of the group match, which makes this a good fit for groups of up to a few
+ * hundred short patterns; large groups are better served by a prefiltering PatternSet.
+ *
+ * The state vector is processed 128 bits at a time with SSE2 when available and 64 bits at a time
+ * otherwise. Pattern IDs are the indices in the vector passed to compile(). Patterns that cannot
+ * be laid out as one run of bits are rejected, see supports().
+ */
+class BitParallelSet {
+   public:
+    /**
+     * @brief Compiles a group of raw pattern strings.
+     * @param patterns The pattern strings, which must already have passed validation.
+     * @return The compiled NFA.
+     */
+    static BitParallelSet compile(const std::vector<std::string>& patterns) {
+        std::vector<std::vector<Token>> token_lists;
+        token_lists.reserve(patterns.size());
+        for (const auto& pattern : patterns) {
+            token_lists.push_back(Parser::parse(pattern).tokens);
+        }
+        // Patterns parsed without dialect options are always supported
+        return *compile(token_lists);
+    }
+
+    /**
+     * @brief Compiles a group of tokenized patterns.
+     * @param token_lists One token vector per pattern.
+     * @return The compiled NFA, or std::nullopt if any pattern is not supported.
+     */
+    static std::optional<BitParallelSet> compile(
+        const std::vector<std::vector<Token>>& token_lists) {
+        if (!std::all_of(token_lists.begin(), token_lists.end(), supports)) {
+            return std::nullopt;
+        }
+
+        BitParallelSet set;
+        set.pattern_count = token_lists.size();
+
+        // 1. Lay out the bits of every pattern: a start bit plus one bit per fixed-width character
+        std::size_t bit_count = 0;
+        for (const auto& tokens : token_lists) {
+            bit_count += 1 + fixedWidth(tokens);
+        }
+        set.word_count = (bit_count + 127) / 128 * 2;  // Whole 128-bit blocks for the SIMD path
+        set.initial.assign(set.word_count, 0);
+        set.loops.assign(set.word_count, 0);
+        set.finals.assign(set.word_count, 0);
+        set.accepts.assign(256 * set.word_count, 0);
+        set.final_owner.assign(bit_count, 0);
+
+        // 2. Fill in the start, self-loop, transition and final masks
+        std::size_t bit = 0;
+        for (std::size_t id = 0; id < token_lists.size(); ++id) {
+            setBit(set.initial, bit);
+            for (const auto& token : token_lists[id]) {
+                switch (token.type) {
+                    case TokenType::ANY_SEQUENCE:
+                        setBit(set.loops, bit);
+                        break;
+                    case TokenType::ANY_CHAR:
+                        ++bit;
+                        for (std::size_t c = 0; c < 256; ++c) {
+                            setBit(set.accepts, c * set.word_count * 64 + bit);
+                        }
+                        break;
+                    case TokenType::CHAR_CLASS:
+                        ++bit;
+                        for (std::size_t c = 0; c < 256; ++c) {
+                            if (token.char_class.contains(static_cast<unsigned char>(c))) {
+                                setBit(set.accepts, c * set.word_count * 64 + bit);
+                            }
+                        }
+                        break;
+                    case TokenType::LITERAL_SEQUENCE:
+                        for (char c : *token.value) {
+                            ++bit;
+                            const std::size_t row = set.word_count * 64;
+                            setBit(set.accepts, static_cast<unsigned char>(c) * row + bit);
+                            if (token.fold_case && c >= 'a' && c <= 'z') {
+                                setBit(set.accepts, static_cast<std::size_t>(c - 'a' + 'A') * row +
+                                                        bit);
+                            }
+                        }
+                        break;
+                    case TokenType::ALTERNATION:  // Rejected by supports()
+                    case TokenType::SEGMENT_SEQUENCE:
+                    case TokenType::ANY_SEGMENTS:
+                        break;
+                }
+            }
+            setBit(set.finals, bit);
+            set.final_owner[bit] = static_cast<std::uint32_t>(id);
+            ++bit;
+        }
+        return set;
+    }
+
+    /**
+     * @brief Checks whether a pattern can be laid out as one run of bits.
+     * @param p_tokens The tokenized pattern vector.
+     * @return false if the pattern has an ALTERNATION, whose alternatives need more than one run,
+     * or a path wildcard, whose self-loop would have to exclude '/'.
+     */
+    static bool supports(const std::vector<Token>& p_tokens) {
+        return std::none_of(p_tokens.begin(), p_tokens.end(), [](const Token& token) {
+            return token.type == TokenType::ALTERNATION ||
+                   token.type == TokenType::SEGMENT_SEQUENCE ||
+                   token.type == TokenType::ANY_SEGMENTS;
+        });
+    }
+
+    /**
+     * @brief Returns the patterns matching a text.
+     * @param s The text string view to match.
+     * @param mode FIRST or ANY to report only the lowest matching ID, ALL to report every match.
+     * @return A bitset with one bit per pattern ID.
+     */
+    MatchBitset match(std::string_view s, MatchMode mode = MatchMode::ALL) const {
+        MatchBitset matches(pattern_count);
+        std::vector<std::uint64_t> state = initial;
+        std::vector<std::uint64_t> next(word_count);
+
+        for (char c : s) {
+            if (!step(state.data(), next.data(), static_cast<unsigned char>(c))) {
+                return matches;  // Every pattern has died, none can match any more
+            }
+            state.swap(next);
+        }
+
+        // Final bits are visited in ascending bit order, which is ascending pattern ID order
+        for (std::size_t w = 0; w < word_count; ++w) {
+            for (std::uint64_t word = state[w] & finals[w]; word != 0; word &= word - 1) {
+                matches.set(final_owner[w * 64 + static_cast<std::size_t>(std::countr_zero(word))]);
+                if (mode != MatchMode::ALL) {
+                    return matches;
+                }
+            }
+        }
+        return matches;
+    }
+
+    /**
+     * @brief Returns the IDs of all patterns matching a text, in ascending order.
+     */
+    std::vector<std::size_t> matchAll(std::string_view s) const { return match(s).ids(); }
+
+    /**
+     * @brief Returns the lowest ID of a pattern matching a text, or std::nullopt.
+     */
+    std::optional<std::size_t> matchFirst(std::string_view s) const {
+        const std::vector<std::size_t> ids = match(s, MatchMode::FIRST).ids();
+        return ids.empty() ? std::nullopt : std::optional<std::size_t>(ids.front());
+    }
+
+    /**
+     * @brief Returns the number of patterns in the group.
+     */
+    std::size_t size() const { return pattern_count; }
+
+    /**
+     * @brief Returns the width of the state vector in bits, rounded up to whole 128-bit blocks.
+     */
+    std::size_t stateBits() const { return word_count * 64; }
+
+    /**
+     * @brief Returns the number of bytes held by the NFA (masks and the final-bit owner table).
+     */
+    std::size_t spaceUsed() const {
+        return (initial.capacity() + loops.capacity() + finals.capacity() + accepts.capacity()) *
+                   sizeof(std::uint64_t) +
+               final_owner.capacity() * sizeof(std::uint32_t);
+    }
+
+   private:
+    std::size_t pattern_count = 0;
+    std::size_t word_count = 0;              // Always even, see compile().
+    std::vector<std::uint64_t> initial;      // The start bit of every pattern.
+    std::vector<std::uint64_t> loops;        // Bits followed by a '*'.
+    std::vector<std::uint64_t> finals;       // The last bit of every pattern.
+    std::vector<std::uint64_t> accepts;      // 256 masks of word_count words, one per byte.
+    std::vector<std::uint32_t> final_owner;  // Pattern ID of each final bit.
+
+    BitParallelSet() = default;
+
+    /**
+     * @brief [private] Returns the number of characters a pattern consumes outside of '*'.
+     */
+    static std::size_t fixedWidth(const std::vector<Token>& p_tokens) {
+        std::size_t width = 0;
+        for (const auto& token : p_tokens) {
+            if (token.type == TokenType::ANY_CHAR || token.type == TokenType::CHAR_CLASS) {
+                ++width;
+            } else if (token.type == TokenType::LITERAL_SEQUENCE) {
+                width += token.value->length();
+            }
+        }
+        return width;
+    }
+
+    /**
+     * @brief [private] Sets one bit of a word vector.
+     */
+    static void setBit(std::vector<std::uint64_t>& words, std::size_t bit) {
+        words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    }
+
+    /**
+     * @brief [private] Advances every pattern by one text byte.
+     * @return false if no state bit is left set.
+     */
+    bool step(const std::uint64_t* state, std::uint64_t* next, unsigned char c) const {
+        const std::uint64_t* accept = accepts.data() + c * word_count;
+
+#if defined(APP_SIMD_SSE2)
+        __m128i carry = _mm_setzero_si128();  // Top bit of the previous block, in the low lane
+        __m128i alive = _mm_setzero_si128();
+        for (std::size_t w = 0; w < word_count; w += 2) {
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + w));
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accept + w));
+            const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(loops.data() + w));
+
+            // Shift the 128-bit block left by one: each lane's top bit carries into the next lane
+            const __m128i tops = _mm_srli_epi64(d, 63);
+            const __m128i shifted =
+                _mm_or_si128(_mm_or_si128(_mm_slli_epi64(d, 1), _mm_slli_si128(tops, 8)), carry);
+            carry = _mm_srli_si128(tops, 8);
+
+            const __m128i result = _mm_or_si128(_mm_and_si128(shifted, a), _mm_and_si128(d, l));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(next + w), result);
+            alive = _mm_or_si128(alive, result);
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(alive, _mm_setzero_si128())) != 0xFFFF;
+#else
+        std::uint64_t carry = 0;
+        std::uint64_t alive = 0;
+        for (std::size_t w = 0; w < word_count; ++w) {
+            const std::uint64_t d = state[w];
+            next[w] = (((d << 1) | carry) & accept[w]) | (d & loops[w]);
+            carry = d >> 63;
+            alive |= next[w];
+        }
+        return alive != 0;
+#endif
+    }
+};
\ No newline at end of file
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "multi/pattern_set.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief A byte trie mapping literal keys to the pattern IDs stored at their end.
+ */
+class LiteralTrie {
+   public:
+    LiteralTrie() : nodes(1) {}
+
+    /**
+     * @brief Stores a pattern ID under a key.
+     * @param begin, end The key bytes, in the order in which walk() will visit them.
+     * @param id The pattern ID.
+     */
+    template <typename Iterator>
+    void insert(Iterator begin, Iterator end, size_t id) {
+        std::uint32_t node = 0;
+        for (Iterator it = begin; it != end; ++it) {
+            const auto c = static_cast<unsigned char>(*it);
+            std::uint32_t next = child(node, c);
+            if (next == none) {
+                next = static_cast<std::uint32_t>(nodes.size());
+                nodes.emplace_back();
+                auto& edges = nodes[node].edges;
+                auto pos = edges.begin();
+                while (pos != edges.end() && pos->first < c) {
+                    ++pos;
+                }
+                edges.insert(pos, {c, next});
+            }
+            node = next;
+        }
+        nodes[node].ids.push_back(id);
+    }
+
+    /**
+     * @brief Follows a text through the trie and reports the IDs of every key that is a prefix of
+     * it, including the empty key, in order of increasing key length.
+     * @param begin, end The text bytes.
+     * @param visit Called as `visit(id)` for every stored ID on the path.
+     */
+    template <typename Iterator, typename Visitor>
+    void walk(Iterator begin, Iterator end, Visitor&& visit) const {
+        std::uint32_t node = 0;
+        for (Iterator it = begin;; ++it) {
+            for (size_t id : nodes[node].ids) {
+                visit(id);
+            }
+            if (it == end) {
+                return;
+            }
+            node = child(node, static_cast<unsigned char>(*it));
+            if (node == none) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of bytes held by the trie.
+     */
+    size_t spaceUsed() const {
+        size_t space = nodes.capacity() * sizeof(Node);
+        for (const auto& node : nodes) {
+            space += node.edges.capacity() * sizeof(Edge) + node.ids.capacity() * sizeof(size_t);
+        }
+        return space;
+    }
+
+   private:
+    static constexpr std::uint32_t none = static_cast<std::uint32_t>(-1);
+    using Edge = std::pair<unsigned char, std::uint32_t>;
+
+    struct Node {
+        std::vector<Edge> edges;  // Sorted by byte.
+        std::vector<size_t> ids;  // Patterns whose key ends here.
+    };
+
+    std::vector<Node> nodes;
+
+    /**
+     * @brief [private] Returns the child of a node for a byte, or `none`.
+     */
+    std::uint32_t child(std::uint32_t node, unsigned char c) const {
+        for (const auto& edge : nodes[node].edges) {
+            if (edge.first >= c) {
+                return edge.first == c ? edge.second : none;
+            }
+        }
+        return none;
+    }
+};
+
+/**
+ * @brief The shape buckets of a BucketedPatternSet.
+ */
+enum class PatternShapeKind {
+    EXACT,   // Literals only, e.g. "index.html".
+    PREFIX,  // A literal followed by a trailing '*', e.g. "GET /api/*" (or a lone '*').
+    SUFFIX,  // A leading '*' followed by a literal, e.g. "*.log".
+    GENERAL  // Everything else.
+};
+
+/**
+ * @brief A multi-pattern matcher that dispatches the common simple shapes through lookup tables.
+ *
+ * At compile time every pattern is put into a bucket by its shape: exact literals go into a hash
+ * table, `prefix*` patterns into a trie that is walked over the start of the text, and `*suffix`
+ * patterns into a trie of reversed suffixes that is walked over the end of the text. Only the
+ * remaining general patterns are evaluated by a PatternSet. The cost of a lookup therefore depends
+ * on the text length and the number of matches, but hardly on the number of simple patterns.
+ */
+class BucketedPatternSet {
+   public:
+    /**
+     * @brief Compiles a set of raw pattern strings.
+     * @param patterns The pattern strings, which must already have passed validation.
+     * @return The compiled pattern set.
+     */
+    static BucketedPatternSet compile(const std::vector<std::string>& patterns) {
+        std::vector<std::vector<Token>> token_lists;
+        token_lists.reserve(patterns.size());
+        for (const auto& pattern : patterns) {
+            token_lists.push_back(Parser::parse(pattern).tokens);
+        }
+        return compile(token_lists);
+    }
+
+    /**
+     * @brief Compiles a set of tokenized patterns; pattern IDs are their indices.
+     * @param token_lists One token vector per pattern.
+     * @return The compiled pattern set.
+     */
+    static BucketedPatternSet compile(const std::vector<std::vector<Token>>& token_lists) {
+        BucketedPatternSet set;
+        set.pattern_count = token_lists.size();
+        std::vector<std::vector<Token>> general_tokens;
+
+        for (size_t id = 0; id < token_lists.size(); ++id) {
+            const auto& tokens = token_lists[id];
+            const std::string_view literal = literalOf(tokens);
+            const PatternShapeKind shape = classify(tokens);
+            switch (shape) {
+                case PatternShapeKind::EXACT:
+                    set.exact[std::string(literal)].push_back(id);
+                    break;
+                case PatternShapeKind::PREFIX:
+                    set.prefixes.insert(literal.begin(), literal.end(), id);
+                    break;
+                case PatternShapeKind::SUFFIX:
+                    set.suffixes.insert(literal.rbegin(), literal.rend(), id);
+                    break;
+                case PatternShapeKind::GENERAL:
+                    set.general_ids.push_back(id);
+                    general_tokens.push_back(tokens);
+                    break;
+            }
+            set.shapes.push_back(shape);
+        }
+
+        set.general = PatternSet::compile(general_tokens);
+        return set;
+    }
+
+    /**
+     * @brief Determines the bucket of a tokenized pattern.
+     * @param p_tokens The tokenized pattern vector.
+     * @return The PatternShapeKind of the pattern.
+     */
+    static PatternShapeKind classify(const std::vector<Token>& p_tokens) {
+        // Case-folded literals cannot be looked up in the byte-exact tries
+        const auto is = [&](size_t j, TokenType type) {
+            return j < p_tokens.size() && p_tokens[j].type == type && !p_tokens[j].fold_case;
+        };
+        switch (p_tokens.size()) {
+            case 0:
+                return PatternShapeKind::EXACT;
+            case 1:
+                return is(0, TokenType::LITERAL_SEQUENCE) ? PatternShapeKind::EXACT
+                       : is(0, TokenType::ANY_SEQUENCE)   ? PatternShapeKind::PREFIX
+                                                          : PatternShapeKind::GENERAL;
+            case 2:
+                if (is(0, TokenType::LITERAL_SEQUENCE) && is(1, TokenType::ANY_SEQUENCE)) {
+                    return PatternShapeKind::PREFIX;
+                }
+                if (is(0, TokenType::ANY_SEQUENCE) && is(1, TokenType::LITERAL_SEQUENCE)) {
+                    return PatternShapeKind::SUFFIX;
+                }
+                return PatternShapeKind::GENERAL;
+            default:
+                return PatternShapeKind::GENERAL;
+        }
+    }
+
+    /**
+     * @brief Returns the patterns matching a text.
+     * @param s The text string view to match.
+     * @param mode FIRST or ANY to report only the lowest matching ID, ALL to report every match.
+     * @return A bitset with one bit per pattern ID.
+     */
+    MatchBitset match(std::string_view s, MatchMode mode = MatchMode::ALL) const {
+        MatchBitset matches(pattern_count);
+        std::optional<size_t> first;
+        const auto report = [&](size_t id) {
+            if (mode == MatchMode::ALL) {
+                matches.set(id);
+            } else if (!first || id < *first) {
+                first = id;
+            }
+        };
+
+        // 1. Exact literals: one hash lookup
+        const auto it = exact.find(s);
+        if (it != exact.end()) {
+            for (size_t id : it->second) {
+                report(id);
+            }
+        }
+
+        // 2. Prefixes and suffixes: one trie walk from each end of the text
+        prefixes.walk(s.begin(), s.end(), report);
+        suffixes.walk(s.rbegin(), s.rend(), report);
+
+        // 3. Everything else through the multi-pattern engine
+        general.match(s, mode).forEach([&](size_t general_id) {
+            report(general_ids[general_id]);
+            return true;
+        });
+
+        if (first) {
+            matches.set(*first);
+        }
+        return matches;
+    }
+
+    /**
+     * @brief Returns the IDs of all patterns matching a text, in ascending order.
+     */
+    std::vector<size_t> matchAll(std::string_view s) const { return match(s).ids(); }
+
+    /**
+     * @brief Returns the lowest ID of a pattern matching a text, or std::nullopt.
+     */
+    std::optional<size_t> matchFirst(std::string_view s) const {
+        const std::vector<size_t> ids = match(s, MatchMode::FIRST).ids();
+        return ids.empty() ? std::nullopt : std::optional<size_t>(ids.front());
+    }
+
+    /**
+     * @brief Returns the bucket a pattern was placed in.
+     */
+    PatternShapeKind shapeOf(size_t id) const { return shapes[id]; }
+
+    /**
+     * @brief Returns the number of patterns in the set.
+     */
+    size_t size() const { return pattern_count; }
+
+    /**
+     * @brief Returns the number of bytes held by the set.
+     */
+    size_t spaceUsed() const {
+        size_t space = prefixes.spaceUsed() + suffixes.spaceUsed() + general.spaceUsed() +
+                       general_ids.capacity() * sizeof(size_t) + shapes.capacity();
+        for (const auto& [literal, ids] : exact) {
+            space += literal.capacity() + ids.capacity() * sizeof(size_t);
+        }
+        return space;
+    }
+
+   private:
+    // Lets the exact table be probed with a string_view without building a std::string.
+    struct LiteralHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view literal) const {
+            return std::hash<std::string_view>{}(literal);
+        }
+    };
+
+    size_t pattern_count = 0;
+    std::unordered_map<std::string, std::vector<size_t>, LiteralHash, std::equal_to<>> exact;
+    LiteralTrie prefixes;
+    LiteralTrie suffixes;  // Keys are stored reversed.
+    PatternSet general = PatternSet::compile(std::vector<std::vector<Token>>{});
+    std::vector<size_t> general_ids;  // Pattern ID of each pattern in `general`.
+    std::vector<PatternShapeKind> shapes;
+
+    BucketedPatternSet() = default;
+
+    /**
+     * @brief [private] Returns the literal of a simple pattern (empty if it has none).
+     */
+    static std::string_view literalOf(const std::vector<Token>& p_tokens) {
+        for (const auto& token : p_tokens) {
+            if (token.type == TokenType::LITERAL_SEQUENCE && token.value) {
+                return *token.value;
+            }
+        }
+        return {};
+    }
+};
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "multi/aho_corasick.hpp"
+#include "multi/literal_pool.hpp"
+#include "multi/pattern_set.hpp"
+#include "multi/redundancy.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief A memory-lean alternative to PatternSet for very large rule sets.
+ *
+ * All literals are interned into one LiteralPool, and every pattern is stored as a slice of one
+ * flat array of 12-byte PooledTokens, instead of a token vector with one std::string per literal
+ * plus a compiled program. Patterns with the same canonical form share their slice. Candidates
+ * are selected by the same Aho-Corasick prefilter as in PatternSet and verified directly on the
+ * pooled tokens with matchPooledTokens(). Pattern IDs are the indices in the vector passed to
+ * compile(). Patterns whose tokens cannot be pooled are rejected, see supports().
+ */
+class CompactPatternSet {
+   public:
+    /**
+     * @brief Compiles a set of raw pattern strings.
+     * @param patterns The pattern strings, which must already have passed validation.
+     * @return The compiled pattern set.
+     */
+    static CompactPatternSet compile(const std::vector<std::string>& patterns) {
+        std::vector<std::vector<Token>> token_lists;
+        token_lists.reserve(patterns.size());
+        for (const auto& pattern : patterns) {
+            token_lists.push_back(Parser::parse(pattern).tokens);
+        }
+        // Patterns parsed without dialect options are always supported
+        return *compile(token_lists);
+    }
+
+    /**
+     * @brief Compiles a set of tokenized patterns.
+     * @param token_lists One token vector per pattern.
+     * @return The compiled pattern set, or std::nullopt if any pattern is not supported.
+     */
+    static std::optional<CompactPatternSet> compile(
+        const std::vector<std::vector<Token>>& token_lists) {
+        if (!std::all_of(token_lists.begin(), token_lists.end(), supports)) {
+            return std::nullopt;
+        }
+
+        CompactPatternSet set;
+        LiteralPool pool;
+        std::vector<std::string> literals;
+        std::unordered_map<std::uint32_t, std::uint32_t> literal_of_offset;
+        std::unordered_map<std::string, TokenRange> range_of_key;
+
+        set.ranges.reserve(token_lists.size());
+        for (std::size_t id = 0; id < token_lists.size(); ++id) {
+            const std::vector<Token> canonical = RedundancyAnalyzer::canonicalize(token_lists[id]);
+            const auto [range, inserted_range] = range_of_key.emplace(
+                RedundancyAnalyzer::canonicalKey(canonical),
+                TokenRange{static_cast<std::uint32_t>(set.tokens.size()),
+                           static_cast<std::uint32_t>(canonical.size())});
+            if (inserted_range) {
+                for (const auto& token : canonical) {
+                    set.tokens.push_back(pool.intern(token));
+                }
+            }
+            set.ranges.push_back(range->second);
+
+            const PooledToken* required = nullptr;
+            for (std::uint32_t t = 0; t < range->second.count; ++t) {
+                const PooledToken& token = set.tokens[range->second.begin + t];
+                if (token.length > 0 && !token.fold_case &&
+                    (required == nullptr || token.length > required->length)) {
+                    required = &token;
+                }
+            }
+
+            // Interned literals are identified by their pool offset
+            if (required == nullptr) {
+                set.unfiltered.push_back(static_cast<std::uint32_t>(id));
+                continue;
+            }
+            const auto [it, inserted] = literal_of_offset.emplace(
+                required->offset, static_cast<std::uint32_t>(literals.size()));
+            if (inserted) {
+                literals.emplace_back(pool.view(*required));
+                set.literal_owners.emplace_back();
+            }
+            set.literal_owners[it->second].push_back(static_cast<std::uint32_t>(id));
+        }
+
+        set.automaton = AhoCorasick::build(literals);
+        set.pool = pool.release();
+        set.tokens.shrink_to_fit();
+        return set;
+    }
+
+    /**
+     * @brief Checks whether a pattern can be stored as pooled tokens.
+     * @param p_tokens The tokenized pattern vector.
+     * @return false if the pattern uses dialect tokens other than case folding: alternations,
+     * character classes and path wildcards; compile such sets into a PatternSet instead.
+     */
+    static bool supports(const std::vector<Token>& p_tokens) {
+        return std::all_of(p_tokens.begin(), p_tokens.end(), [](const Token& token) {
+            return token.type == TokenType::LITERAL_SEQUENCE ||
+                   token.type == TokenType::ANY_CHAR || token.type == TokenType::ANY_SEQUENCE;
+        });
+    }
+
+    /**
+     * @brief Returns the patterns matching a text.
+     * @param s The text string view to match.
+     * @param mode FIRST or ANY to stop at the lowest matching ID, ALL to report every match.
+     * @return A bitset with one bit per pattern ID.
+     */
+    MatchBitset match(std::string_view s, MatchMode mode = MatchMode::ALL) const {
+        MatchBitset candidates(size());
+        for (std::uint32_t id : unfiltered) {
+            candidates.set(id);
+        }
+        std::vector<bool> seen(literal_owners.size(), false);
+        automaton.scan(s, [&](std::uint32_t literal_id, std::size_t) {
+            if (!seen[literal_id]) {
+                seen[literal_id] = true;
+                for (std::uint32_t id : literal_owners[literal_id]) {
+                    candidates.set(id);
+                }
+            }
+        });
+
+        MatchBitset matches(size());
+        candidates.forEach([&](std::size_t id) {
+            if (matchPooledTokens(s, tokens.data() + ranges[id].begin, ranges[id].count,
+                                  pool.data())) {
+                matches.set(id);
+                return mode == MatchMode::ALL;
+            }
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief Returns the IDs of all patterns matching a text, in ascending order.
+     */
+    std::vector<std::size_t> matchAll(std::string_view s) const { return match(s).ids(); }
+
+    /**
+     * @brief Returns the lowest ID of a pattern matching a text, or std::nullopt.
+     */
+    std::optional<std::size_t> matchFirst(std::string_view s) const {
+        const std::vector<std::size_t> ids = match(s, MatchMode::FIRST).ids();
+        return ids.empty() ? std::nullopt : std::optional<std::size_t>(ids.front());
+    }
+
+    /**
+     * @brief Returns the number of patterns in the set.
+     */
+    std::size_t size() const { return ranges.size(); }
+
+    /**
+     * @brief Returns the number of bytes in the literal pool.
+     */
+    std::size_t poolBytes() const { return pool.size(); }
+
+    /**
+     * @brief Returns the number of bytes held by the set.
+     */
+    std::size_t spaceUsed() const {
+        std::size_t space = pool.capacity() + tokens.capacity() * sizeof(PooledToken) +
+                            ranges.capacity() * sizeof(TokenRange) +
+                            unfiltered.capacity() * sizeof(std::uint32_t) +
+                            automaton.spaceUsed();
+        for (const auto& owner_list : literal_owners) {
+            space += owner_list.capacity() * sizeof(std::uint32_t);
+        }
+        return space;
+    }
+
+   private:
+    friend class PatternDatabase;
+
+    struct TokenRange {
+        std::uint32_t begin;
+        std::uint32_t count;
+    };
+
+    std::string pool;                                        // Interned literal bytes.
+    std::vector<PooledToken> tokens;                         // All distinct patterns, back to back.
+    std::vector<TokenRange> ranges;                          // Token range of each pattern.
+    AhoCorasick automaton = AhoCorasick::build({});          // Over the required literals.
+    std::vector<std::vector<std::uint32_t>> literal_owners;  // Pattern IDs per literal ID.
+    std::vector<std::uint32_t> unfiltered;                   // Patterns without any literal.
+
+    CompactPatternSet() = default;
+};
\ No newline at end of file
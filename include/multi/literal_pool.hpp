@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "utils/parser.hpp"
+#include "utils/simd.hpp"
+
+/**
+ * @brief A token whose literal lives in a LiteralPool instead of its own std::string.
+ */
+struct PooledToken {
+    TokenType type;
+    bool fold_case = false;      // The literal is in lower case and letters match either case.
+    std::uint16_t reserved = 0;  // Padding, kept zero so serialized tokens are deterministic.
+    std::uint32_t offset = 0;    // Start of the literal in the pool (LITERAL_SEQUENCE only).
+    std::uint32_t length = 0;    // Length of the literal (LITERAL_SEQUENCE only).
+};
+
+/**
+ * @brief Interns literal byte sequences into one contiguous, deduplicated buffer.
+ *
+ * Large rule sets repeat the same fragments (`/api/`, `.json`, host names) many times. Interning
+ * stores each distinct fragment once, so tokens shrink to an offset and a length, and the literals
+ * compared during matching sit next to each other in memory.
+ */
+class LiteralPool {
+   public:
+    /**
+     * @brief Adds a literal to the pool unless an identical one is already there.
+     * @param literal The literal bytes.
+     * @return The offset of the literal in the pool.
+     */
+    std::uint32_t intern(std::string_view literal) {
+        const auto it = offsets.find(literal);
+        if (it != offsets.end()) {
+            return it->second;
+        }
+        const auto offset = static_cast<std::uint32_t>(pool.size());
+        pool.append(literal);
+        offsets.emplace(std::string(literal), offset);
+        return offset;
+    }
+
+    /**
+     * @brief Converts a token into a pooled token, interning its literal.
+     * @param token The token.
+     * @return The pooled token.
+     */
+    PooledToken intern(const Token& token) {
+        if (token.type != TokenType::LITERAL_SEQUENCE) {
+            return {token.type};
+        }
+        return {token.type, token.fold_case, 0, intern(*token.value),
+                static_cast<std::uint32_t>(token.value->size())};
+    }
+
+    /**
+     * @brief Returns the literal of a pooled token.
+     */
+    std::string_view view(const PooledToken& token) const {
+        return std::string_view(pool).substr(token.offset, token.length);
+    }
+
+    /**
+     * @brief Returns the pool bytes.
+     */
+    const std::string& bytes() const { return pool; }
+
+    /**
+     * @brief Hands over the pool bytes and forgets the interned literals.
+     */
+    std::string release() {
+        offsets.clear();
+        return std::move(pool);
+    }
+
+   private:
+    // Lets the offsets be probed with a string_view without building a std::string.
+    struct LiteralHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view literal) const {
+            return std::hash<std::string_view>{}(literal);
+        }
+    };
+
+    std::string pool;
+    // Interned literal -> pool offset.
+    std::unordered_map<std::string, std::uint32_t, LiteralHash, std::equal_to<>> offsets;
+};
+
+/**
+ * @brief Matches a text against a pattern made of pooled tokens.
+ *
+ * This is the greedy two-pointer algorithm on whole tokens: a '*' records a backtrack point, and on
+ * a mismatch the text position after the last '*' is advanced. When the token after that '*' is an
+ * exact literal, the restart jumps straight to the literal's next occurrence.
+ *
+ * @param s The text string view to match.
+ * @param tokens Pointer to the pooled tokens of the pattern.
+ * @param count The number of tokens.
+ * @param pool Pointer to the pool bytes the tokens refer to.
+ * @return true if the text matches the pattern, false otherwise.
+ */
+inline bool matchPooledTokens(std::string_view s, const PooledToken* tokens, std::size_t count,
+                              const char* pool) {
+    constexpr std::size_t none = static_cast<std::size_t>(-1);
+    const std::size_t m = s.length();
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t star_j = none;  // Index of the last '*' token seen
+    std::size_t star_i = 0;     // Text position the last '*' currently stops at
+
+    while (true) {
+        bool advanced = false;
+        if (j < count) {
+            const PooledToken& token = tokens[j];
+            switch (token.type) {
+                case TokenType::ANY_SEQUENCE:
+                    star_j = j++;
+                    star_i = i;
+                    continue;
+                case TokenType::ANY_CHAR:
+                    advanced = i < m;
+                    i += advanced ? 1 : 0;
+                    break;
+                case TokenType::LITERAL_SEQUENCE:
+                    advanced = m - i >= token.length &&
+                               (token.fold_case
+                                    ? foldedEquals(s.data() + i, pool + token.offset, token.length)
+                                    : std::memcmp(s.data() + i, pool + token.offset,
+                                                  token.length) == 0);
+                    i += advanced ? token.length : 0;
+                    break;
+                case TokenType::ALTERNATION:
+                case TokenType::CHAR_CLASS:
+                case TokenType::SEGMENT_SEQUENCE:
+                case TokenType::ANY_SEGMENTS:
+                    return false;  // Rejected by CompactPatternSet::supports()
+            }
+            if (advanced) {
+                ++j;
+                continue;
+            }
+        } else if (i == m || (star_j != none && star_j + 1 == count)) {
+            return true;  // All tokens consumed, and any leftover text goes to a trailing '*'
+        }
+
+        // Mismatch or leftover text: let the last '*' absorb one more character
+        if (star_j == none || star_i >= m) {
+            return false;
+        }
+        ++star_i;
+        if (star_j + 1 < count && tokens[star_j + 1].type == TokenType::LITERAL_SEQUENCE &&
+            !tokens[star_j + 1].fold_case) {
+            const PooledToken& next = tokens[star_j + 1];
+            const std::size_t found =
+                s.find(std::string_view(pool + next.offset, next.length), star_i);
+            if (found == std::string_view::npos) {
+                return false;
+            }
+            star_i = found;
+        }
+        i = star_i;
+        j = star_j + 1;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "multi/aho_corasick.hpp"
+#include "multi/compact_set.hpp"
+#include "multi/literal_pool.hpp"
+#include "multi/pattern_set.hpp"
+
+/**
+ * @brief Maps database files read-only on POSIX systems; every other target reads them into memory.
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#define APP_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief The fixed-size header at the start of every pattern database file.
+ *
+ * All offsets are in bytes from the start of the file and aligned to 8 bytes. The numbers are
+ * stored in the byte order of the writing machine; `byte_order` detects files from a machine of
+ * the other order, which are rejected.
+ */
+struct PatternDatabaseHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;  // Always 0x01020304 in the writer's byte order.
+    std::uint64_t file_size;
+    std::uint64_t checksum;  // FNV-1a over every byte after the header.
+
+    std::uint32_t pattern_count;
+    std::uint32_t token_count;
+    std::uint32_t pool_size;
+    std::uint32_t state_count;
+    std::uint32_t edge_count;
+    std::uint32_t literal_count;
+    std::uint32_t owner_count;
+    std::uint32_t unfiltered_count;
+
+    std::uint64_t pool_offset;        // char[pool_size]
+    std::uint64_t tokens_offset;      // PooledToken[token_count]
+    std::uint64_t ranges_offset;      // {begin, count} u32 pairs, one per pattern
+    std::uint64_t root_offset;        // u32[256]
+    std::uint64_t states_offset;      // AhoCorasick::FlatState[state_count]
+    std::uint64_t edges_offset;       // AhoCorasick::FlatEdge[edge_count]
+    std::uint64_t owner_begin_offset; // u32[literal_count + 1]
+    std::uint64_t owners_offset;      // u32[owner_count]
+    std::uint64_t unfiltered_offset;  // u32[unfiltered_count]
+};
+
+/**
+ * @brief A compiled CompactPatternSet stored in a versioned binary file that can be memory-mapped
+ * and matched against in place.
+ *
+ * The file holds the literal pool, the pooled tokens and the Aho-Corasick prefilter tables as flat
+ * arrays of fixed-size records, so opening it involves no parsing or compilation: the file is
+ * mapped read-only, the header is checked, and the tables are used where they lie. Any number of
+ * processes mapping the same file share its pages in the page cache. Opening checks the header and
+ * that every section lies inside the file in O(1), plus one checksum pass over the file that can be
+ * skipped for files from a trusted source. The records inside the sections are not validated
+ * individually, so a file must come from serialize() and be guarded against tampering like any
+ * other executable input.
+ */
+class PatternDatabase {
+   public:
+    static constexpr std::uint32_t format_version = 2;
+    static constexpr char magic[8] = {'W', 'C', 'M', 'D', 'B', '\0', '\0', '\0'};
+
+    PatternDatabase(const PatternDatabase&) = delete;
+    PatternDatabase& operator=(const PatternDatabase&) = delete;
+    PatternDatabase(PatternDatabase&& other) noexcept { *this = std::move(other); }
+    PatternDatabase& operator=(PatternDatabase&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data = std::exchange(other.data, nullptr);
+            mapped_size = std::exchange(other.mapped_size, 0);
+            owned = std::move(other.owned);  // Moving a vector keeps its buffer in place
+            tables = other.tables;
+        }
+        return *this;
+    }
+    ~PatternDatabase() { unmap(); }
+
+    /**
+     * @brief Serializes a compiled pattern set into the database format.
+     * @param set The compiled pattern set.
+     * @return The file contents.
+     */
+    static std::string serialize(const CompactPatternSet& set) {
+        PatternDatabaseHeader header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = format_version;
+        header.byte_order = byte_order_mark;
+
+        // Flatten the owner lists into one array indexed by literal
+        std::vector<std::uint32_t> owner_begin = {0};
+        std::vector<std::uint32_t> owners;
+        for (const auto& owner_list : set.literal_owners) {
+            owners.insert(owners.end(), owner_list.begin(), owner_list.end());
+            owner_begin.push_back(static_cast<std::uint32_t>(owners.size()));
+        }
+
+        const AhoCorasick& automaton = set.automaton;
+        header.pattern_count = static_cast<std::uint32_t>(set.ranges.size());
+        header.token_count = static_cast<std::uint32_t>(set.tokens.size());
+        header.pool_size = static_cast<std::uint32_t>(set.pool.size());
+        header.state_count = static_cast<std::uint32_t>(automaton.stateTable().size());
+        header.edge_count = static_cast<std::uint32_t>(automaton.edgeTable().size());
+        header.literal_count = static_cast<std::uint32_t>(set.literal_owners.size());
+        header.owner_count = static_cast<std::uint32_t>(owners.size());
+        header.unfiltered_count = static_cast<std::uint32_t>(set.unfiltered.size());
+
+        std::string out(sizeof(header), '\0');
+        header.pool_offset = append(out, set.pool.data(), set.pool.size());
+        header.tokens_offset = appendArray(out, set.tokens);
+        header.ranges_offset = appendArray(out, set.ranges);
+        header.root_offset = append(out, automaton.rootTable().data(), sizeof(std::uint32_t) * 256);
+        header.states_offset = appendArray(out, automaton.stateTable());
+        header.edges_offset = appendArray(out, automaton.edgeTable());
+        header.owner_begin_offset = appendArray(out, owner_begin);
+        header.owners_offset = appendArray(out, owners);
+        header.unfiltered_offset = appendArray(out, set.unfiltered);
+
+        header.file_size = out.size();
+        header.checksum = fnv1a(std::string_view(out).substr(sizeof(header)));
+        std::memcpy(out.data(), &header, sizeof(header));
+        return out;
+    }
+
+    /**
+     * @brief Serializes a compiled pattern set into a file.
+     * @param set The compiled pattern set.
+     * @param path The path of the file to write.
+     * @return true on success, false if the file could not be written.
+     */
+    static bool writeFile(const CompactPatternSet& set, const std::string& path) {
+        const std::string bytes = serialize(set);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(out);
+    }
+
+    /**
+     * @brief Opens a database file, memory-mapping it read-only where supported.
+     * @param path The path of the database file.
+     * @param verify_checksum Whether to verify the checksum of the whole file.
+     * @return The database, or std::nullopt if the file is missing, truncated, of another version
+     * or corrupted.
+     */
+    static std::optional<PatternDatabase> open(const std::string& path,
+                                               bool verify_checksum = true) {
+        PatternDatabase database;
+#if defined(APP_HAS_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        void* mapping =
+            ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // The mapping stays valid after the descriptor is closed
+        if (mapping == MAP_FAILED) {
+            return std::nullopt;
+        }
+        database.data = static_cast<const char*>(mapping);
+        database.mapped_size = static_cast<size_t>(info.st_size);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return std::nullopt;
+        }
+        database.owned.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        database.data = database.owned.data();
+#endif
+        const std::size_t length =
+            database.isMapped() ? database.mapped_size : database.owned.size();
+        if (!database.bind(length, verify_checksum)) {
+            return std::nullopt;
+        }
+        return database;
+    }
+
+    /**
+     * @brief Opens a database from an in-memory copy of its bytes.
+     * @param bytes The database contents; they are copied, so they need not outlive the result.
+     * @param verify_checksum Whether to verify the checksum of the whole buffer.
+     * @return The database, or std::nullopt if the contents are invalid.
+     */
+    static std::optional<PatternDatabase> fromBytes(std::string_view bytes,
+                                                    bool verify_checksum = true) {
+        PatternDatabase database;
+        database.owned.assign(bytes.begin(), bytes.end());
+        database.data = database.owned.data();
+        if (!database.bind(database.owned.size(), verify_checksum)) {
+            return std::nullopt;
+        }
+        return database;
+    }
+
+    /**
+     * @brief Returns the patterns matching a text.
+     * @param s The text string view to match.
+     * @param mode FIRST or ANY to stop at the lowest matching ID, ALL to report every match.
+     * @return A bitset with one bit per pattern ID.
+     */
+    MatchBitset match(std::string_view s, MatchMode mode = MatchMode::ALL) const {
+        MatchBitset candidates(size());
+        for (std::uint32_t i = 0; i < tables.unfiltered_count; ++i) {
+            candidates.set(tables.unfiltered[i]);
+        }
+        std::vector<bool> seen(tables.literal_count, false);
+        AhoCorasick::scanTables(tables.root, tables.states, tables.edges, s,
+                                [&](std::uint32_t literal_id, std::size_t) {
+                                    if (seen[literal_id]) {
+                                        return;
+                                    }
+                                    seen[literal_id] = true;
+                                    for (std::uint32_t i = tables.owner_begin[literal_id];
+                                         i < tables.owner_begin[literal_id + 1]; ++i) {
+                                        candidates.set(tables.owners[i]);
+                                    }
+                                });
+
+        MatchBitset matches(size());
+        candidates.forEach([&](std::size_t id) {
+            const std::uint32_t* range = tables.ranges + 2 * id;
+            if (matchPooledTokens(s, tables.tokens + range[0], range[1], tables.pool)) {
+                matches.set(id);
+                return mode == MatchMode::ALL;
+            }
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief Returns the IDs of all patterns matching a text, in ascending order.
+     */
+    std::vector<std::size_t> matchAll(std::string_view s) const { return match(s).ids(); }
+
+    /**
+     * @brief Returns the lowest ID of a pattern matching a text, or std::nullopt.
+     */
+    std::optional<std::size_t> matchFirst(std::string_view s) const {
+        const std::vector<std::size_t> ids = match(s, MatchMode::FIRST).ids();
+        return ids.empty() ? std::nullopt : std::optional<std::size_t>(ids.front());
+    }
+
+    /**
+     * @brief Returns the number of patterns in the database.
+     */
+    std::size_t size() const { return tables.pattern_count; }
+
+    /**
+     * @brief Returns true if the database is memory-mapped rather than held in a private buffer.
+     */
+    bool isMapped() const { return mapped_size != 0; }
+
+   private:
+    static constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+    static_assert(std::is_trivially_copyable_v<PooledToken> && sizeof(PooledToken) == 12);
+    static_assert(sizeof(AhoCorasick::FlatState) == 20 && sizeof(AhoCorasick::FlatEdge) == 8);
+
+    // Pointers into the mapped bytes, set up by bind().
+    struct Tables {
+        std::uint32_t pattern_count = 0;
+        std::uint32_t literal_count = 0;
+        std::uint32_t unfiltered_count = 0;
+        const char* pool = nullptr;
+        const PooledToken* tokens = nullptr;
+        const std::uint32_t* ranges = nullptr;
+        const std::uint32_t* root = nullptr;
+        const AhoCorasick::FlatState* states = nullptr;
+        const AhoCorasick::FlatEdge* edges = nullptr;
+        const std::uint32_t* owner_begin = nullptr;
+        const std::uint32_t* owners = nullptr;
+        const std::uint32_t* unfiltered = nullptr;
+    };
+
+    const char* data = nullptr;
+    std::size_t mapped_size = 0;  // Non-zero while `data` is an mmap region.
+    std::vector<char> owned;      // The bytes when they are not mapped.
+    Tables tables;
+
+    PatternDatabase() = default;
+
+    /**
+     * @brief [private] Validates the header and points the tables into the bytes.
+     */
+    bool bind(std::size_t length, bool verify_checksum) {
+        PatternDatabaseHeader header;
+        if (length < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+            header.version != format_version || header.byte_order != byte_order_mark ||
+            header.file_size != length) {
+            return false;
+        }
+        if (verify_checksum &&
+            fnv1a(std::string_view(data, length).substr(sizeof(header))) != header.checksum) {
+            return false;
+        }
+
+        // Every section must lie inside the file
+        const auto fits = [&](std::uint64_t offset, std::uint64_t count, std::uint64_t width) {
+            return offset % 8 == 0 && offset <= length && count <= (length - offset) / width;
+        };
+        if (!fits(header.pool_offset, header.pool_size, 1) ||
+            !fits(header.tokens_offset, header.token_count, sizeof(PooledToken)) ||
+            !fits(header.ranges_offset, header.pattern_count, 2 * sizeof(std::uint32_t)) ||
+            !fits(header.root_offset, 256, sizeof(std::uint32_t)) ||
+            !fits(header.states_offset, header.state_count, sizeof(AhoCorasick::FlatState)) ||
+            !fits(header.edges_offset, header.edge_count, sizeof(AhoCorasick::FlatEdge)) ||
+            !fits(header.owner_begin_offset, header.literal_count + 1ull, sizeof(std::uint32_t)) ||
+            !fits(header.owners_offset, header.owner_count, sizeof(std::uint32_t)) ||
+            !fits(header.unfiltered_offset, header.unfiltered_count, sizeof(std::uint32_t)) ||
+            header.state_count == 0) {
+            return false;
+        }
+
+        tables.pattern_count = header.pattern_count;
+        tables.literal_count = header.literal_count;
+        tables.unfiltered_count = header.unfiltered_count;
+        tables.pool = data + header.pool_offset;
+        tables.tokens = at<PooledToken>(header.tokens_offset);
+        tables.ranges = at<std::uint32_t>(header.ranges_offset);
+        tables.root = at<std::uint32_t>(header.root_offset);
+        tables.states = at<AhoCorasick::FlatState>(header.states_offset);
+        tables.edges = at<AhoCorasick::FlatEdge>(header.edges_offset);
+        tables.owner_begin = at<std::uint32_t>(header.owner_begin_offset);
+        tables.owners = at<std::uint32_t>(header.owners_offset);
+        tables.unfiltered = at<std::uint32_t>(header.unfiltered_offset);
+        return true;
+    }
+
+    /**
+     * @brief [private] Returns a typed pointer to a section of the bytes.
+     */
+    template <typename T>
+    const T* at(std::uint64_t offset) const {
+        return reinterpret_cast<const T*>(data + offset);
+    }
+
+    /**
+     * @brief [private] Releases the mapping, if any.
+     */
+    void unmap() {
+#if defined(APP_HAS_MMAP)
+        if (mapped_size != 0) {
+            ::munmap(const_cast<char*>(data), mapped_size);
+        }
+#endif
+        data = nullptr;
+        mapped_size = 0;
+    }
+
+    /**
+     * @brief [private] Appends raw bytes at the next 8-byte boundary and returns their offset.
+     */
+    static std::uint64_t append(std::string& out, const void* bytes, std::size_t length) {
+        out.resize((out.size() + 7) / 8 * 8, '\0');
+        const std::uint64_t offset = out.size();
+        out.append(static_cast<const char*>(bytes), length);
+        return offset;
+    }
+
+    /**
+     * @brief [private] Appends the elements of a vector of trivially copyable records.
+     */
+    template <typename T>
+    static std::uint64_t appendArray(std::string& out, const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return append(out, values.data(), values.size() * sizeof(T));
+    }
+
+    /**
+     * @brief [private] Computes the 64-bit FNV-1a hash of some bytes.
+     */
+    static std::uint64_t fnv1a(std::string_view bytes) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : bytes) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+};
\ No newline at end of file
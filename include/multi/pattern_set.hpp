@@ -0,0 +1,329 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "engine/bytecode.hpp"
+#include "multi/aho_corasick.hpp"
+#include "multi/redundancy.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief A compact set of pattern IDs, one bit per pattern.
+ */
+class MatchBitset {
+   public:
+    MatchBitset() = default;
+    explicit MatchBitset(size_t size) : bit_count(size), words((size + 63) / 64, 0) {}
+
+    void set(size_t id) { words[id / 64] |= std::uint64_t{1} << (id % 64); }
+    bool test(size_t id) const { return (words[id / 64] >> (id % 64)) & 1; }
+    size_t size() const { return bit_count; }
+
+    /**
+     * @brief Returns the number of IDs in the set.
+     */
+    size_t count() const {
+        size_t total = 0;
+        for (std::uint64_t word : words) {
+            total += static_cast<size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns the IDs in the set in ascending order.
+     */
+    std::vector<size_t> ids() const {
+        std::vector<size_t> result;
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (std::uint64_t word = words[w]; word != 0; word &= word - 1) {
+                result.push_back(w * 64 + static_cast<size_t>(std::countr_zero(word)));
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Calls `visit(id)` for every ID in ascending order until it returns false.
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (std::uint64_t word = words[w]; word != 0; word &= word - 1) {
+                if (!visit(w * 64 + static_cast<size_t>(std::countr_zero(word)))) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of bytes held by the bitset.
+     */
+    size_t spaceUsed() const { return words.capacity() * sizeof(std::uint64_t); }
+
+   private:
+    size_t bit_count = 0;
+    std::vector<std::uint64_t> words;
+};
+
+/**
+ * @brief Selects how many matching patterns PatternSet::match reports.
+ */
+enum class MatchMode {
+    FIRST,  // Stop at the matching pattern with the lowest ID.
+    ANY,    // Stop at any matching pattern; only answers whether some pattern matches.
+    ALL     // Report every matching pattern.
+};
+
+/**
+ * @brief Matches one text against many patterns at once.
+ *
+ * Every pattern is compiled into bytecode, and the longest literal of each pattern (a substring
+ * every matching text must contain) is entered into a shared Aho-Corasick automaton. A single scan
+ * of the text then yields the candidate patterns whose required literal occurs, and only those
+ * candidates, plus the few patterns without any literal, are verified by their bytecode. Pattern
+ * IDs are the indices in the vector passed to compile().
+ *
+ * Redundant patterns are removed at compile time. Patterns with the same canonical form (see
+ * RedundancyAnalyzer::canonicalize) share one program, whose match is reported for all of their
+ * IDs. Programs subsumed by another program are still verified for FIRST and ALL queries, but
+ * skipped by ANY queries, which only need one witness.
+ */
+class PatternSet {
+   public:
+    /**
+     * @brief Compiles a set of raw pattern strings.
+     * @param patterns The pattern strings, which must already have passed validation.
+     * @return The compiled pattern set.
+     */
+    static PatternSet compile(const std::vector<std::string>& patterns) {
+        std::vector<std::vector<Token>> token_lists;
+        token_lists.reserve(patterns.size());
+        for (const auto& pattern : patterns) {
+            token_lists.push_back(Parser::parse(pattern).tokens);
+        }
+        return compile(token_lists);
+    }
+
+    /**
+     * @brief Compiles a set of tokenized patterns.
+     * @param token_lists One token vector per pattern.
+     * @return The compiled pattern set.
+     */
+    static PatternSet compile(const std::vector<std::vector<Token>>& token_lists) {
+        PatternSet set;
+        set.pattern_count = token_lists.size();
+
+        // 1. Give every distinct canonical form one program, in order of first occurrence
+        std::vector<std::vector<Token>> canonical_forms;
+        std::unordered_map<std::string, size_t> program_of_key;
+        for (size_t id = 0; id < token_lists.size(); ++id) {
+            std::vector<Token> canonical = RedundancyAnalyzer::canonicalize(token_lists[id]);
+            const auto [it, inserted] = program_of_key.emplace(
+                RedundancyAnalyzer::canonicalKey(canonical), set.programs.size());
+            if (inserted) {
+                set.programs.push_back(BytecodeProgram::compile(canonical));
+                set.program_ids.emplace_back();
+                canonical_forms.push_back(std::move(canonical));
+            }
+            set.program_ids[it->second].push_back(id);
+        }
+
+        // 2. Enter the longest literal of every program into the prefilter. Case-folded literals
+        // cannot be found by the byte-exact automaton, so they are never required.
+        std::vector<std::string> literals;
+        std::unordered_map<std::string, size_t> literal_ids;
+        std::vector<std::vector<size_t>> owners;  // Programs requiring each distinct literal
+        for (size_t program = 0; program < canonical_forms.size(); ++program) {
+            const std::string* required = nullptr;
+            for (const auto& token : canonical_forms[program]) {
+                if (token.type == TokenType::LITERAL_SEQUENCE && token.value && !token.fold_case &&
+                    (required == nullptr || token.value->length() > required->length())) {
+                    required = &*token.value;
+                }
+            }
+            if (required == nullptr) {
+                set.unfiltered.push_back(program);  // Nothing to prefilter on: always verify
+                continue;
+            }
+
+            const auto [it, inserted] = literal_ids.emplace(*required, literals.size());
+            if (inserted) {
+                literals.push_back(*required);
+                owners.emplace_back();
+            }
+            owners[it->second].push_back(program);
+        }
+
+        set.literal_owners = std::move(owners);
+        set.automaton = AhoCorasick::build(literals);
+        set.markSubsumed(canonical_forms);
+        return set;
+    }
+
+    /**
+     * @brief Returns the patterns matching a text.
+     * @param s The text string view to match.
+     * @param mode FIRST to stop at the lowest matching ID, ANY to stop at any matching ID, ALL to
+     * report every match.
+     * @return A bitset with one bit per pattern ID.
+     */
+    MatchBitset match(std::string_view s, MatchMode mode = MatchMode::ALL) const {
+        const MatchBitset candidates = findCandidates(s);
+        MatchBitset matches(pattern_count);
+        candidates.forEach([&](size_t program) {
+            if (mode == MatchMode::ANY && subsumed[program]) {
+                return true;
+            }
+            if (!programs[program].match(s)) {
+                return true;
+            }
+            if (mode != MatchMode::ALL) {
+                // Programs are ordered by their lowest pattern ID
+                matches.set(program_ids[program].front());
+                return false;
+            }
+            for (size_t id : program_ids[program]) {
+                matches.set(id);
+            }
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief Returns the IDs of all patterns matching a text, in ascending order.
+     */
+    std::vector<size_t> matchAll(std::string_view s) const { return match(s).ids(); }
+
+    /**
+     * @brief Returns the lowest ID of a pattern matching a text, or std::nullopt.
+     */
+    std::optional<size_t> matchFirst(std::string_view s) const {
+        const std::vector<size_t> ids = match(s, MatchMode::FIRST).ids();
+        return ids.empty() ? std::nullopt : std::optional<size_t>(ids.front());
+    }
+
+    /**
+     * @brief Returns the ID of some pattern matching a text, or std::nullopt. Cheaper than
+     * matchFirst() since redundant patterns are skipped.
+     */
+    std::optional<size_t> matchAny(std::string_view s) const {
+        const std::vector<size_t> ids = match(s, MatchMode::ANY).ids();
+        return ids.empty() ? std::nullopt : std::optional<size_t>(ids.front());
+    }
+
+    /**
+     * @brief Returns the number of patterns in the set.
+     */
+    size_t size() const { return pattern_count; }
+
+    /**
+     * @brief Returns the number of distinct patterns after merging duplicates.
+     */
+    size_t programCount() const { return programs.size(); }
+
+    /**
+     * @brief Returns the number of programs an ANY query may verify, i.e. those not subsumed.
+     */
+    size_t liveCount() const {
+        size_t live = 0;
+        for (bool is_subsumed : subsumed) {
+            live += is_subsumed ? 0 : 1;
+        }
+        return live;
+    }
+
+    /**
+     * @brief Returns the number of bytes held by the set (programs, automaton and indices).
+     */
+    size_t spaceUsed() const {
+        size_t space = automaton.spaceUsed() + unfiltered.capacity() * sizeof(size_t) +
+                       programs.capacity() * sizeof(BytecodeProgram);
+        for (const auto& program : programs) {
+            space += program.spaceUsed();
+        }
+        for (const auto& owner_list : literal_owners) {
+            space += owner_list.capacity() * sizeof(size_t);
+        }
+        for (const auto& id_list : program_ids) {
+            space += id_list.capacity() * sizeof(size_t);
+        }
+        return space + subsumed.capacity() / 8;
+    }
+
+   private:
+    size_t pattern_count = 0;
+    std::vector<BytecodeProgram> programs;            // One per distinct canonical form.
+    std::vector<std::vector<size_t>> program_ids;     // Pattern IDs per program, ascending.
+    std::vector<bool> subsumed;                       // Programs covered by another program.
+    AhoCorasick automaton = AhoCorasick::build({});   // Over the distinct required literals.
+    std::vector<std::vector<size_t>> literal_owners;  // Programs per literal ID.
+    std::vector<size_t> unfiltered;                   // Programs without any literal.
+
+    PatternSet() = default;
+
+    /**
+     * @brief [private] Marks the programs subsumed by another program.
+     *
+     * A program can only be subsumed by a program whose required literal occurs inside one of its
+     * own literals, or by one without literals, so the candidates are found by running the literals
+     * through the prefilter automaton. Among programs matching the same texts the one with the
+     * lowest index survives.
+     */
+    void markSubsumed(const std::vector<std::vector<Token>>& canonical_forms) {
+        subsumed.assign(programs.size(), false);
+        for (size_t program = 0; program < programs.size(); ++program) {
+            const auto& specific = canonical_forms[program];
+            std::vector<size_t> candidates = unfiltered;
+            for (const auto& token : specific) {
+                if (token.type == TokenType::LITERAL_SEQUENCE) {
+                    automaton.scan(*token.value, [&](std::uint32_t literal_id, size_t) {
+                        const auto& owner_list = literal_owners[literal_id];
+                        candidates.insert(candidates.end(), owner_list.begin(), owner_list.end());
+                    });
+                }
+            }
+
+            for (size_t general : candidates) {
+                if (general != program &&
+                    RedundancyAnalyzer::subsumes(canonical_forms[general], specific) &&
+                    (general < program ||
+                     !RedundancyAnalyzer::subsumes(specific, canonical_forms[general]))) {
+                    subsumed[program] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief [private] Scans the text once and collects the programs that may match it.
+     */
+    MatchBitset findCandidates(std::string_view s) const {
+        MatchBitset candidates(programs.size());
+        for (size_t program : unfiltered) {
+            candidates.set(program);
+        }
+
+        // Each literal's owners only need to be marked on its first occurrence
+        std::vector<bool> seen(literal_owners.size(), false);
+        automaton.scan(s, [&](std::uint32_t literal_id, size_t) {
+            if (!seen[literal_id]) {
+                seen[literal_id] = true;
+                for (size_t program : literal_owners[literal_id]) {
+                    candidates.set(program);
+                }
+            }
+        });
+        return candidates;
+    }
+};
\ No newline at end of file
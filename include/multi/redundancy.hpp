@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "utils/parser.hpp"
+
+/**
+ * @brief Detects redundant patterns: duplicates that only differ in their spelling, and patterns
+ * whose matches are all matched by another pattern as well.
+ */
+class RedundancyAnalyzer {
+   public:
+    /**
+     * @brief Rewrites a token stream into its canonical form.
+     *
+     * Adjacent literals are merged, and every run of wildcards between two literals is rewritten
+     * as its '?' tokens followed by at most one '*'. Since a run of wildcards matches any text of
+     * at least as many characters as it has '?' (or exactly as many if it has no '*'), two patterns
+     * that differ only in the order and repetition of wildcards, such as `a*?*b` and `a?*b`, have
+     * the same canonical form.
+     *
+     * @param p_tokens The tokenized pattern vector.
+     * @return The canonical token vector.
+     */
+    static std::vector<Token> canonicalize(const std::vector<Token>& p_tokens) {
+        std::vector<Token> canonical;
+        size_t any_chars = 0;
+        bool star = false;
+        const auto flush_wildcards = [&]() {
+            canonical.insert(canonical.end(), any_chars, Token{TokenType::ANY_CHAR});
+            if (star) {
+                canonical.push_back({TokenType::ANY_SEQUENCE});
+            }
+            any_chars = 0;
+            star = false;
+        };
+
+        for (const auto& token : p_tokens) {
+            switch (token.type) {
+                case TokenType::ANY_CHAR:
+                    any_chars++;
+                    break;
+                case TokenType::ANY_SEQUENCE:
+                    star = true;
+                    break;
+                case TokenType::LITERAL_SEQUENCE:
+                    flush_wildcards();
+                    if (!canonical.empty() &&
+                        canonical.back().type == TokenType::LITERAL_SEQUENCE &&
+                        canonical.back().fold_case == token.fold_case) {
+                        *canonical.back().value += *token.value;
+                    } else {
+                        canonical.push_back(token);
+                    }
+                    break;
+                case TokenType::ALTERNATION:
+                case TokenType::CHAR_CLASS:
+                case TokenType::SEGMENT_SEQUENCE:
+                case TokenType::ANY_SEGMENTS:
+                    flush_wildcards();
+                    canonical.push_back(token);
+                    break;
+            }
+        }
+        flush_wildcards();
+        return canonical;
+    }
+
+    /**
+     * @brief Serializes a canonical token vector into a string usable as a hash key.
+     * @param canonical A token vector returned by canonicalize().
+     * @return A string that is equal for two canonical forms exactly if they are equal.
+     */
+    static std::string canonicalKey(const std::vector<Token>& canonical) {
+        std::string key;
+        for (const auto& token : canonical) {
+            switch (token.type) {
+                case TokenType::ANY_CHAR:
+                    key += '?';
+                    break;
+                case TokenType::ANY_SEQUENCE:
+                    key += '*';
+                    break;
+                case TokenType::LITERAL_SEQUENCE:
+                    // Length-prefixed, so literal bytes can never be confused with wildcards
+                    key += token.fold_case ? "i" : "";
+                    key += std::to_string(token.value->length()) + ':' + *token.value;
+                    break;
+                case TokenType::ALTERNATION:
+                    key += '{';
+                    for (const auto& alternative : token.alternatives) {
+                        key += canonicalKey(alternative) + ',';
+                    }
+                    key += '}';
+                    break;
+                case TokenType::CHAR_CLASS:
+                    // The fixed-size bitmap needs no length prefix
+                    key += '[';
+                    key.append(reinterpret_cast<const char*>(token.char_class.bits.data()),
+                               sizeof(token.char_class.bits));
+                    break;
+                case TokenType::SEGMENT_SEQUENCE:
+                    key += '%';
+                    break;
+                case TokenType::ANY_SEGMENTS:
+                    key += '/';
+                    break;
+            }
+        }
+        return key;
+    }
+
+    /**
+     * @brief Checks whether every text matched by one pattern is also matched by another.
+     *
+     * The specific pattern is read as a string over literal characters, wildcards and classes,
+     * and the general pattern is matched against it: a literal only matches the same literal
+     * character (in either case if the general one is case-folded), a '?' matches any
+     * single-character symbol, a class matches the literals and classes it includes, and a '*'
+     * matches any run of symbols. A successful match maps every text of the specific pattern onto
+     * a match of the general one, so a true result is always correct; a few subsumptions that only
+     * hold for non-structural reasons are missed.
+     *
+     * @param general The tokens of the potentially broader pattern.
+     * @param specific The tokens of the potentially narrower pattern.
+     * @return true if the general pattern matches every text the specific pattern matches.
+     */
+    static bool subsumes(const std::vector<Token>& general, const std::vector<Token>& specific) {
+        const std::vector<Symbol> g = symbols(general);
+        const std::vector<Symbol> s = symbols(specific);
+
+        // matched[i]: the general symbols seen so far match the first i specific symbols
+        std::vector<bool> matched(s.size() + 1, false);
+        matched[0] = true;
+        for (const Symbol& pattern_symbol : g) {
+            if (pattern_symbol.type == TokenType::ANY_SEQUENCE) {
+                for (size_t i = 1; i <= s.size(); ++i) {
+                    matched[i] = matched[i] || matched[i - 1];
+                }
+                continue;
+            }
+            for (size_t i = s.size(); i > 0; --i) {
+                matched[i] = matched[i - 1] && accepts(pattern_symbol, s[i - 1]);
+            }
+            matched[0] = false;
+        }
+        return matched[s.size()];
+    }
+
+   private:
+    struct Symbol {
+        TokenType type;  // LITERAL_SEQUENCE stands for the single character `c`.
+        char c;
+        const Token* token;   // The token of a CHAR_CLASS or ALTERNATION symbol.
+        bool folded = false;  // `c` is a lower-case letter that also matches its upper case.
+    };
+
+    /**
+     * @brief [private] Returns true if a general symbol matches every character a specific symbol
+     * stands for. Alternations and path wildcards are only ever absorbed by a '*'.
+     */
+    static bool accepts(const Symbol& general, const Symbol& specific) {
+        switch (general.type) {
+            case TokenType::ANY_CHAR:
+                return specific.type == TokenType::LITERAL_SEQUENCE ||
+                       specific.type == TokenType::ANY_CHAR ||
+                       specific.type == TokenType::CHAR_CLASS;
+            case TokenType::CHAR_CLASS:
+                if (specific.type == TokenType::CHAR_CLASS) {
+                    return general.token->char_class.includes(specific.token->char_class);
+                }
+                return specific.type == TokenType::LITERAL_SEQUENCE &&
+                       general.token->char_class.contains(static_cast<unsigned char>(specific.c)) &&
+                       (!specific.folded || general.token->char_class.contains(
+                                                static_cast<unsigned char>(specific.c - 0x20)));
+            case TokenType::LITERAL_SEQUENCE:
+                if (specific.type != TokenType::LITERAL_SEQUENCE) {
+                    return false;
+                }
+                if (general.folded) {
+                    return (specific.c >= 'A' && specific.c <= 'Z' ? specific.c + 0x20
+                                                                     : specific.c) == general.c;
+                }
+                return !specific.folded && specific.c == general.c;
+            case TokenType::ANY_SEQUENCE:
+            case TokenType::ALTERNATION:
+            case TokenType::SEGMENT_SEQUENCE:
+            case TokenType::ANY_SEGMENTS:
+                break;
+        }
+        return false;
+    }
+
+    /**
+     * @brief [private] Expands a token stream into one symbol per character or wildcard.
+     */
+    static std::vector<Symbol> symbols(const std::vector<Token>& p_tokens) {
+        std::vector<Symbol> result;
+        for (const auto& token : p_tokens) {
+            if (token.type == TokenType::LITERAL_SEQUENCE) {
+                for (char c : *token.value) {
+                    const bool folded = token.fold_case && c >= 'a' && c <= 'z';
+                    result.push_back({TokenType::LITERAL_SEQUENCE, c, nullptr, folded});
+                }
+            } else {
+                result.push_back({token.type, '\0', &token});
+            }
+        }
+        return result;
+    }
+};
\ No newline at end of file
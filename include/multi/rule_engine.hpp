@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "multi/pattern_set.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief Evaluates an ordered list of include and exclude rules in the style of `.gitignore` files
+ * and ACLs, where the last matching rule decides.
+ *
+ * A rule is a pattern, optionally prefixed with '!' to negate it. A pattern that starts with a
+ * literal '!' is written `\!`; RuleEngine drops that backslash itself, since '!' is not an escape
+ * the parser defines. A text is selected if the last rule matching it is a plain rule, and not
+ * selected if it is a negated rule or if no rule matches.
+ *
+ * The rules are compiled into a PatternSet in reverse order, so a FIRST query, which verifies the
+ * prefiltered candidates by ascending ID and stops at the first hit, visits the rules from last to
+ * first and stops at the decisive one. Rule lists without negations only need to know whether any
+ * rule matches, which additionally skips rules covered by broader ones.
+ */
+class RuleEngine {
+   public:
+    /**
+     * @brief Splits a rule into its negation flag and its pattern.
+     * @param rule The rule string.
+     * @return Whether the rule is negated, and the pattern without the leading '!' and without the
+     * backslash of a leading `\!`. This is the string to validate before compiling the rule.
+     */
+    static std::pair<bool, std::string_view> splitRule(std::string_view rule) {
+        const bool negated = !rule.empty() && rule.front() == '!';
+        if (negated) {
+            rule.remove_prefix(1);
+        }
+        if (rule.starts_with("\\!")) {
+            rule.remove_prefix(1);  // A literal '!', which the parser reads as a plain character
+        }
+        return {negated, rule};
+    }
+
+    /**
+     * @brief Compiles an ordered rule list.
+     * @param rules The rules, the patterns of which (see splitRule()) must already have passed
+     * validation.
+     * @param options The dialect every pattern is parsed with, e.g. ParseOptions::path for rules
+     * over file paths, where '*' stops at '/' and '**' spans directories.
+     * @return The compiled rule engine.
+     */
+    static RuleEngine compile(const std::vector<std::string>& rules,
+                              const ParseOptions& options = {}) {
+        RuleEngine engine;
+        std::vector<std::vector<Token>> token_lists;
+        token_lists.reserve(rules.size());
+        for (const auto& rule : rules) {
+            const auto [negated, pattern] = splitRule(rule);
+            engine.has_negations = engine.has_negations || negated;
+            engine.negated.push_back(negated);
+            token_lists.push_back(Parser::parse(pattern, options).tokens);
+        }
+        engine.set = PatternSet::compile(
+            std::vector<std::vector<Token>>(token_lists.rbegin(), token_lists.rend()));
+        return engine;
+    }
+
+    /**
+     * @brief Finds the last rule matching a text.
+     * @param s The text string view to match.
+     * @return The index of the last matching rule, or std::nullopt if no rule matches.
+     */
+    std::optional<size_t> lastMatch(std::string_view s) const {
+        const std::optional<size_t> reversed_id = set.matchFirst(s);
+        return reversed_id ? std::optional<size_t>(toRule(*reversed_id)) : std::nullopt;
+    }
+
+    /**
+     * @brief Decides whether a text is selected by the rule list.
+     * @param s The text string view to match.
+     * @return true if the last matching rule is not negated, false otherwise.
+     */
+    bool matches(std::string_view s) const {
+        if (!has_negations) {
+            return set.matchAny(s).has_value();
+        }
+        const std::optional<size_t> rule = lastMatch(s);
+        return rule && !negated[*rule];
+    }
+
+    /**
+     * @brief Returns true if a rule is negated.
+     */
+    bool isNegated(size_t rule) const { return negated[rule]; }
+
+    /**
+     * @brief Returns the number of rules.
+     */
+    size_t size() const { return negated.size(); }
+
+   private:
+    PatternSet set = PatternSet::compile(std::vector<std::vector<Token>>{});  // Rules, last first.
+    std::vector<bool> negated;  // Per rule, in the original order.
+    bool has_negations = false;
+
+    RuleEngine() = default;
+
+    /**
+     * @brief [private] Maps a pattern ID of the reversed set back to the rule index.
+     */
+    size_t toRule(size_t reversed_id) const { return negated.size() - 1 - reversed_id; }
+};
\ No newline at end of file
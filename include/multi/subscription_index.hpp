@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "engine/bytecode.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief A mutable index of wildcard subscriptions that can be matched against topics while
+ * subscriptions are being added and removed.
+ *
+ * Each subscription is filed under the literal prefix of its pattern (the literal before the first
+ * wildcard) in a byte trie. Matching walks the topic down the trie and only verifies the
+ * subscriptions filed on that path, so a topic never looks at subscriptions whose prefix it does
+ * not start with. Patterns that start with a wildcard have an empty prefix and form the small
+ * overflow list at the root, which every topic has to verify.
+ *
+ * Adding or removing a subscription touches a single trie path and compiles at most one pattern,
+ * so it costs O(prefix length + pattern length) regardless of the size of the index. All methods
+ * are thread-safe: matches run concurrently under a shared lock, and updates take the lock
+ * exclusively for the duration of one trie update.
+ */
+class SubscriptionIndex {
+   public:
+    using SubscriptionId = std::uint64_t;
+
+    /**
+     * @brief Adds a subscription.
+     * @param pattern A pattern that has already passed validation.
+     * @return The ID of the new subscription, unique for the lifetime of the index.
+     */
+    SubscriptionId add(std::string_view pattern) {
+        const std::vector<Token> tokens = Parser::parse(pattern).tokens;
+        std::string prefix;
+        if (!tokens.empty() && tokens.front().type == TokenType::LITERAL_SEQUENCE) {
+            prefix = *tokens.front().value;
+        }
+        Subscription subscription{0, BytecodeProgram::compile(tokens)};
+
+        std::unique_lock lock(mutex);
+        subscription.id = next_id++;
+        Node* node = &root;
+        for (char c : prefix) {
+            node = &node->childFor(static_cast<unsigned char>(c));
+        }
+        node->subscriptions.push_back(std::move(subscription));
+        prefixes.emplace(node->subscriptions.back().id, std::move(prefix));
+        return node->subscriptions.back().id;
+    }
+
+    /**
+     * @brief Removes a subscription.
+     * @param id The ID returned by add().
+     * @return true if the subscription was removed, false if the ID is unknown.
+     */
+    bool remove(SubscriptionId id) {
+        std::unique_lock lock(mutex);
+        const auto it = prefixes.find(id);
+        if (it == prefixes.end()) {
+            return false;
+        }
+
+        // Remember the path so that branches left empty can be pruned bottom-up
+        std::vector<Node*> path = {&root};
+        for (char c : it->second) {
+            path.push_back(path.back()->find(static_cast<unsigned char>(c)));
+        }
+        auto& subscriptions = path.back()->subscriptions;
+        const auto entry = std::find_if(subscriptions.begin(), subscriptions.end(),
+                                        [&](const Subscription& s) { return s.id == id; });
+        subscriptions.erase(entry);
+
+        for (std::size_t depth = it->second.length(); depth > 0 && path[depth]->isEmpty();
+             --depth) {
+            path[depth - 1]->erase(static_cast<unsigned char>(it->second[depth - 1]));
+        }
+        prefixes.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief Returns the subscriptions matching a topic.
+     * @param topic The topic string view to match.
+     * @return The matching subscription IDs in ascending order.
+     */
+    std::vector<SubscriptionId> match(std::string_view topic) const {
+        std::vector<SubscriptionId> ids;
+        std::shared_lock lock(mutex);
+        const Node* node = &root;
+        for (std::size_t i = 0;; ++i) {
+            for (const auto& subscription : node->subscriptions) {
+                if (subscription.program.match(topic)) {
+                    ids.push_back(subscription.id);
+                }
+            }
+            if (i == topic.length()) {
+                break;
+            }
+            node = node->find(static_cast<unsigned char>(topic[i]));
+            if (node == nullptr) {
+                break;
+            }
+        }
+        lock.unlock();
+
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    /**
+     * @brief Returns the number of subscriptions in the index.
+     */
+    std::size_t size() const {
+        std::shared_lock lock(mutex);
+        return prefixes.size();
+    }
+
+   private:
+    struct Subscription {
+        SubscriptionId id;
+        BytecodeProgram program;
+    };
+
+    struct Node {
+        using Edge = std::pair<unsigned char, std::unique_ptr<Node>>;
+
+        std::vector<Edge> children;               // Sorted by byte.
+        std::vector<Subscription> subscriptions;  // Subscriptions whose prefix ends here.
+
+        /**
+         * @brief Returns the child for a byte, or nullptr.
+         */
+        Node* find(unsigned char c) const {
+            const auto it = std::lower_bound(children.begin(), children.end(), c, byteLess);
+            return it != children.end() && it->first == c ? it->second.get() : nullptr;
+        }
+
+        /**
+         * @brief Returns the child for a byte, creating it if needed.
+         */
+        Node& childFor(unsigned char c) {
+            auto it = std::lower_bound(children.begin(), children.end(), c, byteLess);
+            if (it == children.end() || it->first != c) {
+                it = children.emplace(it, c, std::make_unique<Node>());
+            }
+            return *it->second;
+        }
+
+        /**
+         * @brief Removes the child for a byte.
+         */
+        void erase(unsigned char c) {
+            children.erase(std::lower_bound(children.begin(), children.end(), c, byteLess));
+        }
+
+        bool isEmpty() const { return children.empty() && subscriptions.empty(); }
+
+        static bool byteLess(const Edge& edge, unsigned char c) { return edge.first < c; }
+    };
+
+    mutable std::shared_mutex mutex;
+    Node root;
+    std::unordered_map<SubscriptionId, std::string> prefixes;  // Trie path of each subscription.
+    SubscriptionId next_id = 0;
+};
\ No newline at end of file
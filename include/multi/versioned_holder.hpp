@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Holds the current version of an immutable object, e.g. a compiled PatternSet, and lets it
+ * be replaced while other threads keep reading it (read-copy-update).
+ *
+ * A writer compiles the next version on its own thread and hands it to publish(), which swaps it in
+ * with a single atomic exchange. Readers never lock and never perform an atomic read-modify-write:
+ * each reading thread owns a Reader slot and, on entering a read section, merely announces the
+ * global epoch it observed with a plain store before loading the current pointer. Every publish
+ * retires the previous version under a new epoch, and a retired version is destroyed as soon as no
+ * announced epoch is older than its retirement, so a reload under load neither blocks readers nor
+ * frees an object one of them is still using.
+ *
+ * @tparam T The type of the held object.
+ */
+template <typename T>
+class VersionedHolder {
+   private:
+    static constexpr std::uint64_t idle = std::numeric_limits<std::uint64_t>::max();
+
+    struct Version {
+        std::unique_ptr<const T> value;
+        std::uint64_t number;
+    };
+
+    // One per Reader, on its own cache line so that announcing an epoch causes no false sharing.
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{idle};  // Epoch of the active read section, or idle.
+        bool in_use = true;                      // Guarded by the writer mutex.
+    };
+
+   public:
+    /**
+     * @brief A pinned view of one version, valid until the guard goes out of scope.
+     */
+    class ReadGuard {
+       public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard() { slot->epoch.store(idle, std::memory_order_release); }
+
+        const T& operator*() const { return *version->value; }
+        const T* operator->() const { return version->value.get(); }
+        const T* get() const { return version->value.get(); }
+
+        /**
+         * @brief Returns the number of the pinned version (1 for the initial one).
+         */
+        std::uint64_t versionNumber() const { return version->number; }
+
+       private:
+        friend class VersionedHolder;
+
+        ReadGuard(Slot* slot_in, const Version* version_in) : slot(slot_in), version(version_in) {}
+
+        Slot* slot;
+        const Version* version;
+    };
+
+    /**
+     * @brief A registered reading thread. Obtain one per thread with VersionedHolder::reader() and
+     * keep it for as long as the thread reads; registration is the only step that takes a lock.
+     */
+    class Reader {
+       public:
+        Reader(Reader&& other) noexcept
+            : holder(std::exchange(other.holder, nullptr)), slot(other.slot) {}
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+        ~Reader() {
+            if (holder != nullptr) {
+                holder->releaseSlot(slot);
+            }
+        }
+
+        /**
+         * @brief Enters a read section and pins the current version. Read sections of one Reader
+         * must not be nested.
+         * @return The guard giving access to the pinned version.
+         */
+        ReadGuard read() const {
+            // The announcement must be visible before the pointer is loaded, hence seq_cst
+            slot->epoch.store(holder->epoch.load(std::memory_order_seq_cst),
+                              std::memory_order_seq_cst);
+            return ReadGuard(slot, holder->current.load(std::memory_order_seq_cst));
+        }
+
+       private:
+        friend class VersionedHolder;
+
+        Reader(VersionedHolder* holder_in, Slot* slot_in) : holder(holder_in), slot(slot_in) {}
+
+        VersionedHolder* holder;
+        Slot* slot;
+    };
+
+    /**
+     * @brief Creates a holder with an initial version.
+     * @param initial The first version; must not be null.
+     */
+    explicit VersionedHolder(std::unique_ptr<const T> initial)
+        : current(new Version{std::move(initial), 1}) {}
+
+    VersionedHolder(const VersionedHolder&) = delete;
+    VersionedHolder& operator=(const VersionedHolder&) = delete;
+
+    /**
+     * @brief Destroys the holder. All Readers must have been destroyed before.
+     */
+    ~VersionedHolder() {
+        delete current.load(std::memory_order_relaxed);
+        for (const auto& entry : retired) {
+            delete entry.version;
+        }
+    }
+
+    /**
+     * @brief Registers a reading thread.
+     * @return The Reader of the calling thread.
+     */
+    Reader reader() {
+        std::lock_guard lock(mutex);
+        for (const auto& slot : slots) {
+            if (!slot->in_use) {
+                slot->in_use = true;
+                return Reader(this, slot.get());
+            }
+        }
+        slots.push_back(std::make_unique<Slot>());
+        return Reader(this, slots.back().get());
+    }
+
+    /**
+     * @brief Publishes a new version and reclaims the retired versions no reader holds anymore.
+     * @param next The new version; must not be null.
+     * @return The number of the new version.
+     */
+    std::uint64_t publish(std::unique_ptr<const T> next) {
+        std::lock_guard lock(mutex);
+        const std::uint64_t number = current.load(std::memory_order_relaxed)->number + 1;
+        Version* previous =
+            current.exchange(new Version{std::move(next), number}, std::memory_order_seq_cst);
+
+        // Readers announcing the new epoch are guaranteed to load the new pointer
+        const std::uint64_t retire_epoch = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        retired.push_back({previous, retire_epoch});
+        reclaimLocked();
+        return number;
+    }
+
+    /**
+     * @brief Destroys the retired versions no reader holds anymore.
+     * @return The number of versions destroyed.
+     */
+    std::size_t reclaim() {
+        std::lock_guard lock(mutex);
+        return reclaimLocked();
+    }
+
+    /**
+     * @brief Returns the number of the current version.
+     */
+    std::uint64_t version() const { return current.load(std::memory_order_acquire)->number; }
+
+    /**
+     * @brief Returns the number of retired versions still waiting for their readers.
+     */
+    std::size_t retiredCount() const {
+        std::lock_guard lock(mutex);
+        return retired.size();
+    }
+
+   private:
+    struct Retired {
+        Version* version;
+        std::uint64_t epoch;  // Readers announcing this epoch or a later one cannot hold it.
+    };
+
+    std::atomic<Version*> current;
+    std::atomic<std::uint64_t> epoch{0};
+    mutable std::mutex mutex;  // Serializes writers and reader registration, never taken by reads.
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<Retired> retired;
+
+    /**
+     * @brief [private] Returns a Reader's slot to the pool.
+     */
+    void releaseSlot(Slot* slot) {
+        std::lock_guard lock(mutex);
+        slot->epoch.store(idle, std::memory_order_relaxed);
+        slot->in_use = false;
+    }
+
+    /**
+     * @brief [private] Destroys every retired version older than all active read sections.
+     */
+    std::size_t reclaimLocked() {
+        std::uint64_t oldest = idle;
+        for (const auto& slot : slots) {
+            oldest = std::min(oldest, slot->epoch.load(std::memory_order_seq_cst));
+        }
+
+        std::size_t freed = 0;
+        for (std::size_t i = 0; i < retired.size();) {
+            if (retired[i].epoch <= oldest) {
+                delete retired[i].version;
+                retired[i] = retired.back();
+                retired.pop_back();
+                ++freed;
+            } else {
+                ++i;
+            }
+        }
+        return freed;
+    }
+};
\ No newline at end of file
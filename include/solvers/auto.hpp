@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <string_view>
+#include <vector>
+
+#include "engine/planner.hpp"
+#include "solvers/bytecode.hpp"
+#include "solvers/dp.hpp"
+#include "solvers/greedy.hpp"
+#include "solvers/jit.hpp"
+#include "solvers/memo.hpp"
+#include "solvers/nfa.hpp"
+#include "solvers/recursive.hpp"
+#include "utils/parser.hpp"
+#include "wildcard_matcher.hpp"
+
+/**
+ * @brief Implements the wildcard matching algorithm by delegating to the engine the Planner picks
+ * for the pattern shape and text length. The chosen engine is reported in SolverProfile::engine.
+ * Every call compiles the pattern afresh, so the Planner never picks the JIT here.
+ */
+class AutoSolver {
+   public:
+    /**
+     * @brief Runs and profiles the planned engine using a raw pattern string.
+     * @param s The text string view to match.
+     * @param p The pattern string view containing wildcards ('?', '*'), literals, and escape
+     * sequences.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s, std::string_view p) {
+        // Parse the raw pattern string into a sequence of tokens
+        auto tokens = Parser::parse(p).tokens;
+        return runAndProfile(s, tokens);
+    }
+
+    /**
+     * @brief Runs and profiles the planned engine using a pre-parsed token vector.
+     * @param s The text string view to match.
+     * @param p_tokens The tokenized pattern vector.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s, const std::vector<Token>& p_tokens) {
+        // Create an instance of the solver with the string and tokenized pattern
+        AutoSolver solver(s, p_tokens);
+        return solver.run();
+    }
+
+    /**
+     * @brief Runs a pattern on a specific engine.
+     * @param engine The engine to run.
+     * @param s The text string view to match.
+     * @param p_tokens The tokenized pattern vector.
+     * @return The SolverProfile of the engine, with SolverProfile::engine set to its name.
+     */
+    static SolverProfile runEngine(Engine engine, std::string_view s,
+                                   const std::vector<Token>& p_tokens) {
+        SolverProfile profile = dispatch(engine, s, p_tokens);
+        profile.engine = engineToString(engine);
+        return profile;
+    }
+
+   private:
+    // --- Member variables holding the context for a single run ---
+    const std::string_view s;
+    const std::vector<Token>& p_tokens;
+
+    /**
+     * @brief [private] Constructor to initialize the solver's context.
+     * @param s_in The text string view to match.
+     * @param p_tokens_in The vector of tokens representing the pattern.
+     */
+    AutoSolver(std::string_view s_in, const std::vector<Token>& p_tokens_in)
+        : s(s_in), p_tokens(p_tokens_in) {}
+
+    /**
+     * @brief [private] Calls runAndProfile of the solver implementing an engine.
+     */
+    static SolverProfile dispatch(Engine engine, std::string_view s,
+                                  const std::vector<Token>& p_tokens) {
+        switch (engine) {
+            case Engine::RECURSIVE:
+                return runSolver<RecursiveSolver>(s, p_tokens);
+            case Engine::MEMO:
+                return runSolver<MemoSolver>(s, p_tokens);
+            case Engine::DP:
+                return runSolver<DpSolver>(s, p_tokens);
+            case Engine::BYTECODE:
+                return runSolver<BytecodeSolver>(s, p_tokens);
+            case Engine::JIT:
+                return runSolver<JitSolver>(s, p_tokens);
+            case Engine::NFA:
+                return runSolver<NfaSolver>(s, p_tokens);
+            case Engine::GREEDY:
+                break;
+        }
+        return runSolver<GreedySolver>(s, p_tokens);
+    }
+
+    /**
+     * @brief [private] Runs the core logic and profiling for the instance.
+     * @return A SolverProfile struct.
+     */
+    SolverProfile run() const {
+        // 1. Start the timer, plan the engine and run it
+        auto start_time = std::chrono::high_resolution_clock::now();
+        const Engine engine = Planner::choose(p_tokens, s.length());
+        SolverProfile profile = runEngine(engine, s, p_tokens);
+
+        // 2. Stop the timer and calculate the duration, including the planning step
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        // 3. Calculate extra space overhead
+        // Planning needs only a PatternShape on top of what the chosen engine reports.
+        std::size_t space_used = profile.space_used_bytes + sizeof(PatternShape);
+
+        // 4. Return the struct containing the result, profiling data and the chosen engine
+        return {profile.result, duration.count(), space_used, profile.engine};
+    }
+};
\ No newline at end of file
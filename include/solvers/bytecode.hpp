@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <string_view>
+#include <vector>
+
+#include "engine/bytecode.hpp"
+#include "utils/parser.hpp"
+#include "wildcard_matcher.hpp"
+
+/**
+ * @brief Implements the wildcard matching algorithm by compiling the pattern into bytecode and
+ * running it on a direct-threaded interpreter.
+ */
+class BytecodeSolver {
+   public:
+    /**
+     * @brief Runs and profiles the bytecode interpreter using a raw pattern string.
+     * @param s The text string view to match.
+     * @param p The pattern string view containing wildcards ('?', '*'), literals, and escape
+     * sequences.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s, std::string_view p) {
+        // Parse the raw pattern string into a sequence of tokens
+        auto tokens = Parser::parse(p).tokens;
+        return runAndProfile(s, tokens);
+    }
+
+    /**
+     * @brief Runs and profiles the bytecode interpreter using a pre-parsed token vector.
+     * @param s The text string view to match.
+     * @param p_tokens The tokenized pattern vector.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s, const std::vector<Token>& p_tokens) {
+        // Create an instance of the solver with the string and tokenized pattern
+        BytecodeSolver solver(s, p_tokens);
+        return solver.run();
+    }
+
+   private:
+    // --- Member variables holding the context for a single run ---
+    const std::string_view s;
+    const std::vector<Token>& p_tokens;
+
+    /**
+     * @brief [private] Constructor to initialize the solver's context.
+     * @param s_in The text string view to match.
+     * @param p_tokens_in The vector of tokens representing the pattern.
+     */
+    BytecodeSolver(std::string_view s_in, const std::vector<Token>& p_tokens_in)
+        : s(s_in), p_tokens(p_tokens_in) {}
+
+    /**
+     * @brief [private] Runs the core logic and profiling for the instance.
+     * @return A SolverProfile struct.
+     */
+    SolverProfile run() const {
+        // 1. Start the timer, compile the pattern and execute the program
+        auto start_time = std::chrono::high_resolution_clock::now();
+        BytecodeProgram program = BytecodeProgram::compile(p_tokens);
+        bool result = program.match(s);
+
+        // 2. Stop the timer and calculate the duration
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        // 3. Calculate extra space overhead
+        // The interpreter itself runs in O(1) space; the program holds the compiled instructions.
+        std::size_t space_used = program.spaceUsed() + sizeof(size_t);
+
+        // 4. Return the struct containing the result and profiling data
+        return {result, duration.count(), space_used};
+    }
+};
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <string_view>
 #include <vector>
 
+#include "engine/engines.hpp"
+#include "solvers/nfa.hpp"
+#include "utils/masked_literal.hpp"
 #include "utils/parser.hpp"
 #include "wildcard_matcher.hpp"
 
@@ -32,6 +35,13 @@ class DpSolver {
      * @return A SolverProfile struct containing the match result, time elapsed, and space used.
      */
     static SolverProfile runAndProfile(std::string_view s, const std::vector<Token>& p_tokens) {
+        // Dialect tokens only run on the automaton
+        if (usesDialectTokens(p_tokens)) {
+            SolverProfile profile = NfaSolver::runAndProfile(s, p_tokens);
+            profile.engine = engineToString(Engine::NFA);
+            return profile;
+        }
+
         // Create an instance of the solver with the string and tokenized pattern
         DpSolver solver(s, p_tokens);
         return solver.run();
@@ -43,6 +53,8 @@ class DpSolver {
     const std::vector<Token>& p_tokens;
     const size_t m;
     const size_t n;
+    // Fixed-width runs of the pattern compiled into (bytes, mask) windows, indexed by token
+    const std::vector<MaskedLiteral> windows;
 
     /**
      * @brief [private] Constructor to initialize the solver's context.
@@ -50,7 +62,11 @@ class DpSolver {
      * @param p_tokens_in The vector of tokens representing the pattern.
      */
     DpSolver(std::string_view s_in, const std::vector<Token>& p_tokens_in)
-        : s(s_in), p_tokens(p_tokens_in), m(s_in.length()), n(p_tokens_in.size()) {}
+        : s(s_in),
+          p_tokens(p_tokens_in),
+          m(s_in.length()),
+          n(p_tokens_in.size()),
+          windows(MaskedLiteralCompiler::compile(p_tokens_in)) {}
 
     /**
      * @brief [private] Runs the core logic and profiling for the instance.
@@ -66,8 +82,10 @@ class DpSolver {
         auto duration =
             std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
-        // 3. Calculate extra space overhead from the (m+1)x(n+1) DP table
-        std::size_t space_used = (m + 1) * (n + 1) * sizeof(bool);
+        // 3. Calculate extra space overhead from the (m+1)x(n+1) DP table and the windows, which
+        // the first row of the table already needs in full
+        std::size_t space_used =
+            (m + 1) * (n + 1) * sizeof(bool) + MaskedLiteralCompiler::spaceUsed(windows);
 
         // 4. Return the struct containing the result and profiling data
         return {result, duration.count(), space_used};
@@ -107,25 +125,32 @@ class DpSolver {
                         break;
 
                     case TokenType::ANY_CHAR:
-                        // The '?' token matches any single character, so the result depends on the
-                        // subproblem without the current character and token
-                        dp[i][j] = dp[i - 1][j - 1];
-                        break;
-
                     case TokenType::LITERAL_SEQUENCE: {
-                        const std::string& literal = *current_token.value;
-                        const size_t literal_len = literal.length();
+                        // A run of '?' and literal tokens is resolved as a whole by its first
+                        // token, which writes the column of the run's last token. The columns of
+                        // the inner tokens are never read, so they are left untouched.
+                        const MaskedLiteral& window = windows[j - 1];
+                        if (window.token_count == 0) {
+                            break;
+                        }
+                        const size_t window_len = window.length();
+                        const size_t last_j = j - 1 + window.token_count;
                         // Check if the string has enough preceding characters and if the substring
-                        // ending at s[i-1] matches the literal
-                        if (i >= literal_len &&
-                            s.compare(i - literal_len, literal_len, literal) == 0) {
-                            // If they match, the result depends on the state before this literal
-                            // match
-                            dp[i][j] = dp[i - literal_len][j - 1];
+                        // ending at s[i-1] matches the window
+                        if (i >= window_len && window.matchesAt(s, i - window_len)) {
+                            // If they match, the result depends on the state before this run
+                            dp[i][last_j] = dp[i - window_len][j - 1];
                         }
-                        // else, dp[i][j] remains false
+                        // else, dp[i][last_j] remains false
                         break;
                     }
+
+                    case TokenType::ALTERNATION:
+                    case TokenType::CHAR_CLASS:
+                    case TokenType::SEGMENT_SEQUENCE:
+                    case TokenType::ANY_SEGMENTS:
+                        // Dialect patterns are routed in runAndProfile()
+                        break;
                 }
             }
         }
@@ -5,6 +5,9 @@
 #include <string_view>
 #include <vector>
 
+#include "engine/engines.hpp"
+#include "solvers/nfa.hpp"
+#include "utils/masked_literal.hpp"
 #include "utils/parser.hpp"
 #include "wildcard_matcher.hpp"
 
@@ -34,6 +37,13 @@ class GreedySolver {
      * @return A SolverProfile struct containing the match result, time elapsed, and space used.
      */
     static SolverProfile runAndProfile(std::string_view s, const std::vector<Token>& p_tokens) {
+        // Dialect tokens only run on the automaton
+        if (usesDialectTokens(p_tokens)) {
+            SolverProfile profile = NfaSolver::runAndProfile(s, p_tokens);
+            profile.engine = engineToString(Engine::NFA);
+            return profile;
+        }
+
         // Create an instance of the solver with the string and tokenized pattern
         GreedySolver solver(s, p_tokens);
         return solver.run();
@@ -53,6 +63,8 @@ class GreedySolver {
     const std::vector<Token>& p_tokens;
     const size_t m;
     const size_t n;
+    // Fixed-width runs of the pattern compiled into (bytes, mask) windows when first reached
+    mutable LazyMaskedLiterals windows;
 
     /**
      * @brief [private] Constructor to initialize the solver's context.
@@ -60,7 +72,11 @@ class GreedySolver {
      * @param p_tokens_in The vector of tokens representing the pattern.
      */
     GreedySolver(std::string_view s_in, const std::vector<Token>& p_tokens_in)
-        : s(s_in), p_tokens(p_tokens_in), m(s_in.length()), n(p_tokens_in.size()) {}
+        : s(s_in),
+          p_tokens(p_tokens_in),
+          m(s_in.length()),
+          n(p_tokens_in.size()),
+          windows(p_tokens_in) {}
 
     /**
      * @brief [private] Runs the core logic and profiling for the instance.
@@ -77,8 +93,10 @@ class GreedySolver {
             std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
         // 3. Calculate extra space overhead
-        // The extra space is from the two main indices and the optional backtrack state object.
-        std::size_t space_used = sizeof(size_t) * 2 + sizeof(std::optional<BacktrackPoint>);
+        // The extra space is from the two main indices, the optional backtrack state object and the
+        // masked literal windows compiled so far.
+        std::size_t space_used = sizeof(size_t) * 2 + sizeof(std::optional<BacktrackPoint>) +
+                                 windows.spaceUsed();
 
         // 4. Return the struct containing the result and profiling data
         return {result, duration.count(), space_used};
@@ -95,23 +113,16 @@ class GreedySolver {
         std::optional<BacktrackPoint> backtrack_point;
 
         while (s_idx < m) {
-            // Case 1: A direct match is found (ANY_CHAR or a matching LITERAL_SEQUENCE)
-            if (p_idx < n) {
-                const Token& token = p_tokens[p_idx];
-                if (token.type == TokenType::ANY_CHAR) {
-                    s_idx++;
-                    p_idx++;
+            // Case 1: A direct match is found for a run of ANY_CHAR and LITERAL_SEQUENCE tokens.
+            // The pointer only ever reaches a non-star token at the start of such a run, so the
+            // whole run is compared at once through its masked literal window.
+            if (p_idx < n && p_tokens[p_idx].type != TokenType::ANY_SEQUENCE) {
+                const MaskedLiteral& window = windows[p_idx];
+                if (m - s_idx >= window.length() && window.matchesAt(s, s_idx)) {
+                    s_idx += window.length();
+                    p_idx += window.token_count;
                     continue;
                 }
-                if (token.type == TokenType::LITERAL_SEQUENCE) {
-                    const std::string& literal = *token.value;
-                    const size_t literal_len = literal.length();
-                    if (m - s_idx >= literal_len && s.compare(s_idx, literal_len, literal) == 0) {
-                        s_idx += literal_len;
-                        p_idx++;
-                        continue;
-                    }
-                }
             }
 
             // Case 2: If a direct match fails, check for an ANY_SEQUENCE ('*') token
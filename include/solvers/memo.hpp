@@ -6,6 +6,9 @@
 #include <string_view>
 #include <vector>
 
+#include "engine/engines.hpp"
+#include "solvers/nfa.hpp"
+#include "utils/masked_literal.hpp"
 #include "utils/parser.hpp"
 #include "wildcard_matcher.hpp"
 
@@ -34,6 +37,13 @@ class MemoSolver {
      * @return A SolverProfile struct containing the match result, time elapsed, and space used.
      */
     static SolverProfile runAndProfile(std::string_view s, const std::vector<Token>& p_tokens) {
+        // Dialect tokens only run on the automaton
+        if (usesDialectTokens(p_tokens)) {
+            SolverProfile profile = NfaSolver::runAndProfile(s, p_tokens);
+            profile.engine = engineToString(Engine::NFA);
+            return profile;
+        }
+
         // Create an instance of the solver with the string and tokenized pattern.
         MemoSolver solver(s, p_tokens);
         return solver.run();
@@ -45,6 +55,8 @@ class MemoSolver {
     const std::vector<Token>& p_tokens;
     const size_t m;
     const size_t n;
+    // Fixed-width runs of the pattern compiled into (bytes, mask) windows when first reached
+    mutable LazyMaskedLiterals windows;
     mutable std::vector<std::vector<std::optional<bool>>> memo;
     mutable size_t max_depth;
 
@@ -58,6 +70,7 @@ class MemoSolver {
           p_tokens(p_tokens_in),
           m(s_in.length()),
           n(p_tokens_in.size()),
+          windows(p_tokens_in),
           memo(s_in.length() + 1,
                std::vector<std::optional<bool>>(p_tokens_in.size() + 1, std::nullopt)),
           max_depth(0) {}
@@ -86,7 +99,8 @@ class MemoSolver {
         // Each stack frame is estimated to contain: 2 size_t args + 1 return address
         std::size_t space_per_frame = sizeof(size_t) * 2 + sizeof(void*);
         std::size_t stack_space = max_depth * space_per_frame;
-        std::size_t total_space_used = memo_space + stack_space;
+        // 3.3 Add the masked literal windows compiled so far
+        std::size_t total_space_used = memo_space + stack_space + windows.spaceUsed();
 
         // 4. Return the struct containing the result and profiling data
         return {result, duration.count(), total_space_used};
@@ -130,25 +144,30 @@ class MemoSolver {
                     break;
 
                 case TokenType::ANY_CHAR:  // Corresponds to '?'
-                    // If the string is not exhausted, this token matches the current character
-                    ans = (i < m && isMatch(i + 1, j + 1, depth + 1));
-                    break;
-
                 case TokenType::LITERAL_SEQUENCE: {
-                    const std::string& literal = *current_token.value;
-                    const size_t literal_len = literal.length();
+                    // A run of '?' and literal tokens is always entered at its first token, so the
+                    // whole run is matched at once through its masked literal window
+                    const MaskedLiteral& window = windows[j];
+                    const size_t window_len = window.length();
 
-                    // Check if the string has enough characters remaining to match the literal
+                    // Check if the string has enough characters remaining to match the window
                     // and if the substring matches
-                    if (i + literal_len <= m && s.compare(i, literal_len, literal) == 0) {
-                        // If it matches, continue matching from the end of the literal sequence
-                        ans = isMatch(i + literal_len, j + 1, depth + 1);
+                    if (i + window_len <= m && window.matchesAt(s, i)) {
+                        // If it matches, continue matching from the end of the window
+                        ans = isMatch(i + window_len, j + window.token_count, depth + 1);
                     } else {
-                        // The literal does not match
+                        // The window does not match
                         ans = false;
                     }
                     break;
                 }
+
+                case TokenType::ALTERNATION:  // Dialect patterns are routed in runAndProfile()
+                case TokenType::CHAR_CLASS:
+                case TokenType::SEGMENT_SEQUENCE:
+                case TokenType::ANY_SEGMENTS:
+                    ans = false;
+                    break;
             }
         }
 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "engine/nfa.hpp"
+#include "engine/path.hpp"
+#include "utils/parser.hpp"
+#include "wildcard_matcher.hpp"
+
+/**
+ * @brief Implements the wildcard matching algorithm by compiling the pattern into a position
+ * automaton and simulating it bit-parallel. This is the only solver that runs dialect tokens.
+ * Path patterns that split at '/' are matched segment by segment with a PathMatcher instead.
+ */
+class NfaSolver {
+   public:
+    /**
+     * @brief Runs and profiles the automaton using a raw pattern string.
+     * @param s The text string view to match.
+     * @param p The pattern string view containing wildcards ('?', '*'), literals, and escape
+     * sequences.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s, std::string_view p) {
+        // Parse the raw pattern string into a sequence of tokens
+        auto tokens = Parser::parse(p).tokens;
+        return runAndProfile(s, tokens);
+    }
+
+    /**
+     * @brief Runs and profiles the automaton using a pre-parsed token vector.
+     * @param s The text string view to match.
+     * @param p_tokens The tokenized pattern vector.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s, const std::vector<Token>& p_tokens) {
+        // Create an instance of the solver with the string and tokenized pattern
+        NfaSolver solver(s, p_tokens);
+        return solver.run();
+    }
+
+   private:
+    // --- Member variables holding the context for a single run ---
+    const std::string_view s;
+    const std::vector<Token>& p_tokens;
+
+    /**
+     * @brief [private] Constructor to initialize the solver's context.
+     * @param s_in The text string view to match.
+     * @param p_tokens_in The vector of tokens representing the pattern.
+     */
+    NfaSolver(std::string_view s_in, const std::vector<Token>& p_tokens_in)
+        : s(s_in), p_tokens(p_tokens_in) {}
+
+    /**
+     * @brief [private] Runs the core logic and profiling for the instance.
+     * @return A SolverProfile struct.
+     */
+    SolverProfile run() const {
+        // 1. Start the timer, compile the pattern and simulate the automaton
+        auto start_time = std::chrono::high_resolution_clock::now();
+        if (const std::optional<PathMatcher> path = PathMatcher::compile(p_tokens)) {
+            return runPath(*path, start_time);
+        }
+        NfaMatcher matcher = NfaMatcher::compile(p_tokens);
+        bool result = matcher.match(s);
+
+        // 2. Stop the timer and calculate the duration
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        // 3. Calculate extra space overhead
+        // The automaton tables plus the current and next state sets.
+        const std::size_t state_words = (matcher.positionCount() + 63) / 64;
+        std::size_t space_used = matcher.spaceUsed() + 2 * state_words * sizeof(std::uint64_t);
+
+        // 4. Return the struct containing the result and profiling data
+        return {result, duration.count(), space_used};
+    }
+
+    /**
+     * @brief [private] Matches the text segment by segment and finishes the profile.
+     */
+    SolverProfile runPath(const PathMatcher& path,
+                          std::chrono::high_resolution_clock::time_point start_time) const {
+        const std::vector<std::string_view> text_segments = PathMatcher::splitSegments(s);
+        bool result = path.match(text_segments);
+
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        // The segment automata plus the segment boundaries of the text.
+        std::size_t space_used =
+            path.spaceUsed() + text_segments.capacity() * sizeof(std::string_view);
+        return {result, duration.count(), space_used};
+    }
+};
\ No newline at end of file
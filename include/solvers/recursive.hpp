@@ -5,6 +5,9 @@
 #include <string_view>
 #include <vector>
 
+#include "engine/engines.hpp"
+#include "solvers/nfa.hpp"
+#include "utils/masked_literal.hpp"
 #include "utils/parser.hpp"
 #include "wildcard_matcher.hpp"
 
@@ -33,6 +36,13 @@ class RecursiveSolver {
      * @return A SolverProfile struct containing the match result, time elapsed, and space used.
      */
     static SolverProfile runAndProfile(std::string_view s, const std::vector<Token>& p_tokens) {
+        // Dialect tokens only run on the automaton
+        if (usesDialectTokens(p_tokens)) {
+            SolverProfile profile = NfaSolver::runAndProfile(s, p_tokens);
+            profile.engine = engineToString(Engine::NFA);
+            return profile;
+        }
+
         // Create an instance of the solver with the string and tokenized pattern
         RecursiveSolver solver(s, p_tokens);
         return solver.run();
@@ -44,6 +54,8 @@ class RecursiveSolver {
     const std::vector<Token>& p_tokens;
     const size_t m;
     const size_t n;
+    // Fixed-width runs of the pattern compiled into (bytes, mask) windows when first reached
+    mutable LazyMaskedLiterals windows;
     mutable size_t max_depth;
 
     /**
@@ -52,7 +64,12 @@ class RecursiveSolver {
      * @param p_tokens_in The vector of tokens representing the pattern.
      */
     RecursiveSolver(std::string_view s_in, const std::vector<Token>& p_tokens_in)
-        : s(s_in), p_tokens(p_tokens_in), m(s_in.length()), n(p_tokens_in.size()), max_depth(0) {}
+        : s(s_in),
+          p_tokens(p_tokens_in),
+          m(s_in.length()),
+          n(p_tokens_in.size()),
+          windows(p_tokens_in),
+          max_depth(0) {}
 
     /**
      * @brief [private] Runs the core logic and profiling for the instance.
@@ -69,10 +86,11 @@ class RecursiveSolver {
             std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
         // 3. Calculate the actual extra space overhead
-        // Space overhead = max recursion depth * approximate size of each stack frame
+        // Space overhead = max recursion depth * approximate size of each stack frame, plus the
+        // masked literal windows compiled so far
         // Each stack frame is estimated to contain: 2 size_t args + 1 return address
         std::size_t space_per_frame = sizeof(size_t) * 2 + sizeof(void*);
-        std::size_t space_used = max_depth * space_per_frame;
+        std::size_t space_used = max_depth * space_per_frame + windows.spaceUsed();
 
         // 4. Return the struct containing the result and profiling data
         return {result, duration.count(), space_used};
@@ -109,22 +127,26 @@ class RecursiveSolver {
                 return isMatch(i, j + 1, depth + 1) || (i < m && isMatch(i + 1, j, depth + 1));
 
             case TokenType::ANY_CHAR:  // Corresponds to '?'
-                // If the string is not exhausted, this token matches the current character
-                return i < m && isMatch(i + 1, j + 1, depth + 1);
-
             case TokenType::LITERAL_SEQUENCE: {
-                // This token represents a sequence of one or more literal characters
-                const std::string& literal = *current_token.value;
-                const size_t literal_len = literal.length();
-
-                // Check if the remaining part of the string is long enough to contain this literal
-                // sequence and if the substring actually matches the literal
-                if (i + literal_len <= m && s.compare(i, literal_len, literal) == 0) {
-                    // If it matches, continue matching from the end of the literal sequence
-                    return isMatch(i + literal_len, j + 1, depth + 1);
+                // A run of '?' and literal tokens is always entered at its first token, so the
+                // whole run is matched at once through its masked literal window
+                const MaskedLiteral& window = windows[j];
+                const size_t window_len = window.length();
+
+                // Check if the remaining part of the string is long enough to contain this window
+                // and if the substring actually matches it
+                if (i + window_len <= m && window.matchesAt(s, i)) {
+                    // If it matches, continue matching from the end of the window
+                    return isMatch(i + window_len, j + window.token_count, depth + 1);
                 }
                 break;  // Mismatch if the check fails
             }
+
+            case TokenType::ALTERNATION:  // Dialect patterns are routed in runAndProfile()
+            case TokenType::CHAR_CLASS:
+            case TokenType::SEGMENT_SEQUENCE:
+            case TokenType::ANY_SEGMENTS:
+                break;
         }
 
         // If none of the above cases resulted in a match, it's a mismatch
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/parser.hpp"
+#include "utils/static_parser.hpp"
+#include "wildcard_matcher.hpp"
+
+/**
+ * @brief A matcher specialized at compile time for a single pattern, e.g. `StaticMatcher<"*.log">`.
+ *
+ * The pattern is parsed by StaticParser during compilation, so malformed escapes are compile
+ * errors. Every literal byte becomes an immediate comparison in a fully unrolled matching function,
+ * '?' tokens vanish into fixed offsets, and no memory is allocated at runtime. `match` is
+ * `constexpr`, so matches against constant texts can also be checked with `static_assert`.
+ *
+ * @tparam Pattern The pattern string literal.
+ */
+template <FixedString Pattern>
+class StaticMatcher {
+   public:
+    /**
+     * @brief Matches a text against the compiled-in pattern.
+     * @param s The text string view to match.
+     * @return true if the text matches the pattern, false otherwise.
+     */
+    static constexpr bool match(std::string_view s) {
+        if constexpr (!layout.has_star) {
+            return s.length() == layout.width[0] && segmentAt<0>(s, 0);
+        } else {
+            constexpr std::size_t last = layout.segment_count - 1;
+            if (s.length() < layout.min_length || !segmentAt<0>(s, 0)) {
+                return false;
+            }
+            std::size_t pos = layout.width[0];
+
+            // Locate every middle segment at its leftmost occurrence, in order
+            const bool middle_found = [&]<std::size_t... I>(std::index_sequence<I...>) {
+                return (((pos = findSegment<I + 1>(s, pos)) != std::string_view::npos) && ...);
+            }(std::make_index_sequence<last - 1>{});
+            if (!middle_found) {
+                return false;
+            }
+
+            // The last segment is anchored at the end of the text
+            const std::size_t tail_start = s.length() - layout.width[last];
+            return tail_start >= pos && segmentAt<last>(s, tail_start);
+        }
+    }
+
+    /**
+     * @brief Runs and profiles the specialized matcher.
+     *
+     * The token vector is accepted so that the matcher satisfies the WildcardSolver concept and can
+     * be used with runSolver, but it is ignored: the pattern is fixed by the template argument.
+     *
+     * @param s The text string view to match.
+     * @param p_tokens Ignored.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s,
+                                       [[maybe_unused]] const std::vector<Token>& p_tokens) {
+        return runAndProfile(s);
+    }
+
+    /**
+     * @brief Runs and profiles the specialized matcher.
+     * @param s The text string view to match.
+     * @return A SolverProfile struct containing the match result, time elapsed, and space used.
+     */
+    static SolverProfile runAndProfile(std::string_view s) {
+        // 1. Start the timer and execute the core matching logic
+        auto start_time = std::chrono::high_resolution_clock::now();
+        bool result = match(s);
+
+        // 2. Stop the timer and calculate the duration
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        // 3. Calculate extra space overhead: only the current position is kept at runtime
+        std::size_t space_used = sizeof(std::size_t);
+
+        // 4. Return the struct containing the result and profiling data
+        return {result, duration.count(), space_used};
+    }
+
+    /**
+     * @brief Returns the tokens of the compiled-in pattern in the runtime representation.
+     */
+    static std::vector<Token> tokens() { return parsed.toTokens(); }
+
+   private:
+    static constexpr auto parsed = StaticParser::parse<Pattern>();
+    static constexpr std::size_t capacity = Pattern.size() + 1;
+
+    /**
+     * @brief [private] The segments of the pattern between its '*' tokens, computed at compile
+     * time. Segment 0 precedes the first '*', the last segment follows the last '*'.
+     */
+    struct Layout {
+        bool has_star = false;
+        std::size_t segment_count = 1;
+        std::size_t min_length = 0;
+        std::array<std::size_t, capacity + 1> first{};     // Index of a segment's first token.
+        std::array<std::size_t, capacity + 1> count{};     // Number of tokens in a segment.
+        std::array<std::size_t, capacity + 1> width{};     // Characters matched by a segment.
+        std::array<std::size_t, capacity> token_offset{};  // Offset of a token in its segment.
+    };
+
+    static constexpr Layout layout = [] {
+        Layout result;
+        std::size_t segment = 0;
+        for (std::size_t j = 0; j < parsed.token_count; ++j) {
+            const StaticToken& token = parsed.tokens[j];
+            if (token.type == TokenType::ANY_SEQUENCE) {
+                result.has_star = true;
+                result.first[++segment] = j + 1;
+                continue;
+            }
+            result.token_offset[j] = result.width[segment];
+            result.width[segment] += token.type == TokenType::ANY_CHAR ? 1 : token.length;
+            result.count[segment]++;
+        }
+        result.segment_count = segment + 1;
+        for (std::size_t k = 0; k < result.segment_count; ++k) {
+            result.min_length += result.width[k];
+        }
+        return result;
+    }();
+
+    /**
+     * @brief [private] Compares token J against the text at `pos`, with every literal byte unrolled
+     * into its own comparison.
+     */
+    template <std::size_t J>
+    static constexpr bool tokenAt(std::string_view s, std::size_t pos) {
+        constexpr StaticToken token = parsed.tokens[J];
+        if constexpr (token.type == TokenType::ANY_CHAR) {
+            return true;
+        } else {
+            return [&]<std::size_t... K>(std::index_sequence<K...>) {
+                return ((s[pos + K] == parsed.literals[token.offset + K]) && ...);
+            }(std::make_index_sequence<token.length>{});
+        }
+    }
+
+    /**
+     * @brief [private] Checks whether segment S matches the text at `pos`. The text must contain at
+     * least `layout.width[S]` characters from `pos`.
+     */
+    template <std::size_t S>
+    static constexpr bool segmentAt(std::string_view s, std::size_t pos) {
+        constexpr std::size_t first = layout.first[S];
+        return [&]<std::size_t... T>(std::index_sequence<T...>) {
+            return (tokenAt<first + T>(s, pos + layout.token_offset[first + T]) && ...);
+        }(std::make_index_sequence<layout.count[S]>{});
+    }
+
+    /**
+     * @brief [private] Finds the leftmost occurrence of segment S at or after `pos`.
+     * @return The text index just past the occurrence, or npos if there is none.
+     */
+    template <std::size_t S>
+    static constexpr std::size_t findSegment(std::string_view s, std::size_t pos) {
+        constexpr std::size_t width = layout.width[S];
+        constexpr StaticToken first_token = parsed.tokens[layout.first[S]];
+
+        if constexpr (layout.count[S] == 1 && first_token.type == TokenType::LITERAL_SEQUENCE) {
+            // A single literal: use the library substring search
+            const std::size_t found = s.find(
+                std::string_view(parsed.literals.data() + first_token.offset, width), pos);
+            return found == std::string_view::npos ? found : found + width;
+        } else {
+            for (std::size_t start = pos; s.length() - start >= width; ++start) {
+                if (segmentAt<S>(s, start)) {
+                    return start + width;
+                }
+            }
+            return std::string_view::npos;
+        }
+    }
+};
\ No newline at end of file
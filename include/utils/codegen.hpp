@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/masked_literal.hpp"
+#include "utils/parser.hpp"
+
+/**
+ * @brief A pattern to be compiled into C++ source, together with its parsed tokens.
+ */
+struct PatternDefinition {
+    std::string pattern;
+    std::vector<Token> tokens;
+};
+
+/**
+ * @brief Options controlling the generated C++ code.
+ */
+struct CodegenOptions {
+    // The namespace that wraps every generated declaration.
+    std::string name_space = "wildcard_patterns";
+    // The path under which the generated source includes the generated header.
+    std::string header_include = "patterns.hpp";
+};
+
+/**
+ * @brief Translates a list of patterns into standalone C++ source code.
+ *
+ * Every pattern becomes its own matching function in which all literals are spelled out as
+ * constants, so the optimizer can see them. The generated code depends only on the standard library
+ * and exposes a dispatch table of {pattern, function} entries. Matching follows the segment
+ * strategy of the bytecode engine: the part before the first '*' is anchored at the start of the
+ * text, the part after the last '*' at the end, and every segment in between is located at its
+ * leftmost occurrence. Dialect tokens have no generated form; see supports().
+ */
+class CodeGenerator {
+   public:
+    /**
+     * @brief Generates the header declaring the dispatch table and lookup functions.
+     * @param options The code generation options.
+     * @return The content of the header file.
+     */
+    static std::string generateHeader(const CodegenOptions& options) {
+        std::string out;
+        out += "// Generated by wildcard_codegen. Do not edit.\n";
+        out += "#pragma once\n\n";
+        out += "#include <cstddef>\n#include <string_view>\n\n";
+        out += std::format("namespace {} {{\n\n", options.name_space);
+        out += "// A compiled pattern and its specialized matching function.\n";
+        out += "struct PatternEntry {\n";
+        out += "    std::string_view pattern;\n";
+        out += "    bool (*match)(std::string_view text);\n";
+        out += "};\n\n";
+        out += "// The compiled patterns, in the order of the pattern file.\n";
+        out += "extern const PatternEntry patterns[];\n";
+        out += "extern const std::size_t pattern_count;\n\n";
+        out += "// Returns the index of the first pattern matching the text, or -1 if none does.\n";
+        out += "long firstMatch(std::string_view text);\n\n";
+        out += std::format("}}  // namespace {}\n", options.name_space);
+        return out;
+    }
+
+    /**
+     * @brief Checks whether a pattern can be compiled into C++ source.
+     * @param p_tokens The tokenized pattern vector.
+     * @return false if the pattern uses dialect tokens, which only the NFA engine runs.
+     */
+    static bool supports(const std::vector<Token>& p_tokens) {
+        return !usesDialectTokens(p_tokens);
+    }
+
+    /**
+     * @brief Generates the source file with one matching function per pattern and the table.
+     * @param definitions The patterns to compile, in dispatch order; each must be supported (see
+     * supports()).
+     * @param options The code generation options.
+     * @return The content of the source file.
+     */
+    static std::string generateSource(const std::vector<PatternDefinition>& definitions,
+                                      const CodegenOptions& options) {
+        std::string out;
+        out += "// Generated by wildcard_codegen. Do not edit.\n";
+        out += std::format("#include \"{}\"\n\n", options.header_include);
+        out += "#include <cstring>\n\n";
+        out += std::format("namespace {} {{\n\n", options.name_space);
+        out += "namespace {\n\n";
+
+        for (size_t id = 0; id < definitions.size(); ++id) {
+            out += std::format("// {}\n", commentSafe(definitions[id].pattern));
+            out += std::format("bool match_{}(std::string_view s) {{\n", id);
+            out += generateBody(definitions[id].tokens);
+            out += "}\n\n";
+        }
+
+        out += "}  // namespace\n\n";
+        out += "const PatternEntry patterns[] = {\n";
+        for (size_t id = 0; id < definitions.size(); ++id) {
+            out += std::format("    {{std::string_view({}, {}), &match_{}}},\n",
+                               quote(definitions[id].pattern), definitions[id].pattern.length(),
+                               id);
+        }
+        if (definitions.empty()) {
+            out += "    {std::string_view(), nullptr},\n";
+        }
+        out += "};\n\n";
+        out += std::format("const std::size_t pattern_count = {};\n\n", definitions.size());
+        out += "long firstMatch(std::string_view text) {\n";
+        out += "    for (std::size_t id = 0; id < pattern_count; ++id) {\n";
+        out += "        if (patterns[id].match(text)) {\n";
+        out += "            return static_cast<long>(id);\n";
+        out += "        }\n";
+        out += "    }\n";
+        out += "    return -1;\n";
+        out += "}\n\n";
+        out += std::format("}}  // namespace {}\n", options.name_space);
+        return out;
+    }
+
+   private:
+    /**
+     * @brief [private] Generates the body of one matching function.
+     */
+    static std::string generateBody(const std::vector<Token>& p_tokens) {
+        const std::vector<MaskedLiteral> windows = MaskedLiteralCompiler::compile(p_tokens);
+
+        // Collect the fixed-width segments and note where the '*' tokens are
+        bool has_star = false;
+        bool trailing_star = false;
+        const MaskedLiteral* head = nullptr;
+        std::vector<const MaskedLiteral*> middle;
+        for (size_t j = 0; j < p_tokens.size(); ++j) {
+            if (p_tokens[j].type == TokenType::ANY_SEQUENCE) {
+                has_star = true;
+                trailing_star = j + 1 == p_tokens.size();
+            } else if (windows[j].token_count > 0) {
+                if (has_star) {
+                    middle.push_back(&windows[j]);
+                } else {
+                    head = &windows[j];
+                }
+            }
+        }
+        const MaskedLiteral* tail = nullptr;
+        if (has_star && !trailing_star && !middle.empty()) {
+            tail = middle.back();
+            middle.pop_back();
+        }
+
+        size_t min_length = (head != nullptr ? head->length() : 0) +
+                            (tail != nullptr ? tail->length() : 0);
+        for (const auto* window : middle) {
+            min_length += window->length();
+        }
+
+        std::string out;
+        if (!has_star || min_length > 0) {  // Every text is long enough for a bare '*'
+            out += std::format("    if (s.size() {} {}) {{\n        return false;\n    }}\n",
+                               has_star ? "<" : "!=", min_length);
+        }
+        out += "    [[maybe_unused]] const char* const p = s.data();\n";
+        if (head != nullptr && !head->isWildcard()) {
+            out += std::format("    if (!({})) {{\n        return false;\n    }}\n",
+                               windowCondition(*head, "p"));
+        }
+        if (!has_star) {
+            out += "    return true;\n";
+            return out;
+        }
+
+        out += std::format("    std::size_t pos = {};\n", head != nullptr ? head->length() : 0);
+        for (const auto* window : middle) {
+            if (window->isWildcard()) {
+                // A run of '?' between two stars consumes a fixed number of characters
+                out += std::format("    pos += {};\n", window->length());
+                out += "    if (pos > s.size()) {\n        return false;\n    }\n";
+            } else if (window->isExact()) {
+                out += "    {\n";
+                out += std::format(
+                    "        const std::size_t found = s.find(std::string_view({}, {}), pos);\n",
+                    quote(window->bytes), window->length());
+                out += "        if (found == std::string_view::npos) {\n";
+                out += "            return false;\n";
+                out += "        }\n";
+                out += std::format("        pos = found + {};\n", window->length());
+                out += "    }\n";
+            } else {
+                out += "    for (;; ++pos) {\n";
+                out += std::format("        if (s.size() - pos < {}) {{\n", window->length());
+                out += "            return false;\n";
+                out += "        }\n";
+                out += std::format("        if ({}) {{\n", windowCondition(*window, "p + pos"));
+                out += std::format("            pos += {};\n", window->length());
+                out += "            break;\n";
+                out += "        }\n";
+                out += "    }\n";
+            }
+        }
+
+        if (tail == nullptr) {
+            // The pattern ends with '*', which absorbs the rest of the text
+            out += "    return pos <= s.size();\n";
+        } else {
+            out += std::format("    if (s.size() - {} < pos) {{\n", tail->length());
+            out += "        return false;\n";
+            out += "    }\n";
+            out += std::format("    const char* const t = p + s.size() - {};\n", tail->length());
+            out += std::format("    return {};\n", windowCondition(*tail, "t"));
+        }
+        return out;
+    }
+
+    /**
+     * @brief [private] Builds a boolean expression comparing a window at `base` with the text.
+     *
+     * Literal runs are compared with `memcmp` on a constant length (which compilers inline into
+     * immediate compares), case-folded letters by setting bit 0x20 of the text byte, and '?'
+     * positions are skipped entirely.
+     */
+    static std::string windowCondition(const MaskedLiteral& window, std::string_view base) {
+        std::string condition;
+        size_t i = 0;
+        while (i < window.length()) {
+            if (window.mask[i] == '\0') {
+                ++i;
+                continue;
+            }
+            if (!condition.empty()) {
+                condition += " && ";
+            }
+            if (window.mask[i] == '\xDF') {
+                condition += std::format("(({})[{}] | 0x20) == {}", base, i,
+                                         quoteChar(window.bytes[i]));
+                ++i;
+                continue;
+            }
+            size_t end = i;
+            while (end < window.length() && window.mask[end] == '\xFF') {
+                ++end;
+            }
+            const std::string bytes = window.bytes.substr(i, end - i);
+            if (bytes.length() == 1) {
+                condition += std::format("({})[{}] == {}", base, i, quoteChar(bytes[0]));
+            } else {
+                condition += std::format("std::memcmp({} + {}, {}, {}) == 0", base, i,
+                                         quote(bytes), bytes.length());
+            }
+            i = end;
+        }
+        return condition.empty() ? "true" : condition;
+    }
+
+    /**
+     * @brief [private] Escapes one byte for use inside a C++ character or string literal.
+     *
+     * '?' is always escaped so that no trigraph can appear, and non-printable bytes use
+     * three-digit octal escapes, which cannot absorb the characters that follow them.
+     */
+    static std::string escape(char c, char quote_char) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '\\' || c == quote_char || c == '?') {
+            return std::string{'\\', c};
+        }
+        if (byte < 0x20 || byte >= 0x7F) {
+            return {'\\', static_cast<char>('0' + (byte >> 6)),
+                    static_cast<char>('0' + ((byte >> 3) & 7)),
+                    static_cast<char>('0' + (byte & 7))};
+        }
+        return std::string(1, c);
+    }
+
+    /**
+     * @brief [private] Returns a C++ string literal for arbitrary bytes.
+     */
+    static std::string quote(std::string_view bytes) {
+        std::string out = "\"";
+        for (char c : bytes) {
+            out += escape(c, '"');
+        }
+        return out + "\"";
+    }
+
+    /**
+     * @brief [private] Returns a C++ character literal for a byte.
+     */
+    static std::string quoteChar(char c) { return "'" + escape(c, '\'') + "'"; }
+
+    /**
+     * @brief [private] Makes a pattern safe to embed in a line comment.
+     */
+    static std::string commentSafe(std::string_view pattern) {
+        std::string out;
+        for (char c : pattern) {
+            const auto byte = static_cast<unsigned char>(c);
+            out += (byte < 0x20 || byte >= 0x7F || c == '\\') ? '.' : c;
+        }
+        return out;
+    }
+};
\ No newline at end of file
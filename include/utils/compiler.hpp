@@ -17,4 +17,12 @@
         assert(false && "Fatal: Unreachable code path executed."); \
         std::abort();                                              \
     } while (0)
+#endif
+
+/**
+ * @brief Signals that the compiler supports taking the address of a label ("labels as values"),
+ * which enables direct-threaded dispatch in interpreter loops.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define APP_HAS_COMPUTED_GOTO 1
 #endif
\ No newline at end of file
@@ -32,11 +32,26 @@ inline std::string_view issueTypeToString(IssueType type) {
 enum class IssueCode {
     // --- Validation Issues ---
     MULTIBYTE_CHARACTER_NOT_ALLOWED,
+    INVALID_UTF8_SEQUENCE,
 
     // --- Parsing Issues ---
     UNDEFINED_ESCAPE_SEQUENCE,
     TRAILING_BACKSLASH,
-    CONSECUTIVE_ASTERISKS_MERGED
+    CONSECUTIVE_ASTERISKS_MERGED,
+    UNTERMINATED_ALTERNATION,
+    UNMATCHED_CLOSING_BRACE,
+    UNTERMINATED_CHAR_CLASS,
+    REVERSED_CHAR_CLASS_RANGE,
+    INVALID_HEX_ESCAPE,
+
+    // --- Performance Lint Issues ---
+    MANY_STARS_WITH_SHORT_LITERALS,
+    LEADING_STAR_SHORT_LITERAL,
+    PATTERN_LONGER_THAN_TEXT,
+
+    // --- Admission Issues ---
+    PATTERN_TOO_EXPENSIVE,
+    ENGINE_DOWNGRADED
 };
 
 /**
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/parser.hpp"
+#include "utils/simd.hpp"
+
+/**
+ * @brief A fixed-width window of the pattern compiled into a (bytes, mask) pair.
+ *
+ * A maximal run of LITERAL_SEQUENCE and ANY_CHAR tokens (e.g. "2024-??-??T??:??") always matches
+ * exactly the same number of characters. Folding the run into one window allows it to be compared
+ * against the text in a single vectorized pass instead of one `compare` per token.
+ *
+ * Case-folded letters are stored in lower case with a mask of 0xDF. Upper- and lower-case ASCII
+ * letters only differ in bit 0x20, so the same masked compare accepts exactly the two cases of the
+ * letter, without ever copying or converting the text.
+ */
+struct MaskedLiteral {
+    std::string bytes;       // The expected bytes; positions covered by '?' hold '\0'.
+    std::string mask;        // '\xFF' for an exact byte, '\xDF' for a folded letter, '\0' for '?'.
+    size_t token_count = 0;  // Number of tokens folded into this window (0 if not a run start).
+
+    /**
+     * @brief Returns the number of text characters consumed by this window.
+     */
+    size_t length() const { return bytes.size(); }
+
+    /**
+     * @brief Returns true if every byte must match exactly, so a plain substring search applies.
+     */
+    bool isExact() const { return mask.find_first_not_of('\xFF') == std::string::npos; }
+
+    /**
+     * @brief Returns true if the window consists of '?' only.
+     */
+    bool isWildcard() const { return mask.find_first_not_of('\0') == std::string::npos; }
+
+    /**
+     * @brief Checks whether the window matches the text at a given position.
+     * @param s The text string view; must contain at least `length()` characters from `pos`.
+     * @param pos The starting index in the text.
+     * @return true if every non-wildcard byte of the window equals the text.
+     */
+    bool matchesAt(std::string_view s, size_t pos) const {
+        return maskedEquals(s.data() + pos, bytes.data(), mask.data(), bytes.size());
+    }
+};
+
+/**
+ * @brief Compiles the fixed-width runs of a token vector into masked literal windows.
+ *
+ * Only LITERAL_SEQUENCE and ANY_CHAR tokens are folded into windows. Dialect tokens end a run and
+ * get no window of their own, so an engine built on windows must not be given a dialect pattern
+ * (see usesDialectTokens()).
+ */
+class MaskedLiteralCompiler {
+   public:
+    /**
+     * @brief Builds one window for every maximal run of LITERAL_SEQUENCE and ANY_CHAR tokens.
+     * @param p_tokens The tokenized pattern vector.
+     * @return A vector parallel to `p_tokens`. The entry at the index of the first token of a run
+     * holds the compiled window; every other entry has a `token_count` of 0.
+     */
+    static std::vector<MaskedLiteral> compile(const std::vector<Token>& p_tokens) {
+        std::vector<MaskedLiteral> windows(p_tokens.size());
+
+        size_t j = 0;
+        while (j < p_tokens.size()) {
+            if (!isFixedWidth(p_tokens[j])) {
+                j++;
+                continue;
+            }
+            windows[j] = compileRun(p_tokens, j);
+            j += windows[j].token_count;
+        }
+
+        return windows;
+    }
+
+    /**
+     * @brief Builds the window of the maximal run of LITERAL_SEQUENCE and ANY_CHAR tokens that
+     * starts at a given token.
+     * @param p_tokens The tokenized pattern vector.
+     * @param j The index of the first token of the run.
+     * @return The compiled window.
+     */
+    static MaskedLiteral compileRun(const std::vector<Token>& p_tokens, size_t j) {
+        // Extend the window over every consecutive fixed-width token
+        MaskedLiteral window;
+        size_t k = j;
+        for (; k < p_tokens.size() && isFixedWidth(p_tokens[k]); ++k) {
+            if (p_tokens[k].type == TokenType::LITERAL_SEQUENCE) {
+                const std::string& literal = *p_tokens[k].value;
+                window.bytes += literal;
+                for (char c : literal) {
+                    const bool folded = p_tokens[k].fold_case && c >= 'a' && c <= 'z';
+                    window.mask += folded ? '\xDF' : '\xFF';
+                }
+            } else {
+                window.bytes += '\0';
+                window.mask += '\0';
+            }
+        }
+        window.token_count = k - j;
+        return window;
+    }
+
+    /**
+     * @brief Returns the number of bytes held by a vector of windows.
+     */
+    static size_t spaceUsed(const std::vector<MaskedLiteral>& windows) {
+        size_t space = windows.capacity() * sizeof(MaskedLiteral);
+        for (const auto& window : windows) {
+            space += window.bytes.capacity() + window.mask.capacity();
+        }
+        return space;
+    }
+
+   private:
+    /**
+     * @brief [private] Returns true for the tokens a window can hold: literals and '?'.
+     */
+    static bool isFixedWidth(const Token& token) {
+        return token.type == TokenType::LITERAL_SEQUENCE || token.type == TokenType::ANY_CHAR;
+    }
+};
+
+/**
+ * @brief The masked literal windows of a pattern, each compiled when it is first needed.
+ *
+ * The reference solvers are constructed for a single text and often reject it after one or two
+ * runs. Compiling a run only when the solver reaches it keeps such calls from building, and
+ * allocating, the windows of runs they never compare.
+ */
+class LazyMaskedLiterals {
+   public:
+    explicit LazyMaskedLiterals(const std::vector<Token>& p_tokens_in) : p_tokens(p_tokens_in) {}
+
+    /**
+     * @brief Returns the window of the run starting at a token, compiling it on first use.
+     * @param j The index of the first token of a run of LITERAL_SEQUENCE and ANY_CHAR tokens.
+     */
+    const MaskedLiteral& operator[](size_t j) {
+        if (windows.empty()) {
+            windows.resize(p_tokens.size());
+        }
+        if (windows[j].token_count == 0) {
+            windows[j] = MaskedLiteralCompiler::compileRun(p_tokens, j);
+        }
+        return windows[j];
+    }
+
+    /**
+     * @brief Returns the number of bytes held by the windows compiled so far.
+     */
+    size_t spaceUsed() const { return MaskedLiteralCompiler::spaceUsed(windows); }
+
+   private:
+    const std::vector<Token>& p_tokens;
+    std::vector<MaskedLiteral> windows;  // Parallel to `p_tokens`, allocated on first use.
+};
\ No newline at end of file
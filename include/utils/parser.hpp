@@ -1,8 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "utils/issues.hpp"
@@ -12,10 +19,63 @@
  *
  * This enum provides clear, semantic names for each component of the parsed pattern.
  */
-enum class TokenType {
+enum class TokenType : std::uint8_t {
     LITERAL_SEQUENCE,  // Represents a sequence of one or more literal characters.
     ANY_CHAR,          // Represents the '?' wildcard, which matches any single character.
-    ANY_SEQUENCE       // Represents the '*' wildcard, which matches any sequence of characters.
+    ANY_SEQUENCE,      // Represents the '*' wildcard, which matches any sequence of characters.
+    ALTERNATION,       // Represents '{a,b}' (opt-in), which matches any one of its alternatives.
+    CHAR_CLASS,        // Represents '[a-z]' (opt-in), which matches one character of a set.
+    SEGMENT_SEQUENCE,  // Represents '*' in path mode, which matches any sequence without a '/'.
+    ANY_SEGMENTS       // Represents '**/' in path mode, which matches zero or more whole segments.
+};
+
+/**
+ * @brief A set of bytes stored as a 256-bit bitmap, so testing a byte is a single lookup.
+ */
+struct CharClass {
+    std::array<std::uint64_t, 4> bits = {};
+
+    bool contains(unsigned char c) const { return ((bits[c >> 6] >> (c & 63)) & 1) != 0; }
+    void add(unsigned char c) { bits[c >> 6] |= std::uint64_t{1} << (c & 63); }
+    void remove(unsigned char c) { bits[c >> 6] &= ~(std::uint64_t{1} << (c & 63)); }
+    void addRange(unsigned char first, unsigned char last) {
+        for (unsigned c = first; c <= last; ++c) {
+            add(static_cast<unsigned char>(c));
+        }
+    }
+    void invert() {
+        for (auto& word : bits) {
+            word = ~word;
+        }
+    }
+    // Adds the other case of every ASCII letter in the set.
+    void addOtherCase() {
+        for (unsigned char c = 'a'; c <= 'z'; ++c) {
+            const auto upper = static_cast<unsigned char>(c - 'a' + 'A');
+            if (contains(c) || contains(upper)) {
+                add(c);
+                add(upper);
+            }
+        }
+    }
+    // Returns the number of bytes in the set.
+    std::size_t count() const {
+        std::size_t total = 0;
+        for (auto word : bits) {
+            total += static_cast<std::size_t>(std::popcount(word));
+        }
+        return total;
+    }
+    // Returns true if every byte of `other` is also in this set.
+    bool includes(const CharClass& other) const {
+        for (std::size_t w = 0; w < bits.size(); ++w) {
+            if ((other.bits[w] & ~bits[w]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator==(const CharClass& other) const = default;
 };
 
 /**
@@ -28,9 +88,57 @@ struct Token {
     TokenType type;
     // Stores the character sequence for LITERAL_SEQUENCE tokens.
     std::optional<std::string> value = std::nullopt;
+    // Stores the token sequence of each alternative for ALTERNATION tokens.
+    std::vector<std::vector<Token>> alternatives = {};
+    // Stores the accepted bytes for CHAR_CLASS tokens.
+    CharClass char_class = {};
+    // For LITERAL_SEQUENCE tokens: the value is in lower case and ASCII letters match either case.
+    bool fold_case = false;
     bool operator==(const Token& other) const = default;
 };
 
+/**
+ * @brief Checks whether a token vector contains opt-in dialect tokens, which only the NFA engine
+ * runs. Dialect tokens only nest inside an ALTERNATION, so the top level suffices.
+ * @param p_tokens The tokenized pattern vector.
+ * @return true if any token is an ALTERNATION, CHAR_CLASS, SEGMENT_SEQUENCE or ANY_SEGMENTS.
+ */
+inline bool usesDialectTokens(const std::vector<Token>& p_tokens) {
+    return std::any_of(p_tokens.begin(), p_tokens.end(), [](const Token& token) {
+        return token.type != TokenType::LITERAL_SEQUENCE && token.type != TokenType::ANY_CHAR &&
+               token.type != TokenType::ANY_SEQUENCE;
+    });
+}
+
+/**
+ * @brief Opt-in dialect features of the pattern language.
+ *
+ * Every feature is off by default, so existing patterns keep their meaning. Dialect tokens are
+ * only executed by the NFA engine, which the Planner selects for them automatically. Case-folded
+ * literals are plain LITERAL_SEQUENCE tokens and run on every engine.
+ */
+struct ParseOptions {
+    // Parse '{a,b,c}' as an ALTERNATION; '\{', '\}' and '\,' become defined escapes.
+    bool alternation = false;
+    // Parse '[a-z]', '[!a-z]' and '[^a-z]' as a CHAR_CLASS; '\[' and '\]' become defined escapes.
+    bool char_classes = false;
+    // Match the ASCII letters of literals regardless of case; the text is never copied or folded.
+    bool case_insensitive = false;
+    // Read texts as UTF-8: '?' becomes an ALTERNATION matching one code point of one to four
+    // bytes. Literals and '*' stay byte-wise, which is exact on valid UTF-8. The tokens are fixed
+    // at parse time and the matchers never inspect the text for it, so an all-ASCII text still
+    // pays for the code point automaton. Callers that know their text is ASCII (see the `ascii`
+    // output of Validator::validateUtf8String) should parse without this mode, which gives the
+    // same answers on the byte-wise engines.
+    bool utf8 = false;
+    // Match raw bytes: '\xHH' escapes any byte, including NUL and bytes above 0x7F, in literals
+    // and classes. Texts are passed as std::span<const std::byte> and are never validated.
+    bool binary = false;
+    // Match paths: '*', '?' and classes never match '/', and a '**' that forms a whole segment
+    // matches any number of segments, so 'src/**/*.c' matches both 'src/a.c' and 'src/x/y/a.c'.
+    bool path = false;
+};
+
 /**
  * @brief Raw information about a potential issue discovered during parsing.
  */
@@ -47,6 +155,8 @@ struct ParseEvent {
 struct ParseResult {
     std::vector<Token> tokens;
     std::vector<ParseEvent> events;
+    // 1-based position in the raw pattern string where each token starts, parallel to `tokens`.
+    std::vector<size_t> token_positions;
 };
 
 /**
@@ -57,16 +167,37 @@ class Parser {
     /**
      * @brief Parses a pattern string view, generating tokens and raw events.
      * @param p The pattern string view.
+     * @param options The dialect features to enable.
      * @return A ParseResult struct containing tokens and raw parse events.
      */
-    static ParseResult parse(std::string_view p) {
+    static ParseResult parse(std::string_view p, const ParseOptions& options = {}) {
         ParseResult result;
-        if (p.empty()) {
-            return result;
-        }
+        size_t i = 0;
+        parseSequence(p, i, 0, options, result.events, result.tokens, &result.token_positions);
+        return result;
+    }
 
+   private:
+    /**
+     * @brief [private] Parses tokens from position `i` up to the end of the pattern or, inside
+     * braces (`depth` > 0), up to the ',' or '}' that ends the current alternative.
+     * @param positions Receives the start position of each token; null inside braces.
+     */
+    static void parseSequence(std::string_view p, size_t& i, size_t depth,
+                              const ParseOptions& options, std::vector<ParseEvent>& events,
+                              std::vector<Token>& tokens, std::vector<size_t>* positions) {
         // A temporary builder for merging consecutive literal characters
         std::string literal_builder;
+        // The 1-based position where the literal in the builder starts
+        size_t literal_position = 0;
+
+        // Adds one literal character to the builder
+        auto add_literal_char = [&](char c) {
+            if (literal_builder.empty()) {
+                literal_position = i + 1;
+            }
+            literal_builder += c;
+        };
 
         /**
          * @brief A helper lambda to flush the content of the literal_builder.
@@ -75,59 +206,554 @@ class Parser {
          */
         auto flush_literal_builder = [&]() {
             if (!literal_builder.empty()) {
-                result.tokens.push_back({TokenType::LITERAL_SEQUENCE, std::move(literal_builder)});
+                Token literal = {TokenType::LITERAL_SEQUENCE, std::move(literal_builder)};
+                if (options.case_insensitive) {
+                    foldCase(literal);
+                }
+                appendToken(tokens, positions, std::move(literal), literal_position);
                 literal_builder.clear();  // Reset for the next sequence
             }
         };
 
-        for (size_t i = 0; i < p.length(); ++i) {
+        for (; i < p.length(); ++i) {
             char current_char = p[i];
 
+            // Inside braces, an unescaped ',' or '}' ends the alternative
+            if (depth > 0 && (current_char == ',' || current_char == '}')) {
+                break;
+            }
+
             switch (current_char) {
                 case '?':
                     flush_literal_builder();
-                    result.tokens.push_back({TokenType::ANY_CHAR});
+                    tokens.push_back(anyChar(options));
+                    pushPosition(positions, i + 1);
                     break;
 
                 case '*':
                     flush_literal_builder();
+                    if (options.path) {
+                        parsePathStars(p, i, events, tokens, positions);
+                        break;
+                    }
                     // Merge consecutive '*' by only adding if the previous token wasn't also '*'
-                    if (!result.tokens.empty() &&
-                        result.tokens.back().type == TokenType::ANY_SEQUENCE) {
-                        result.events.push_back({IssueCode::CONSECUTIVE_ASTERISKS_MERGED, i + 1});
+                    if (!tokens.empty() && tokens.back().type == TokenType::ANY_SEQUENCE) {
+                        events.push_back({IssueCode::CONSECUTIVE_ASTERISKS_MERGED, i + 1});
                     } else {
-                        result.tokens.push_back({TokenType::ANY_SEQUENCE});
+                        tokens.push_back({TokenType::ANY_SEQUENCE});
+                        pushPosition(positions, i + 1);
                     }
                     break;
 
                 case '\\':
                     if (i + 1 < p.length()) {
                         char next_char = p[i + 1];
+                        if (options.binary && next_char == 'x') {
+                            // A byte given as two hex digits; a malformed one stays a literal 'x'
+                            const std::optional<unsigned char> byte = hexByte(p.substr(i + 2, 2));
+                            if (!byte) {
+                                events.push_back({IssueCode::INVALID_HEX_ESCAPE, i + 1,
+                                                  std::string(p.substr(i + 1, 3))});
+                            }
+                            add_literal_char(byte ? static_cast<char>(*byte) : next_char);
+                            i += byte ? 3 : 1;
+                            break;
+                        }
                         // Check for undefined escape sequences. A "defined" escape is one that
                         // escapes a character with special meaning ('*', '?', '\')
-                        if (next_char != '*' && next_char != '?' && next_char != '\\') {
-                            result.events.push_back({IssueCode::UNDEFINED_ESCAPE_SEQUENCE, i + 1,
-                                                     std::string(1, next_char)});
+                        if (!isSpecialCharacter(next_char, options)) {
+                            events.push_back({IssueCode::UNDEFINED_ESCAPE_SEQUENCE, i + 1,
+                                              std::string(1, next_char)});
                         }
                         // Still treat as literal for potential recovery
-                        literal_builder += next_char;
+                        add_literal_char(next_char);
                         i++;  // Skip the next character in the loop
                     } else {
                         // A trailing backslash event
-                        result.events.push_back({IssueCode::TRAILING_BACKSLASH, i + 1});
+                        events.push_back({IssueCode::TRAILING_BACKSLASH, i + 1});
                     }
                     break;
 
+                case '{':
+                    if (options.alternation) {
+                        flush_literal_builder();
+                        const size_t open_position = i + 1;
+                        for (Token& token : parseAlternation(p, i, depth, options, events)) {
+                            appendToken(tokens, positions, std::move(token), open_position);
+                        }
+                        break;
+                    }
+                    add_literal_char(current_char);
+                    break;
+
+                case '[':
+                    if (options.char_classes) {
+                        const size_t open_position = i + 1;
+                        if (std::optional<CharClass> char_class =
+                                parseCharClass(p, i, events, options)) {
+                            flush_literal_builder();
+                            appendToken(tokens, positions,
+                                        {TokenType::CHAR_CLASS, std::nullopt, {}, *char_class},
+                                        open_position);
+                            break;
+                        }
+                    }
+                    // An unterminated class is kept as a literal '[' for recovery
+                    add_literal_char(current_char);
+                    break;
+
                 default:
+                    if (current_char == '}' && options.alternation) {
+                        // Only reachable outside braces; kept as a literal for recovery
+                        events.push_back({IssueCode::UNMATCHED_CLOSING_BRACE, i + 1});
+                    }
                     // This is a standard literal character
-                    literal_builder += current_char;
+                    add_literal_char(current_char);
                     break;
             }
         }
 
         // After the loop, there might be a pending literal sequence
         flush_literal_builder();
+    }
+
+    /**
+     * @brief [private] Parses the alternatives of a '{' at position `i` and leaves `i` on the
+     * closing '}' (or the end of the pattern if it is missing).
+     * @return The tokens the alternation compiles to, see buildAlternation().
+     */
+    static std::vector<Token> parseAlternation(std::string_view p, size_t& i, size_t depth,
+                                               const ParseOptions& options,
+                                               std::vector<ParseEvent>& events) {
+        const size_t open_position = i + 1;
+        std::vector<std::vector<Token>> alternatives;
+        while (true) {
+            ++i;  // Skip the '{' or ','
+            alternatives.emplace_back();
+            parseSequence(p, i, depth + 1, options, events, alternatives.back(), nullptr);
+            if (i >= p.length()) {
+                events.push_back({IssueCode::UNTERMINATED_ALTERNATION, open_position});
+                break;
+            }
+            if (p[i] == '}') {
+                break;
+            }
+        }
+        return buildAlternation(std::move(alternatives));
+    }
+
+    /**
+     * @brief [private] Parses a character class at the '[' at position `i` and leaves `i` on the
+     * closing ']'.
+     *
+     * A leading '!' or '^' negates the class, a ']' right after the opening bracket (and the
+     * negation) is a member, and a '-' between two members forms a range. A '-' at the start or end
+     * is a member itself. Inside the class only ']', '\', '-', '^', '!' and '[' are defined
+     * escapes, plus '\xHH' in binary mode. With case-insensitive matching, letters are added in
+     * both cases before the class is negated, and in path mode '/' is removed afterwards.
+     *
+     * @return The class, or std::nullopt if it has no closing ']'; `i` is then left unchanged and
+     * only the UNTERMINATED_CHAR_CLASS event is reported.
+     */
+    static std::optional<CharClass> parseCharClass(std::string_view p, size_t& i,
+                                                   std::vector<ParseEvent>& events,
+                                                   const ParseOptions& options) {
+        std::vector<ParseEvent> class_events;
+        CharClass char_class;
+        size_t k = i + 1;
+        const bool negated = k < p.length() && (p[k] == '!' || p[k] == '^');
+        k += negated ? 1 : 0;
+
+        // Reads one member at k, resolving escapes, and leaves k on its last character
+        auto read_member = [&](unsigned char& member) {
+            if (p[k] != '\\') {
+                member = static_cast<unsigned char>(p[k]);
+                return true;
+            }
+            if (k + 1 >= p.length()) {
+                return false;  // A trailing backslash leaves the class unterminated
+            }
+            const char escaped = p[++k];
+            if (options.binary && escaped == 'x') {
+                const std::optional<unsigned char> byte = hexByte(p.substr(k + 1, 2));
+                if (byte) {
+                    member = *byte;
+                    k += 2;
+                    return true;
+                }
+                class_events.push_back(
+                    {IssueCode::INVALID_HEX_ESCAPE, k, std::string(p.substr(k, 3))});
+                member = static_cast<unsigned char>(escaped);
+                return true;
+            }
+            if (std::string_view("]\\-^![").find(escaped) == std::string_view::npos) {
+                class_events.push_back(
+                    {IssueCode::UNDEFINED_ESCAPE_SEQUENCE, k, std::string(1, escaped)});
+            }
+            member = static_cast<unsigned char>(escaped);
+            return true;
+        };
+
+        for (bool first = true; k < p.length() && (p[k] != ']' || first); ++k, first = false) {
+            const size_t member_position = k + 1;
+            unsigned char low = 0;
+            if (!read_member(low)) {
+                k = p.length();
+                break;
+            }
+            if (k + 2 < p.length() && p[k + 1] == '-' && p[k + 2] != ']') {
+                k += 2;
+                unsigned char high = 0;
+                if (!read_member(high)) {
+                    k = p.length();
+                    break;
+                }
+                if (high < low) {
+                    class_events.push_back({IssueCode::REVERSED_CHAR_CLASS_RANGE, member_position,
+                                            std::string(p.substr(member_position - 1,
+                                                                 k + 2 - member_position))});
+                } else {
+                    char_class.addRange(low, high);
+                }
+            } else {
+                char_class.add(low);
+            }
+        }
+
+        if (k >= p.length()) {
+            events.push_back({IssueCode::UNTERMINATED_CHAR_CLASS, i + 1});
+            return std::nullopt;
+        }
+        events.insert(events.end(), class_events.begin(), class_events.end());
+        if (options.case_insensitive) {
+            char_class.addOtherCase();
+        }
+        if (negated) {
+            char_class.invert();
+        }
+        if (options.path) {
+            char_class.remove('/');
+        }
+        i = k;
+        return char_class;
+    }
+
+    /**
+     * @brief [private] Compiles a list of alternatives into a compact token sequence.
+     *
+     * Instead of expanding the alternatives, they are factored into a trie: duplicates are
+     * dropped, a literal suffix or wildcard shared by all alternatives moves behind the
+     * alternation, and alternatives starting with the same character or wildcard share that prefix
+     * in front of a nested alternation. `{x.jpg,x.jpeg,x.png}` becomes `x.{jp{,e},pn}g`. The result
+     * is never larger than the input, however deeply the braces nest.
+     *
+     * @return The alternation's tokens: an optional ALTERNATION token followed by the shared
+     * suffix, or just the tokens of the only distinct alternative.
+     */
+    static std::vector<Token> buildAlternation(std::vector<std::vector<Token>> alternatives) {
+        // 1. Drop duplicate alternatives
+        std::vector<std::vector<Token>> distinct;
+        for (auto& alternative : alternatives) {
+            if (std::find(distinct.begin(), distinct.end(), alternative) == distinct.end()) {
+                distinct.push_back(std::move(alternative));
+            }
+        }
+        if (distinct.size() == 1) {
+            return std::move(distinct.front());
+        }
+
+        // 2. Move the suffix shared by all alternatives behind the alternation
+        std::vector<Token> suffix;
+        while (std::optional<Token> shared = sharedSuffix(distinct)) {
+            for (auto& alternative : distinct) {
+                if (shared->type != TokenType::LITERAL_SEQUENCE) {
+                    alternative.pop_back();
+                    continue;
+                }
+                std::string& literal = *alternative.back().value;
+                literal.erase(literal.length() - shared->value->length());
+                if (literal.empty()) {
+                    alternative.pop_back();
+                } else if (alternative.back().fold_case) {
+                    foldCase(alternative.back());  // The rest may have lost all its letters
+                }
+            }
+            suffix.insert(suffix.begin(), std::move(*shared));
+        }
+
+        // 3. Group alternatives by their first character or wildcard and share that prefix
+        std::vector<std::vector<Token>> branches;
+        std::vector<bool> grouped(distinct.size(), false);
+        for (size_t a = 0; a < distinct.size(); ++a) {
+            if (grouped[a]) {
+                continue;
+            }
+            std::vector<std::vector<Token>> group;
+            group.push_back(std::move(distinct[a]));
+            for (size_t b = a + 1; b < distinct.size(); ++b) {
+                if (!grouped[b] && sameHead(group.front(), distinct[b])) {
+                    group.push_back(std::move(distinct[b]));
+                    grouped[b] = true;
+                }
+            }
+            if (group.size() == 1) {
+                branches.push_back(std::move(group.front()));
+                continue;
+            }
 
+            Token prefix = sharedPrefix(group);
+            for (auto& alternative : group) {
+                if (prefix.type == TokenType::LITERAL_SEQUENCE) {
+                    alternative.front().value->erase(0, prefix.value->length());
+                    if (alternative.front().fold_case) {
+                        foldCase(alternative.front());
+                    }
+                }
+                if (prefix.type != TokenType::LITERAL_SEQUENCE ||
+                    alternative.front().value->empty()) {
+                    alternative.erase(alternative.begin());
+                }
+            }
+            std::vector<Token> branch = {std::move(prefix)};
+            for (Token& token : buildAlternation(std::move(group))) {
+                appendToken(branch, nullptr, std::move(token), 0);
+            }
+            branches.push_back(std::move(branch));
+        }
+
+        std::vector<Token> result;
+        if (branches.size() == 1) {
+            result = std::move(branches.front());
+        } else {
+            result.push_back({TokenType::ALTERNATION, std::nullopt, std::move(branches)});
+        }
+        for (Token& token : suffix) {
+            appendToken(result, nullptr, std::move(token), 0);
+        }
         return result;
     }
+
+    /**
+     * @brief [private] Returns the token all alternatives end with, or for literals the longest
+     * literal suffix they share, or std::nullopt if they share none.
+     */
+    static std::optional<Token> sharedSuffix(const std::vector<std::vector<Token>>& alternatives) {
+        for (const auto& alternative : alternatives) {
+            if (alternative.empty()) {
+                return std::nullopt;
+            }
+        }
+        const Token& last = alternatives.front().back();
+        if (last.type != TokenType::LITERAL_SEQUENCE) {
+            for (const auto& alternative : alternatives) {
+                if (!(alternative.back() == last)) {
+                    return std::nullopt;
+                }
+            }
+            return last;
+        }
+
+        std::string_view shared = *last.value;
+        for (const auto& alternative : alternatives) {
+            if (alternative.back().type != TokenType::LITERAL_SEQUENCE) {
+                return std::nullopt;
+            }
+            const std::string_view literal = *alternative.back().value;
+            size_t k = 0;
+            while (k < shared.length() && k < literal.length() &&
+                   shared[shared.length() - 1 - k] == literal[literal.length() - 1 - k]) {
+                ++k;
+            }
+            shared.remove_prefix(shared.length() - k);
+        }
+        if (shared.empty()) {
+            return std::nullopt;
+        }
+        return literalLike(last, shared);
+    }
+
+    /**
+     * @brief [private] Returns true if two alternatives start with the same character or
+     * wildcard, so they can share a prefix.
+     */
+    static bool sameHead(const std::vector<Token>& a, const std::vector<Token>& b) {
+        if (a.empty() || b.empty() || a.front().type != b.front().type) {
+            return false;
+        }
+        if (a.front().type == TokenType::LITERAL_SEQUENCE) {
+            return a.front().value->front() == b.front().value->front();
+        }
+        return a.front() == b.front();
+    }
+
+    /**
+     * @brief [private] Returns the prefix shared by a group of alternatives with the same head:
+     * the head token itself, or for literals their longest common prefix.
+     */
+    static Token sharedPrefix(const std::vector<std::vector<Token>>& group) {
+        const Token& head = group.front().front();
+        if (head.type != TokenType::LITERAL_SEQUENCE) {
+            return head;
+        }
+        std::string_view shared = *head.value;
+        for (const auto& alternative : group) {
+            const std::string_view literal = *alternative.front().value;
+            size_t k = 0;
+            while (k < shared.length() && k < literal.length() && shared[k] == literal[k]) {
+                ++k;
+            }
+            shared = shared.substr(0, k);
+        }
+        return literalLike(head, shared);
+    }
+
+    /**
+     * @brief [private] Parses the run of '*' at position `i` in path mode and leaves `i` on its
+     * last character, or on the '/' a '**' segment absorbs.
+     *
+     * A run forming a whole segment (between the start or a '/' and the end or a '/') becomes an
+     * ANY_SEGMENTS token, which includes the '/' after it; at the end of the pattern it is followed
+     * by a SEGMENT_SEQUENCE, since the last segment has no '/'. Any other run is a single
+     * SEGMENT_SEQUENCE. Stars beyond these are reported as merged.
+     */
+    static void parsePathStars(std::string_view p, size_t& i, std::vector<ParseEvent>& events,
+                               std::vector<Token>& tokens, std::vector<size_t>* positions) {
+        size_t end = i;
+        while (end < p.length() && p[end] == '*') {
+            ++end;
+        }
+        const bool whole_segment = end - i >= 2 && (i == 0 || p[i - 1] == '/') &&
+                                   (end == p.length() || p[end] == '/');
+        for (size_t k = i + (whole_segment ? 2 : 1); k < end; ++k) {
+            events.push_back({IssueCode::CONSECUTIVE_ASTERISKS_MERGED, k + 1});
+        }
+        if (whole_segment) {
+            appendToken(tokens, positions, {TokenType::ANY_SEGMENTS}, i + 1);
+        }
+        if (!whole_segment || end == p.length()) {
+            appendToken(tokens, positions, {TokenType::SEGMENT_SEQUENCE}, i + 1);
+        }
+        i = whole_segment && end < p.length() ? end : end - 1;
+    }
+
+    /**
+     * @brief [private] Returns the token for '?': ANY_CHAR, or a class that excludes '/' in path
+     * mode, or a whole code point in UTF-8 mode.
+     */
+    static Token anyChar(const ParseOptions& options) {
+        if (options.utf8) {
+            return anyCodePoint(options.path);
+        }
+        if (!options.path) {
+            return {TokenType::ANY_CHAR};
+        }
+        Token token = {TokenType::CHAR_CLASS};
+        token.char_class.invert();
+        token.char_class.remove('/');
+        return token;
+    }
+
+    /**
+     * @brief [private] Returns the token for '?' in UTF-8 mode: one lead byte followed by the
+     * continuation bytes it announces. Texts are validated beforehand, so the lead byte alone
+     * determines the length.
+     * @param path Excludes '/' from the single-byte code points.
+     */
+    static Token anyCodePoint(bool path) {
+        CharClass ascii, lead_2, lead_3, lead_4, continuation;
+        ascii.addRange(0x00, 0x7F);
+        if (path) {
+            ascii.remove('/');
+        }
+        lead_2.addRange(0xC0, 0xDF);
+        lead_3.addRange(0xE0, 0xEF);
+        lead_4.addRange(0xF0, 0xF7);
+        continuation.addRange(0x80, 0xBF);
+        const auto byte = [](const CharClass& char_class) {
+            return Token{TokenType::CHAR_CLASS, std::nullopt, {}, char_class};
+        };
+        return {TokenType::ALTERNATION,
+                std::nullopt,
+                {{byte(ascii)},
+                 {byte(lead_2), byte(continuation)},
+                 {byte(lead_3), byte(continuation), byte(continuation)},
+                 {byte(lead_4), byte(continuation), byte(continuation), byte(continuation)}}};
+    }
+
+    /**
+     * @brief [private] Returns a literal token with the given value, case-folded like `source`.
+     */
+    static Token literalLike(const Token& source, std::string_view value) {
+        Token literal = {TokenType::LITERAL_SEQUENCE, std::string(value)};
+        if (source.fold_case) {
+            foldCase(literal);
+        }
+        return literal;
+    }
+
+    /**
+     * @brief [private] Appends a token, merging it into a preceding literal, '*' or '**'.
+     */
+    static void appendToken(std::vector<Token>& tokens, std::vector<size_t>* positions,
+                            Token token, size_t position) {
+        if (!tokens.empty() && tokens.back().type == token.type &&
+            (token.type == TokenType::LITERAL_SEQUENCE || token.type == TokenType::ANY_SEQUENCE ||
+             token.type == TokenType::ANY_SEGMENTS)) {
+            if (token.type == TokenType::LITERAL_SEQUENCE) {
+                *tokens.back().value += *token.value;
+                tokens.back().fold_case = tokens.back().fold_case || token.fold_case;
+            }
+            return;
+        }
+        tokens.push_back(std::move(token));
+        pushPosition(positions, position);
+    }
+
+    /**
+     * @brief [private] Lowers the ASCII letters of a literal and marks it as case-folded. A literal
+     * without letters stays exact, so it can still be searched for byte by byte.
+     */
+    static void foldCase(Token& literal) {
+        literal.fold_case = false;
+        for (char& c : *literal.value) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+            literal.fold_case = literal.fold_case || (c >= 'a' && c <= 'z');
+        }
+    }
+
+    /**
+     * @brief [private] Records a token position unless positions are not tracked.
+     */
+    static void pushPosition(std::vector<size_t>* positions, size_t position) {
+        if (positions != nullptr) {
+            positions->push_back(position);
+        }
+    }
+
+    /**
+     * @brief [private] Returns the byte spelled by exactly two hex digits, or std::nullopt.
+     */
+    static std::optional<unsigned char> hexByte(std::string_view digits) {
+        unsigned value = 0;
+        if (digits.length() != 2 ||
+            std::from_chars(digits.data(), digits.data() + 2, value, 16).ptr != digits.data() + 2) {
+            return std::nullopt;
+        }
+        return static_cast<unsigned char>(value);
+    }
+
+    /**
+     * @brief [private] Returns true if a character has a special meaning and may be escaped.
+     */
+    static bool isSpecialCharacter(char c, const ParseOptions& options) {
+        if (c == '*' || c == '?' || c == '\\') {
+            return true;
+        }
+        if (options.char_classes && (c == '[' || c == ']')) {
+            return true;
+        }
+        return options.alternation && (c == '{' || c == '}' || c == ',');
+    }
 };
\ No newline at end of file
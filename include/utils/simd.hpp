@@ -0,0 +1,540 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Detects which vector instruction sets the compiler is allowed to emit.
+ *
+ * SSE2 is part of the x86-64 baseline, so it is available in every 64-bit x86 build. SSSE3, which
+ * adds the byte shuffle used for table lookups, and AVX2 are only enabled when the translation unit
+ * is compiled for them (e.g. `-mssse3`, `-mavx2` or `-march=native`).
+ */
+#if defined(__AVX2__)
+#define APP_SIMD_AVX2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define APP_SIMD_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define APP_SIMD_SSE2 1
+#endif
+
+#if defined(APP_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(APP_SIMD_SSSE3)
+#include <tmmintrin.h>
+#elif defined(APP_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Compares `len` bytes of the text against a pattern window, ignoring masked-out bytes.
+ *
+ * A byte position matches when `(text[i] ^ bytes[i]) & mask[i]` is zero, so a mask byte of 0xFF
+ * requires an exact match and a mask byte of 0x00 accepts any character. The comparison runs 32
+ * (AVX2) or 16 (SSE2) bytes at a time with a single vector compare and mask test per block.
+ *
+ * @param text Pointer to the text; at least `len` bytes must be readable.
+ * @param bytes Pointer to the expected bytes of the window.
+ * @param mask Pointer to the per-byte comparison mask of the window.
+ * @param len The window length in bytes.
+ * @return true if every unmasked byte of the text equals the corresponding window byte.
+ */
+inline bool maskedEquals(const char* text, const char* bytes, const char* mask, std::size_t len) {
+    std::size_t i = 0;
+
+#if defined(APP_SIMD_AVX2)
+    for (; i + 32 <= len; i += 32) {
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+        const __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+        const __m256i diff = _mm256_and_si256(_mm256_xor_si256(t, b), m);
+        if (!_mm256_testz_si256(diff, diff)) {
+            return false;
+        }
+    }
+#endif
+
+#if defined(APP_SIMD_SSE2)
+    for (; i + 16 <= len; i += 16) {
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+        const __m128i diff = _mm_and_si128(_mm_xor_si128(t, b), m);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif
+
+    // Portable word-at-a-time path for targets without vector support and for the tail
+    for (; i + 8 <= len; i += 8) {
+        std::uint64_t t, b, m;
+        std::memcpy(&t, text + i, sizeof(t));
+        std::memcpy(&b, bytes + i, sizeof(b));
+        std::memcpy(&m, mask + i, sizeof(m));
+        if (((t ^ b) & m) != 0) {
+            return false;
+        }
+    }
+    for (; i < len; ++i) {
+        if (((text[i] ^ bytes[i]) & mask[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Compares `len` bytes of the text against a lower-case literal, ignoring ASCII case.
+ *
+ * Upper-case letters of the text are folded on the fly: a signed compare after adding
+ * `0x80 - 'A'` selects the bytes in 'A'..'Z', and OR-ing 0x20 into exactly those bytes maps them
+ * onto lower case. Other bytes, including those of the pattern, are compared unchanged, and the
+ * text is never copied.
+ *
+ * @param text Pointer to the text; at least `len` bytes must be readable.
+ * @param lower Pointer to the literal, whose letters are all in lower case.
+ * @param len The literal length in bytes.
+ * @return true if the text equals the literal up to the case of its letters.
+ */
+inline bool foldedEquals(const char* text, const char* lower, std::size_t len) {
+    std::size_t i = 0;
+
+#if defined(APP_SIMD_AVX2)
+    const __m256i shift32 = _mm256_set1_epi8(static_cast<char>(0x80 - 'A'));
+    const __m256i bound32 = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+    const __m256i fold32 = _mm256_set1_epi8(0x20);
+    for (; i + 32 <= len; i += 32) {
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lower + i));
+        const __m256i upper = _mm256_cmpgt_epi8(bound32, _mm256_add_epi8(t, shift32));
+        const __m256i folded = _mm256_or_si256(t, _mm256_and_si256(upper, fold32));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, l)) != -1) {
+            return false;
+        }
+    }
+#endif
+
+#if defined(APP_SIMD_SSE2)
+    const __m128i shift = _mm_set1_epi8(static_cast<char>(0x80 - 'A'));
+    const __m128i bound = _mm_set1_epi8(static_cast<char>(-128 + 26));
+    const __m128i fold = _mm_set1_epi8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower + i));
+        const __m128i upper = _mm_cmplt_epi8(_mm_add_epi8(t, shift), bound);
+        const __m128i folded = _mm_or_si128(t, _mm_and_si128(upper, fold));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(folded, l)) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif
+
+    for (; i < len; ++i) {
+        const bool upper = text[i] >= 'A' && text[i] <= 'Z';
+        if ((upper ? static_cast<char>(text[i] | 0x20) : text[i]) != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the first byte in `text[0, n)` that equals a lower-case letter in either case.
+ *
+ * Setting bit 0x20 maps an upper-case ASCII letter onto its lower-case form, so one OR and one
+ * compare per block test both cases at once.
+ *
+ * @param text Pointer to the text.
+ * @param n The number of bytes to scan.
+ * @param lower The lower-case letter to look for.
+ * @return Pointer to the first matching byte, or nullptr if there is none.
+ */
+inline const char* findFoldedByte(const char* text, std::size_t n, char lower) {
+    std::size_t i = 0;
+
+#if defined(APP_SIMD_SSE2)
+    const __m128i fold = _mm_set1_epi8(0x20);
+    const __m128i target = _mm_set1_epi8(lower);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        const int hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(t, fold), target));
+        if (hits != 0) {
+            return text + i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(hits)));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if ((text[i] | 0x20) == lower) {
+            return text + i;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Finds the leftmost occurrence of a masked window in the text at or after `pos`.
+ *
+ * Candidates are located with `memchr` on the first exact byte of the window (or with
+ * findFoldedByte() on its first case-folded letter if there is no exact byte) and then verified
+ * with a full masked comparison. The window must contain at least one byte that is not a wildcard.
+ *
+ * @param text Pointer to the text.
+ * @param m The length of the text.
+ * @param pos The index at which the search starts; must not exceed `m`.
+ * @param bytes Pointer to the expected bytes of the window.
+ * @param mask Pointer to the per-byte comparison mask of the window.
+ * @param len The window length in bytes.
+ * @return The start index of the occurrence, or `static_cast<std::size_t>(-1)` if there is none.
+ */
+inline std::size_t findMaskedWindow(const char* text, std::size_t m, std::size_t pos,
+                                    const char* bytes, const char* mask, std::size_t len) {
+    constexpr std::size_t not_found = static_cast<std::size_t>(-1);
+    const void* exact = std::memchr(mask, '\xFF', len);
+    const void* first = exact != nullptr ? exact : std::memchr(mask, '\xDF', len);
+    const std::size_t anchor = static_cast<std::size_t>(static_cast<const char*>(first) - mask);
+    const char anchor_byte = bytes[anchor];
+
+    for (std::size_t start = pos; m - start >= len;) {
+        const char* from = text + start + anchor;
+        const void* hit = exact != nullptr ? std::memchr(from, anchor_byte, m - start - len + 1)
+                                           : findFoldedByte(from, m - start - len + 1, anchor_byte);
+        if (hit == nullptr) {
+            return not_found;
+        }
+        start = static_cast<std::size_t>(static_cast<const char*>(hit) - text) - anchor;
+        if (maskedEquals(text + start, bytes, mask, len)) {
+            return start;
+        }
+        ++start;
+    }
+    return not_found;
+}
+
+/**
+ * @brief A set of byte values laid out for findByteInClass().
+ *
+ * The 256-bit membership bitmap is transposed into two 16-entry tables indexed by the low nibble of
+ * a byte: bit k of `low[n]` is set if byte `k << 4 | n` is a member, and `high[n]` holds the same
+ * for the bytes from 0x80 up. A vector byte shuffle then looks up 16 or 32 text bytes at once.
+ */
+struct ByteClassTable {
+    alignas(16) std::uint8_t low[16] = {};
+    alignas(16) std::uint8_t high[16] = {};
+    std::uint64_t bits[4] = {};  // The membership bitmap, for the scalar path.
+
+    /**
+     * @brief Builds the table of a byte set.
+     * @param class_bits The set as a 256-bit bitmap, byte `c` being bit `c % 64` of word `c / 64`.
+     * @return The table.
+     */
+    static ByteClassTable build(const std::uint64_t* class_bits) {
+        ByteClassTable table;
+        for (unsigned c = 0; c < 256; ++c) {
+            if (((class_bits[c >> 6] >> (c & 63)) & 1) != 0) {
+                table.bits[c >> 6] |= std::uint64_t{1} << (c & 63);
+                std::uint8_t* row = c < 0x80 ? table.low : table.high;
+                row[c & 0x0F] = static_cast<std::uint8_t>(row[c & 0x0F] | (1u << ((c >> 4) & 7)));
+            }
+        }
+        return table;
+    }
+
+    /**
+     * @brief Returns true if a byte is a member of the set.
+     */
+    bool contains(unsigned char c) const { return ((bits[c >> 6] >> (c & 63)) & 1) != 0; }
+};
+
+/**
+ * @brief Finds the first byte of the text at or after `pos` that belongs to a byte set.
+ *
+ * With SSSE3 each block of 16 (AVX2: 32) bytes is classified with three byte shuffles: the low
+ * nibble selects an entry of the table for the byte's half of the range, and the high nibble
+ * selects the bit within that entry. Without SSSE3 the bitmap is tested byte by byte.
+ *
+ * @param text Pointer to the text.
+ * @param m The length of the text.
+ * @param pos The index at which the search starts; must not exceed `m`.
+ * @param table The byte set.
+ * @return The index of the byte, or `static_cast<std::size_t>(-1)` if there is none.
+ */
+inline std::size_t findByteInClass(const char* text, std::size_t m, std::size_t pos,
+                                   const ByteClassTable& table) {
+    constexpr std::size_t not_found = static_cast<std::size_t>(-1);
+    std::size_t i = pos;
+
+#if defined(APP_SIMD_AVX2)
+    {
+        const __m256i low_rows = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(table.low)));
+        const __m256i high_rows = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(table.high)));
+        const __m256i bit_of_nibble = _mm256_broadcastsi128_si256(
+            _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+        const __m256i row_index = _mm256_set1_epi8(static_cast<char>(0x8F));
+        const __m256i top_bit = _mm256_set1_epi8(static_cast<char>(0x80));
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        for (; i + 32 <= m; i += 32) {
+            const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+            // An index with its top bit set makes the shuffle return 0, which selects the half
+            const __m256i rows = _mm256_or_si256(
+                _mm256_shuffle_epi8(low_rows, _mm256_and_si256(t, row_index)),
+                _mm256_shuffle_epi8(high_rows,
+                                    _mm256_and_si256(_mm256_xor_si256(t, top_bit), row_index)));
+            const __m256i bits = _mm256_shuffle_epi8(
+                bit_of_nibble, _mm256_and_si256(_mm256_srli_epi16(t, 4), nibble));
+            const __m256i misses =
+                _mm256_cmpeq_epi8(_mm256_and_si256(rows, bits), _mm256_setzero_si256());
+            const auto hits = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(misses));
+            if (hits != 0) {
+                return i + static_cast<std::size_t>(std::countr_zero(hits));
+            }
+        }
+    }
+#endif
+
+#if defined(APP_SIMD_SSSE3)
+    {
+        const __m128i low_rows = _mm_load_si128(reinterpret_cast<const __m128i*>(table.low));
+        const __m128i high_rows = _mm_load_si128(reinterpret_cast<const __m128i*>(table.high));
+        const __m128i bit_of_nibble =
+            _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const __m128i row_index = _mm_set1_epi8(static_cast<char>(0x8F));
+        const __m128i top_bit = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        for (; i + 16 <= m; i += 16) {
+            const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            const __m128i rows = _mm_or_si128(
+                _mm_shuffle_epi8(low_rows, _mm_and_si128(t, row_index)),
+                _mm_shuffle_epi8(high_rows, _mm_and_si128(_mm_xor_si128(t, top_bit), row_index)));
+            const __m128i bits =
+                _mm_shuffle_epi8(bit_of_nibble, _mm_and_si128(_mm_srli_epi16(t, 4), nibble));
+            const __m128i misses = _mm_cmpeq_epi8(_mm_and_si128(rows, bits), _mm_setzero_si128());
+            const int hits = ~_mm_movemask_epi8(misses) & 0xFFFF;
+            if (hits != 0) {
+                return i + static_cast<std::size_t>(std::countr_zero(static_cast<unsigned>(hits)));
+            }
+        }
+    }
+#endif
+
+    for (; i < m; ++i) {
+        if (table.contains(static_cast<unsigned char>(text[i]))) {
+            return i;
+        }
+    }
+    return not_found;
+}
+
+/**
+ * @brief Finds the first byte above 0x7F in `text[0, n)`.
+ * @return Its index, or `static_cast<std::size_t>(-1)` if the text is pure ASCII.
+ */
+inline std::size_t findNonAscii(const char* text, std::size_t n) {
+    std::size_t i = 0;
+
+#if defined(APP_SIMD_AVX2)
+    for (; i + 32 <= n; i += 32) {
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        const auto high = static_cast<unsigned>(_mm256_movemask_epi8(t));
+        if (high != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(high));
+        }
+    }
+#endif
+
+#if defined(APP_SIMD_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        const auto high = static_cast<unsigned>(_mm_movemask_epi8(t));
+        if (high != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(high));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (static_cast<unsigned char>(text[i]) > 0x7F) {
+            return i;
+        }
+    }
+    return static_cast<std::size_t>(-1);
+}
+
+/**
+ * @brief The outcome of validateUtf8().
+ */
+struct Utf8Validation {
+    std::size_t error = static_cast<std::size_t>(-1);  // Start of the first invalid sequence.
+    bool ascii = true;                                 // The text has no byte above 0x7F.
+
+    bool valid() const { return error == static_cast<std::size_t>(-1); }
+};
+
+/**
+ * @brief [private] Validates UTF-8 one code point at a time from `pos`, skipping ASCII runs with
+ * findNonAscii(). Rejects overlong forms, surrogates, code points above U+10FFFF and truncated
+ * sequences.
+ * @return The start of the first invalid sequence, or `static_cast<std::size_t>(-1)`.
+ */
+inline std::size_t findInvalidUtf8Scalar(const char* text, std::size_t n, std::size_t pos) {
+    constexpr std::size_t none = static_cast<std::size_t>(-1);
+    const auto byte = [&](std::size_t k) { return static_cast<unsigned char>(text[k]); };
+    const auto continuation = [&](std::size_t k) { return k < n && (byte(k) & 0xC0) == 0x80; };
+
+    std::size_t i = pos;
+    while (i < n) {
+        const unsigned char lead = byte(i);
+        if (lead < 0x80) {
+            const std::size_t skip = findNonAscii(text + i, n - i);
+            if (skip == none) {
+                return none;
+            }
+            i += skip;
+            continue;
+        }
+        std::size_t length = 0;
+        unsigned char low = 0x80;  // Allowed range of the second byte
+        unsigned char high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            low = lead == 0xE0 ? 0xA0 : 0x80;   // Overlong
+            high = lead == 0xED ? 0x9F : 0xBF;  // Surrogates
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            low = lead == 0xF0 ? 0x90 : 0x80;   // Overlong
+            high = lead == 0xF4 ? 0x8F : 0xBF;  // Above U+10FFFF
+        } else {
+            return i;
+        }
+        if (i + 1 >= n || byte(i + 1) < low || byte(i + 1) > high) {
+            return i;
+        }
+        for (std::size_t k = 2; k < length; ++k) {
+            if (!continuation(i + k)) {
+                return i;
+            }
+        }
+        i += length;
+    }
+    return none;
+}
+
+/**
+ * @brief Validates that a text is well-formed UTF-8 and reports whether it is pure ASCII.
+ *
+ * Leading ASCII is skipped with findNonAscii(). With SSSE3 the rest is checked 16 bytes at a time
+ * with the lookup algorithm of Keiser and Lemire: three `pshufb` table lookups on the high and low
+ * nibbles of each byte and of the byte before it classify every two-byte window, and saturating
+ * subtractions check that the lead bytes of three- and four-byte sequences are followed by enough
+ * continuation bytes. Blocks without a byte above 0x7F only check for a sequence left open by the
+ * previous block. On the first failing block, and for the tail, the scalar validator takes over
+ * from the start of the sequence spanning the block boundary to locate the error exactly.
+ *
+ * @param text Pointer to the text.
+ * @param n The length of the text.
+ * @return The position of the first invalid sequence, if any, and whether the text is ASCII.
+ */
+inline Utf8Validation validateUtf8(const char* text, std::size_t n) {
+    constexpr std::size_t none = static_cast<std::size_t>(-1);
+    Utf8Validation result;
+    const std::size_t first = findNonAscii(text, n);
+    if (first == none) {
+        return result;
+    }
+    result.ascii = false;
+    std::size_t i = first;
+
+#if defined(APP_SIMD_SSSE3)
+    // Error bits of a two-byte window; the names give the offending bit patterns
+    constexpr char too_short = 1 << 0;   // 11______ 0_______ or 11______ 11______
+    constexpr char too_long = 1 << 1;    // 0_______ 10______
+    constexpr char overlong_3 = 1 << 2;  // 11100000 100_____
+    constexpr char too_large = 1 << 3;   // 11110100 1001____ and above
+    constexpr char surrogate = 1 << 4;   // 11101101 101_____
+    constexpr char overlong_2 = 1 << 5;  // 1100000_ 10______
+    constexpr char too_large_1000 = 1 << 6;  // 11110101 1000____ and above
+    constexpr char overlong_4 = 1 << 6;      // 11110000 1000____
+    constexpr char two_conts = static_cast<char>(1 << 7);  // 10______ 10______
+    constexpr char carry = too_short | too_long | two_conts;
+
+    const __m128i byte_1_high_table = _mm_setr_epi8(
+        too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long, two_conts,
+        two_conts, two_conts, two_conts, too_short | overlong_2, too_short,
+        too_short | overlong_3 | surrogate, too_short | too_large | too_large_1000 | overlong_4);
+    const __m128i byte_1_low_table = _mm_setr_epi8(
+        carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+        carry | too_large, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000 | surrogate, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000);
+    const __m128i byte_2_high_table = _mm_setr_epi8(
+        too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large, too_short, too_short,
+        too_short, too_short);
+    // A lead byte this close to the end of a block needs continuation bytes from the next one
+    const __m128i incomplete_limit =
+        _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xEF),
+                      static_cast<char>(0xDF), static_cast<char>(0xBF));
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+    const auto high_nibbles = [&](__m128i v) {
+        return _mm_and_si128(_mm_srli_epi16(v, 4), low_nibble);
+    };
+
+    // `first` starts a sequence and only ASCII precedes it, so the previous block is all zeros
+    __m128i previous = _mm_setzero_si128();
+    __m128i previous_incomplete = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i error = previous_incomplete;
+        if (_mm_movemask_epi8(input) != 0) {
+            const __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+            const __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, high_nibbles(prev1));
+            const __m128i byte_1_low =
+                _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, low_nibble));
+            const __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, high_nibbles(input));
+            const __m128i special_cases =
+                _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+            const __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, previous, 14),
+                                                _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            const __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, previous, 13),
+                                                 _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            const __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth),
+                                                        _mm_set1_epi8(static_cast<char>(0x80)));
+            error = _mm_xor_si128(must_continue, special_cases);
+            previous_incomplete = _mm_subs_epu8(input, incomplete_limit);
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF) {
+            break;
+        }
+        previous = input;
+    }
+#endif
+
+    // Restart at the lead byte of a sequence that may reach into the remaining bytes
+    std::size_t restart = i;
+    for (std::size_t k = i; k > first && i - k < 3;) {
+        const auto c = static_cast<unsigned char>(text[--k]);
+        if (c >= 0xC0) {
+            restart = k;
+        }
+        if (c < 0x80 || c >= 0xC0) {
+            break;
+        }
+    }
+    result.error = findInvalidUtf8Scalar(text, n, restart);
+    return result;
+}
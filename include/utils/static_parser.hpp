@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/parser.hpp"
+
+/**
+ * @brief A string literal usable as a non-type template parameter, e.g. `StaticMatcher<"*.log">`.
+ */
+template <std::size_t N>
+struct FixedString {
+    char data[N]{};
+
+    constexpr FixedString(const char (&str)[N]) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data[i] = str[i];
+        }
+    }
+
+    constexpr std::size_t size() const { return N - 1; }
+    constexpr std::string_view view() const { return {data, N - 1}; }
+};
+
+/**
+ * @brief A token whose literal bytes live in the literal buffer of a StaticParseResult.
+ */
+struct StaticToken {
+    TokenType type = TokenType::LITERAL_SEQUENCE;
+    std::size_t offset = 0;  // Start of the literal in `StaticParseResult::literals`.
+    std::size_t length = 0;  // Length of the literal (0 for wildcard tokens).
+};
+
+/**
+ * @brief The allocation-free result of parsing a pattern at compile time.
+ * @tparam Capacity An upper bound for both the token count and the literal length.
+ */
+template <std::size_t Capacity>
+struct StaticParseResult {
+    std::array<StaticToken, Capacity> tokens{};
+    std::size_t token_count = 0;
+    std::array<char, Capacity> literals{};  // Unescaped literal characters of all tokens.
+    std::size_t literal_length = 0;
+
+    /**
+     * @brief Converts the result into the runtime token representation produced by Parser.
+     */
+    std::vector<Token> toTokens() const {
+        std::vector<Token> result;
+        for (std::size_t j = 0; j < token_count; ++j) {
+            const StaticToken& token = tokens[j];
+            if (token.type == TokenType::LITERAL_SEQUENCE) {
+                result.push_back({token.type, std::string(literals.data() + token.offset,
+                                                          token.length)});
+            } else {
+                result.push_back({token.type});
+            }
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Fatal parse issues surfaced as compile errors by StaticParser.
+ *
+ * The functions are deliberately not `constexpr`: calling one during constant evaluation makes the
+ * program ill-formed, and the compiler's diagnostic names the offending IssueCode.
+ */
+struct StaticParseError {
+    static void UNDEFINED_ESCAPE_SEQUENCE() {}
+    static void TRAILING_BACKSLASH() {}
+};
+
+/**
+ * @brief A compile-time counterpart of Parser for patterns known at build time.
+ */
+class StaticParser {
+   public:
+    /**
+     * @brief Parses a pattern during compilation, following exactly the rules of Parser::parse.
+     *
+     * Consecutive '*' are merged as usual. Fatal issues (UNDEFINED_ESCAPE_SEQUENCE and
+     * TRAILING_BACKSLASH) are reported as compile errors instead of ParseEvents.
+     *
+     * @tparam Pattern The pattern string literal.
+     * @return A StaticParseResult holding the tokens and their literal bytes.
+     */
+    template <FixedString Pattern>
+    static consteval auto parse() {
+        constexpr std::string_view p = Pattern.view();
+        StaticParseResult<p.length() + 1> result;
+
+        // The literal currently being built starts at this offset of the literal buffer
+        std::size_t literal_start = 0;
+
+        auto flush_literal_builder = [&]() {
+            if (result.literal_length > literal_start) {
+                result.tokens[result.token_count++] = {TokenType::LITERAL_SEQUENCE, literal_start,
+                                                       result.literal_length - literal_start};
+                literal_start = result.literal_length;
+            }
+        };
+
+        for (std::size_t i = 0; i < p.length(); ++i) {
+            const char current_char = p[i];
+
+            switch (current_char) {
+                case '?':
+                    flush_literal_builder();
+                    result.tokens[result.token_count++] = {TokenType::ANY_CHAR};
+                    break;
+
+                case '*':
+                    flush_literal_builder();
+                    // Merge consecutive '*' by only adding if the previous token wasn't also '*'
+                    if (result.token_count == 0 ||
+                        result.tokens[result.token_count - 1].type != TokenType::ANY_SEQUENCE) {
+                        result.tokens[result.token_count++] = {TokenType::ANY_SEQUENCE};
+                    }
+                    break;
+
+                case '\\':
+                    if (i + 1 >= p.length()) {
+                        StaticParseError::TRAILING_BACKSLASH();
+                    }
+                    if (p[i + 1] != '*' && p[i + 1] != '?' && p[i + 1] != '\\') {
+                        StaticParseError::UNDEFINED_ESCAPE_SEQUENCE();
+                    }
+                    result.literals[result.literal_length++] = p[i + 1];
+                    i++;  // Skip the escaped character
+                    break;
+
+                default:
+                    result.literals[result.literal_length++] = current_char;
+                    break;
+            }
+        }
+
+        flush_literal_builder();
+        return result;
+    }
+};
\ No newline at end of file
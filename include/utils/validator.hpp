@@ -9,6 +9,7 @@
 #include "utils/compiler.hpp"
 #include "utils/issues.hpp"
 #include "utils/parser.hpp"
+#include "utils/simd.hpp"
 
 /**
  * @brief Central authority for all input validation and issue creation.
@@ -32,14 +33,48 @@ class Validator {
         return issues;
     }
 
+    /**
+     * @brief Validates a string for the UTF-8 mode (ParseOptions::utf8), where multi-byte
+     * characters are allowed but must be well-formed.
+     *
+     * The check is vectorized (see validateUtf8()), and pure ASCII input costs a single scan for
+     * bytes above 127.
+     *
+     * @param str The string to validate.
+     * @param ascii If not null, set to true when the string contains only ASCII characters, so a
+     * pattern can be parsed without the UTF-8 mode and run on the usual byte-wise path.
+     * @return A vector with an INVALID_UTF8_SEQUENCE error at the first malformed sequence, if any.
+     */
+    static std::vector<Issue> validateUtf8String(std::string_view str, bool* ascii = nullptr) {
+        const Utf8Validation validation = validateUtf8(str.data(), str.length());
+        if (ascii != nullptr) {
+            *ascii = validation.ascii;
+        }
+        std::vector<Issue> issues;
+        if (!validation.valid()) {
+            issues.push_back(createIssue(IssueCode::INVALID_UTF8_SEQUENCE, validation.error + 1));
+        }
+        return issues;
+    }
+
     /**
      * @brief Interprets events from a ParseResult to generate formal Issues.
      * @param parse_result The result from Parser::parse.
      * @return A vector of all issues (errors and warnings) found during parsing.
      */
     static std::vector<Issue> validateParseResult(const ParseResult& parse_result) {
+        return validateEvents(parse_result.events);
+    }
+
+    /**
+     * @brief Turns events found outside the parser, such as the findings of PerformanceLinter, into
+     * formal Issues.
+     * @param events The events; position 0 refers to the pattern as a whole.
+     * @return A vector of issues, one per event.
+     */
+    static std::vector<Issue> validateEvents(const std::vector<ParseEvent>& events) {
         std::vector<Issue> issues;
-        for (const auto& event : parse_result.events) {
+        for (const auto& event : events) {
             issues.push_back(createIssue(event.code, event.position, event.detail));
         }
         return issues;
@@ -61,6 +96,11 @@ class Validator {
                                      "Input must contain only single-byte ASCII characters; a "
                                      "multi-byte character was found."};
 
+                case IssueCode::INVALID_UTF8_SEQUENCE:
+                    return IssueInfo{IssueType::ERROR,
+                                     "Input is not valid UTF-8; the byte sequence starting here is "
+                                     "truncated, overlong or out of range."};
+
                 case IssueCode::UNDEFINED_ESCAPE_SEQUENCE:
                     return IssueInfo{
                         IssueType::ERROR,
@@ -76,14 +116,82 @@ class Validator {
                     return IssueInfo{IssueType::WARNING,
                                      "Consecutive '*' characters were found and automatically "
                                      "merged into a single '*'."};
+
+                case IssueCode::UNTERMINATED_ALTERNATION:
+                    return IssueInfo{IssueType::ERROR,
+                                     "The '{' opening an alternation has no matching '}'. This is "
+                                     "a fatal error."};
+
+                case IssueCode::UNMATCHED_CLOSING_BRACE:
+                    return IssueInfo{IssueType::ERROR,
+                                     "A '}' was found outside of any alternation; escape it as "
+                                     "'\\}' to match it literally. This is a fatal error."};
+
+                case IssueCode::UNTERMINATED_CHAR_CLASS:
+                    return IssueInfo{IssueType::ERROR,
+                                     "The '[' opening a character class has no matching ']'; "
+                                     "escape it as '\\[' to match it literally. This is a fatal "
+                                     "error."};
+
+                case IssueCode::REVERSED_CHAR_CLASS_RANGE:
+                    return IssueInfo{
+                        IssueType::ERROR,
+                        std::format("Character class range '{}' ends before it starts. This is a "
+                                    "fatal error.",
+                                    detail.value_or(""))};
+
+                case IssueCode::INVALID_HEX_ESCAPE:
+                    return IssueInfo{
+                        IssueType::ERROR,
+                        std::format("Hex escape '\\{}' must be followed by two hexadecimal "
+                                    "digits. This is a fatal error.",
+                                    detail.value_or(""))};
+
+                case IssueCode::MANY_STARS_WITH_SHORT_LITERALS:
+                    return IssueInfo{
+                        IssueType::WARNING,
+                        std::format("Many '*' wildcards separated by literals of at most {} "
+                                    "characters; matching may backtrack over the text repeatedly.",
+                                    detail.value_or(""))};
+
+                case IssueCode::LEADING_STAR_SHORT_LITERAL:
+                    return IssueInfo{
+                        IssueType::WARNING,
+                        std::format("A leading '*' is followed by the short literal '{}', which "
+                                    "may occur throughout the text and slow down the search.",
+                                    detail.value_or(""))};
+
+                case IssueCode::PATTERN_LONGER_THAN_TEXT:
+                    return IssueInfo{
+                        IssueType::WARNING,
+                        std::format("The pattern requires more than {} characters and can never "
+                                    "match a text of the configured size.",
+                                    detail.value_or(""))};
+
+                case IssueCode::PATTERN_TOO_EXPENSIVE:
+                    return IssueInfo{
+                        IssueType::ERROR,
+                        std::format("Pattern exceeds the cost limit with an estimated {}. This is "
+                                    "a fatal error.",
+                                    detail.value_or(""))};
+
+                case IssueCode::ENGINE_DOWNGRADED:
+                    return IssueInfo{
+                        IssueType::WARNING,
+                        std::format("Pattern exceeds the cost limit of the requested engine and "
+                                    "was downgraded from {}.",
+                                    detail.value_or(""))};
             }
             // If the switch is exhaustive (as it should be), this code is unreachable.
             APP_UNREACHABLE();
         }();  // <-- Immediately invoke the lambda
 
-        // Centralized message formatting
+        // Centralized message formatting; position 0 refers to the pattern as a whole
         std::string message =
-            std::format("{} at position {}: {}", issueTypeToString(type), position, message_core);
+            position == 0
+                ? std::format("{} in pattern: {}", issueTypeToString(type), message_core)
+                : std::format("{} at position {}: {}", issueTypeToString(type), position,
+                              message_core);
 
         return {type, code, message};
     }
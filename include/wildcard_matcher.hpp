@@ -1,6 +1,8 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -11,6 +13,8 @@ struct SolverProfile {
     bool result;
     long long time_elapsed_us;
     std::size_t space_used_bytes;
+    // The engine that actually ran the match, set by solvers that delegate (e.g. "auto").
+    std::string_view engine{};
 };
 
 // --- Concept Definition ---
@@ -25,4 +29,16 @@ concept WildcardSolver = requires(std::string_view s, const std::vector<Token>&
 template <WildcardSolver Solver>
 SolverProfile runSolver(std::string_view s, const std::vector<Token>& p_tokens) {
     return Solver::runAndProfile(s, p_tokens);
+}
+
+// --- Binary-Safe Entry Point ---
+// Views raw bytes as a text without copying or validating them. Every engine compares bytes, so
+// embedded NULs and bytes above 0x7F need no special treatment (see ParseOptions::binary).
+inline std::string_view asText(std::span<const std::byte> bytes) {
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+template <WildcardSolver Solver>
+SolverProfile runSolver(std::span<const std::byte> s, const std::vector<Token>& p_tokens) {
+    return Solver::runAndProfile(asText(s), p_tokens);
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include "engine/lint.hpp"
+#include "utils/codegen.hpp"
+#include "utils/parser.hpp"
+#include "utils/validator.hpp"
+
+/**
+ * @brief Prints the issues found in one line of the pattern file.
+ *
+ * @param issues A vector of Issues to print.
+ * @param line_number The 1-based line number of the pattern in the input file.
+ * @return True if any fatal errors were found, otherwise false.
+ */
+static bool printIssues(const std::vector<Issue>& issues, size_t line_number) {
+    bool has_error = false;
+    for (const auto& issue : issues) {
+        std::cerr << "line " << line_number << ": " << issue.message << std::endl;
+        has_error = has_error || issue.isError();
+    }
+    return has_error;
+}
+
+/**
+ * @brief Writes a string to a file, reporting failures on std::cerr.
+ * @return True on success, otherwise false.
+ */
+static bool writeFile(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file || !(file << content)) {
+        std::cerr << "Error: Cannot write '" << path << "'." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // --- Command-Line Argument Parsing Setup with cxxopts ---
+    cxxopts::Options options(
+        "wildcard_codegen",
+        "Compiles a file of wildcard patterns (one per line) into C++ source code with one\n"
+        "specialized matching function per pattern and a dispatch table.");
+
+    options.add_options()("h,help", "Show this help message and exit.")(
+        "i,input", "The pattern file to read.", cxxopts::value<std::string>())(
+        "o,output", "The C++ source file to write.", cxxopts::value<std::string>())(
+        "header", "The C++ header file to write.", cxxopts::value<std::string>())(
+        "include", "How the source includes the header (defaults to the header file name).",
+        cxxopts::value<std::string>())("namespace", "The namespace of the generated code.",
+                                       cxxopts::value<std::string>()->default_value(
+                                           "wildcard_patterns"));
+
+    cxxopts::ParseResult result;
+    try {
+        result = options.parse(argc, argv);
+    } catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl << std::endl;
+        std::cout << options.help() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (result.count("help")) {
+        std::cout << options.help() << std::endl;
+        return EXIT_SUCCESS;
+    }
+    if (!result.count("input") || !result.count("output") || !result.count("header")) {
+        std::cerr << "Error: --input, --output and --header are required." << std::endl
+                  << std::endl;
+        std::cout << options.help() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string input_path = result["input"].as<std::string>();
+    const std::string header_path = result["header"].as<std::string>();
+
+    CodegenOptions codegen_options;
+    codegen_options.name_space = result["namespace"].as<std::string>();
+    codegen_options.header_include =
+        result.count("include") ? result["include"].as<std::string>()
+                                : header_path.substr(header_path.find_last_of("/\\") + 1);
+
+    // --- Read, Validate and Parse Every Pattern ---
+    std::ifstream input(input_path, std::ios::binary);
+    if (!input) {
+        std::cerr << "Error: Cannot read '" << input_path << "'." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<PatternDefinition> definitions;
+    bool has_error = false;
+    std::string line;
+    for (size_t line_number = 1; std::getline(input, line); ++line_number) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();  // Accept files with Windows line endings
+        }
+        if (line.empty()) {
+            continue;  // Skip blank lines
+        }
+
+        if (printIssues(Validator::validateRawString(line), line_number)) {
+            has_error = true;
+            continue;
+        }
+        ParseResult parse_result = Parser::parse(line);
+        if (printIssues(Validator::validateParseResult(parse_result), line_number)) {
+            has_error = true;
+            continue;
+        }
+        printIssues(PerformanceLinter::lintPerformance(parse_result), line_number);
+        definitions.push_back({line, std::move(parse_result.tokens)});
+    }
+    if (has_error) {
+        return EXIT_FAILURE;
+    }
+
+    // --- Emit the Generated Code ---
+    if (!writeFile(header_path, CodeGenerator::generateHeader(codegen_options)) ||
+        !writeFile(result["output"].as<std::string>(),
+                   CodeGenerator::generateSource(definitions, codegen_options))) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Generated " << definitions.size() << " pattern(s)." << std::endl;
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -7,9 +7,14 @@
 
 #include <cxxopts.hpp>
 
+#include "engine/lint.hpp"
+#include "solvers/auto.hpp"
+#include "solvers/bytecode.hpp"
 #include "solvers/dp.hpp"
 #include "solvers/greedy.hpp"
+#include "solvers/jit.hpp"
 #include "solvers/memo.hpp"
+#include "solvers/nfa.hpp"
 #include "solvers/recursive.hpp"
 #include "utils/parser.hpp"
 #include "utils/validator.hpp"
@@ -28,6 +33,9 @@ struct SolverInfo {
 
 // Use a static map to act as a central "Solver Registry"
 const static std::map<std::string, SolverInfo> solver_registry = {
+    {"auto",
+     {"Automatic Selection", "Picks an engine from the pattern shape and text length (default).",
+      [](const auto& s, const auto& p_tokens) { return runSolver<AutoSolver>(s, p_tokens); }}},
     {"recursive",
      {"Recursive Backtracking", "Recursive backtracking algorithm.",
       [](const auto& s, const auto& p_tokens) { return runSolver<RecursiveSolver>(s, p_tokens); }}},
@@ -38,8 +46,17 @@ const static std::map<std::string, SolverInfo> solver_registry = {
      {"Dynamic Programming", "Dynamic programming algorithm.",
       [](const auto& s, const auto& p_tokens) { return runSolver<DpSolver>(s, p_tokens); }}},
     {"greedy",
-     {"Greedy Two-Pointer", "Two-pointer greedy algorithm (default).",
-      [](const auto& s, const auto& p_tokens) { return runSolver<GreedySolver>(s, p_tokens); }}}};
+     {"Greedy Two-Pointer", "Two-pointer greedy algorithm.",
+      [](const auto& s, const auto& p_tokens) { return runSolver<GreedySolver>(s, p_tokens); }}},
+    {"bytecode",
+     {"Bytecode Interpreter", "Compiled bytecode on a threaded interpreter.",
+      [](const auto& s, const auto& p_tokens) { return runSolver<BytecodeSolver>(s, p_tokens); }}},
+    {"jit",
+     {"JIT Compiler", "Native x86-64 code generated at runtime.",
+      [](const auto& s, const auto& p_tokens) { return runSolver<JitSolver>(s, p_tokens); }}},
+    {"nfa",
+     {"Position Automaton", "Bit-parallel NFA; the only solver for dialect features.",
+      [](const auto& s, const auto& p_tokens) { return runSolver<NfaSolver>(s, p_tokens); }}}};
 
 /**
  * @brief Processes a list of issues, printing them and identifying if fatal errors exist.
@@ -104,7 +121,13 @@ int main(int argc, char* argv[]) {
         "s,solver",
         "Specify the solver algorithm. <arg> must be one of the names listed in 'Available "
         "solvers'.",
-        cxxopts::value<std::string>()->default_value("greedy"));
+        cxxopts::value<std::string>()->default_value("auto"))(
+        "braces", "Enable brace alternation, e.g. '*.{jpg,png}'.")(
+        "classes", "Enable character classes, e.g. 'IMG_[0-9][!a-z]*'.")(
+        "i,ignore-case", "Match the ASCII letters of literals regardless of case.")(
+        "utf8", "Accept UTF-8 input; '?' then matches one code point.")(
+        "binary", "Match raw bytes without validating the input; '\\xHH' escapes any byte.")(
+        "path", "Match paths: '*' and '?' stay within a segment and '**' spans segments.");
 
     // Helper lambda to print usage information consistently.
     auto print_usage = [&options]() {
@@ -152,8 +175,15 @@ int main(int argc, char* argv[]) {
         return EXIT_FAILURE;  // Exit on stream error/closure.
     }
 
-    // Perform fundamental validation (e.g., for multi-byte characters).
-    if (processAndPrintIssues(Validator::validateRawString(s), "in the text string")) {
+    // Perform fundamental validation (e.g., for multi-byte characters). In UTF-8 mode an ASCII
+    // text keeps the byte-wise '?', so it runs exactly as without the mode. Binary mode trusts its
+    // input and skips validation altogether.
+    const bool binary = result.count("binary") > 0;
+    const bool utf8 = !binary && result.count("utf8") > 0;
+    bool ascii_text = true;
+    if (!binary && processAndPrintIssues(utf8 ? Validator::validateUtf8String(s, &ascii_text)
+                                              : Validator::validateRawString(s),
+                                         "in the text string")) {
         return EXIT_FAILURE;
     }
 
@@ -165,12 +195,22 @@ int main(int argc, char* argv[]) {
     }
 
     // Perform the same fundamental validation on the pattern string.
-    if (processAndPrintIssues(Validator::validateRawString(p), "in the pattern string")) {
+    if (!binary &&
+        processAndPrintIssues(
+            utf8 ? Validator::validateUtf8String(p) : Validator::validateRawString(p),
+            "in the pattern string")) {
         return EXIT_FAILURE;
     }
 
     // --- Parse the Pattern and Validate its Structure ---
-    ParseResult parse_result = Parser::parse(p);
+    ParseOptions parse_options;
+    parse_options.alternation = result.count("braces") > 0;
+    parse_options.char_classes = result.count("classes") > 0;
+    parse_options.case_insensitive = result.count("ignore-case") > 0;
+    parse_options.utf8 = utf8 && !ascii_text;
+    parse_options.binary = binary;
+    parse_options.path = result.count("path") > 0;
+    ParseResult parse_result = Parser::parse(p, parse_options);
     auto parse_issues = Validator::validateParseResult(parse_result);
 
     // Process any warnings (e.g., merged asterisks) or fatal errors (e.g., bad escape sequence).
@@ -178,6 +218,22 @@ int main(int argc, char* argv[]) {
         return EXIT_FAILURE;
     }
 
+    // Dialect tokens only run on the automaton; refuse a solver that was chosen explicitly for
+    // another engine instead of silently running on a different one.
+    if (usesDialectTokens(parse_result.tokens) && solver_choice != "nfa" &&
+        solver_choice != "auto") {
+        std::cerr << "Error: The '" << solver_choice
+                  << "' solver does not run dialect patterns; use --solver nfa or auto."
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Point out patterns that are valid but likely to be slow on this text (warnings only).
+    LintOptions lint_options;
+    lint_options.max_text_length = s.length();
+    processAndPrintIssues(PerformanceLinter::lintPerformance(parse_result, lint_options),
+                          "in the pattern's performance");
+
     // --- Run the selected solver ---
     SolverProfile profile = selected_solver_info.run_function(s, parse_result.tokens);
 
@@ -187,6 +243,9 @@ int main(int argc, char* argv[]) {
 
     std::cout << "Performance Metrics:" << std::endl;
     std::cout << "  - Solver Used: " << selected_solver_info.fullname << std::endl;
+    if (!profile.engine.empty()) {
+        std::cout << "  - Engine Selected: " << profile.engine << std::endl;
+    }
     std::cout << "  - Execution Time: " << profile.time_elapsed_us << " us" << std::endl;
     std::cout << "  - Extra Space: " << profile.space_used_bytes << " bytes" << std::endl;
 
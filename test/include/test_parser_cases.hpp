@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "utils/parser.hpp"
@@ -11,8 +12,50 @@ struct ParserTestCase {
     std::string_view pattern;
     ParseResult expected_result;
     std::string description;
+    ParseOptions options = {};
 };
 
+// Shorthands for the tokens of the dialect test cases.
+inline Token literal(std::string value) { return {TokenType::LITERAL_SEQUENCE, std::move(value)}; }
+inline Token alternation(std::vector<std::vector<Token>> alternatives) {
+    return {TokenType::ALTERNATION, std::nullopt, std::move(alternatives)};
+}
+inline Token charClass(std::vector<std::pair<char, char>> ranges, bool negated = false) {
+    Token token = {TokenType::CHAR_CLASS};
+    for (const auto& [first, last] : ranges) {
+        token.char_class.addRange(static_cast<unsigned char>(first),
+                                  static_cast<unsigned char>(last));
+    }
+    if (negated) {
+        token.char_class.invert();
+    }
+    return token;
+}
+inline Token folded(std::string value) {
+    Token token = literal(std::move(value));
+    token.fold_case = true;
+    return token;
+}
+// The token of '?' in UTF-8 mode: a lead byte followed by the continuation bytes it announces.
+inline Token anyCodePoint() {
+    const Token continuation = charClass({{'\x80', '\xBF'}});
+    return alternation({{charClass({{'\x00', '\x7F'}})},
+                        {charClass({{'\xC0', '\xDF'}}), continuation},
+                        {charClass({{'\xE0', '\xEF'}}), continuation, continuation},
+                        {charClass({{'\xF0', '\xF7'}}), continuation, continuation, continuation}});
+}
+// The tokens of path mode: '*', a '**' segment and classes (including '?') without '/'.
+inline Token segmentStar() { return {TokenType::SEGMENT_SEQUENCE}; }
+inline Token anySegments() { return {TokenType::ANY_SEGMENTS}; }
+inline Token withoutSlash(Token char_class) {
+    char_class.char_class.remove('/');
+    return char_class;
+}
+const ParseOptions braces = {.alternation = true};
+const ParseOptions classes = {.char_classes = true};
+const ParseOptions ignore_case = {.case_insensitive = true};
+const ParseOptions paths = {.path = true};
+
 // A vector containing all test cases for the parser.
 const std::vector<ParserTestCase> parser_test_cases = {
     {"", {{}, {}}, "Empty_pattern_should_result_in_no_tokens_or_events"},
@@ -60,4 +103,181 @@ const std::vector<ParserTestCase> parser_test_cases = {
        {TokenType::LITERAL_SEQUENCE, "d"}},
       {{IssueCode::CONSECUTIVE_ASTERISKS_MERGED, 9, std::nullopt},
        {IssueCode::TRAILING_BACKSLASH, 11, std::nullopt}}},
-     "Complex_pattern_with_multiple_wildcards_escapes_and_events"}};
\ No newline at end of file
+     "Complex_pattern_with_multiple_wildcards_escapes_and_events"},
+
+    // --- Brace alternation (ParseOptions::alternation) ---
+    {"*.{jpg,png}",
+     {{{TokenType::ANY_SEQUENCE}, literal(".{jpg,png}")}, {}},
+     "Braces_are_literal_by_default"},
+    {"*.{jpg,png,gif}",
+     {{{TokenType::ANY_SEQUENCE},
+       literal("."),
+       alternation({{literal("jpg")}, {literal("png")}, {literal("gif")}})},
+      {}},
+     "Alternation_of_extensions",
+     braces},
+    {"{x.jpg,x.jpeg,x.png}",
+     {{literal("x."),
+       alternation({{literal("jp"), alternation({{}, {literal("e")}})}, {literal("pn")}}),
+       literal("g")},
+      {}},
+     "Alternatives_share_prefixes_and_suffixes",
+     braces},
+    {"a{b}c{d,d}",
+     {{literal("abcd")}, {}},
+     "Single_and_duplicate_alternatives_are_inlined",
+     braces},
+    {"{a{b,c},d}",
+     {{alternation({{literal("a"), alternation({{literal("b")}, {literal("c")}})},
+                    {literal("d")}})},
+      {}},
+     "Nested_alternations",
+     braces},
+    {"{*.txt,*.log}",
+     {{{TokenType::ANY_SEQUENCE}, literal("."), alternation({{literal("txt")}, {literal("log")}})},
+      {}},
+     "Alternatives_share_leading_wildcards",
+     braces},
+    {"a,b\\{\\,\\}",
+     {{literal("a,b{,}")}, {}},
+     "Commas_outside_braces_and_escaped_braces_are_literal",
+     braces},
+    {"a{b,c",
+     {{literal("a"), alternation({{literal("b")}, {literal("c")}})},
+      {{IssueCode::UNTERMINATED_ALTERNATION, 2, std::nullopt}}},
+     "Unterminated_alternation_should_produce_an_event",
+     braces},
+    {"a}b",
+     {{literal("a}b")}, {{IssueCode::UNMATCHED_CLOSING_BRACE, 2, std::nullopt}}},
+     "Unmatched_closing_brace_should_produce_an_event",
+     braces},
+
+    // --- Character classes (ParseOptions::char_classes) ---
+    {"[a-z]", {{literal("[a-z]")}, {}}, "Brackets_are_literal_by_default"},
+    {"IMG_[0-9]*",
+     {{literal("IMG_"), charClass({{'0', '9'}}), {TokenType::ANY_SEQUENCE}}, {}},
+     "Class_with_a_range",
+     classes},
+    {"[a-cx][!a-c][^a-c]",
+     {{charClass({{'a', 'c'}, {'x', 'x'}}),
+       charClass({{'a', 'c'}}, true),
+       charClass({{'a', 'c'}}, true)},
+      {}},
+     "Negated_classes_with_exclamation_mark_or_caret",
+     classes},
+    {"[]a][-a][a-]",
+     {{charClass({{']', ']'}, {'a', 'a'}}),
+       charClass({{'-', '-'}, {'a', 'a'}}),
+       charClass({{'-', '-'}, {'a', 'a'}})},
+      {}},
+     "Leading_bracket_and_outer_dashes_are_members",
+     classes},
+    {"[\\]\\\\\\-]\\[x\\]",
+     {{charClass({{']', ']'}, {'\\', '\\'}, {'-', '-'}}), literal("[x]")}, {}},
+     "Escapes_inside_and_outside_classes",
+     classes},
+    {"[a\\n]",
+     {{charClass({{'a', 'a'}, {'n', 'n'}})}, {{IssueCode::UNDEFINED_ESCAPE_SEQUENCE, 3, "n"}}},
+     "Undefined_escape_inside_a_class_should_produce_an_event",
+     classes},
+    {"a[b\\n",
+     {{literal("a[bn")},
+      {{IssueCode::UNTERMINATED_CHAR_CLASS, 2, std::nullopt},
+       {IssueCode::UNDEFINED_ESCAPE_SEQUENCE, 4, "n"}}},
+     "Unterminated_class_should_produce_an_event",
+     classes},
+    {"x[z-a]",
+     {{literal("x"), charClass({})}, {{IssueCode::REVERSED_CHAR_CLASS_RANGE, 3, "z-a"}}},
+     "Reversed_range_should_produce_an_event",
+     classes},
+    {"*.{[jJ]pg,png}",
+     {{{TokenType::ANY_SEQUENCE},
+       literal("."),
+       alternation({{charClass({{'J', 'J'}, {'j', 'j'}}), literal("p")}, {literal("pn")}}),
+       literal("g")},
+      {}},
+     "Classes_inside_alternatives",
+     {.alternation = true, .char_classes = true}},
+
+    // --- Case-insensitive literals (ParseOptions::case_insensitive) ---
+    {"Read*ME.md",
+     {{folded("read"), {TokenType::ANY_SEQUENCE}, folded("me.md")}, {}},
+     "Letters_are_lowered_and_folded",
+     ignore_case},
+    {"2024-?-*.LOG",
+     {{literal("2024-"),
+       {TokenType::ANY_CHAR},
+       literal("-"),
+       {TokenType::ANY_SEQUENCE},
+       folded(".log")},
+      {}},
+     "Literals_without_letters_stay_exact",
+     ignore_case},
+    {"[!a-c]{X1,x2}",
+     {{charClass({{'A', 'C'}, {'a', 'c'}}, true),
+       folded("x"),
+       alternation({{literal("1")}, {literal("2")}})},
+      {}},
+     "Classes_gain_both_cases_and_alternatives_share_a_folded_prefix",
+     {.alternation = true, .char_classes = true, .case_insensitive = true}},
+
+    // --- UTF-8 mode (ParseOptions::utf8) ---
+    {"h?llo",
+     {{literal("h"), anyCodePoint(), literal("llo")}, {}},
+     "Question_mark_matches_one_code_point",
+     {.utf8 = true}},
+    {"caf\xC3\xA9*\\?",
+     {{literal("caf\xC3\xA9"), {TokenType::ANY_SEQUENCE}, literal("?")}, {}},
+     "Multi_byte_literals_and_stars_stay_byte_wise",
+     {.utf8 = true}},
+
+    // --- Binary mode (ParseOptions::binary) ---
+    {"\\x00\\xFF*\\x7fz",
+     {{literal(std::string("\x00\xFF", 2)), {TokenType::ANY_SEQUENCE}, literal("\x7Fz")}, {}},
+     "Hex_escapes_spell_any_byte",
+     {.binary = true}},
+    {"[\\x00-\\x1F]?",
+     {{charClass({{'\x00', '\x1F'}}), {TokenType::ANY_CHAR}}, {}},
+     "Hex_escapes_inside_classes",
+     {.char_classes = true, .binary = true}},
+    {"a\\xG1\\x4",
+     {{literal("axG1x4")},
+      {{IssueCode::INVALID_HEX_ESCAPE, 2, "xG1"}, {IssueCode::INVALID_HEX_ESCAPE, 6, "x4"}}},
+     "Malformed_hex_escapes_are_reported",
+     {.binary = true}},
+    {"\\x41",
+     {{literal("x41")}, {{IssueCode::UNDEFINED_ESCAPE_SEQUENCE, 1, "x"}}},
+     "Hex_escapes_are_undefined_outside_binary_mode"},
+
+    // --- Path mode (ParseOptions::path) ---
+    {"src/**/*.c",
+     {{literal("src/"), anySegments(), segmentStar(), literal(".c")}, {}},
+     "Globstar_segment_absorbs_its_slash",
+     paths},
+    {"**",
+     {{anySegments(), segmentStar()}, {}},
+     "Lone_globstar_matches_every_path",
+     paths},
+    {"docs/**",
+     {{literal("docs/"), anySegments(), segmentStar()}, {}},
+     "Trailing_globstar_is_followed_by_a_segment_star",
+     paths},
+    {"a/**/**/b",
+     {{literal("a/"), anySegments(), literal("b")}, {}},
+     "Consecutive_globstar_segments_are_merged",
+     paths},
+    {"a**b?/***",
+     {{literal("a"),
+       segmentStar(),
+       literal("b"),
+       withoutSlash(charClass({}, true)),
+       literal("/"),
+       anySegments(),
+       segmentStar()},
+      {{IssueCode::CONSECUTIVE_ASTERISKS_MERGED, 3}, {IssueCode::CONSECUTIVE_ASTERISKS_MERGED, 9}}},
+     "Stars_within_a_segment_stay_in_the_segment",
+     paths},
+    {"\\*\\*/[!a]",
+     {{literal("**/"), withoutSlash(charClass({{'a', 'a'}}, true))}, {}},
+     "Escaped_stars_are_literals_and_classes_exclude_the_slash",
+     {.char_classes = true, .path = true}}};
\ No newline at end of file
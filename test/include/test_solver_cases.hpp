@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,12 @@ struct SolverTestCase {
     std::string description;
 };
 
+// Returns the bytes of a string literal, including embedded NULs.
+template <std::size_t N>
+std::string bytes(const char (&literal)[N]) {
+    return std::string(literal, N - 1);
+}
+
 // A comprehensive collection of test cases to validate solver correctness.
 const std::vector<SolverTestCase> solver_test_cases = {
     // --- Basic & Boundary Cases ---
@@ -87,6 +94,22 @@ const std::vector<SolverTestCase> solver_test_cases = {
      "match 'cb'."},
     {"b", "*a*", false, "Required character missing: String does not contain 'a'."},
 
+    // --- Fixed-Width Windows (literal runs interleaved with '?') ---
+    {"2024-05-17T09:41", "2024-?\?-??T??:??", true,
+     "Timestamp window: Literals and '?' form a single fixed-width window."},
+    {"2024-05-17 09:41", "2024-?\?-??T??:??", false,
+     "Timestamp window mismatch: A literal inside the window differs from the text."},
+    {"2024-05-17T09:4", "2024-?\?-??T??:??", false,
+     "Short window: The text ends before the fixed-width window is complete."},
+    {"log 2024-05-17T09:41:07.123Z level=info", "*2024-?\?-??T??:??:??.???Z*", true,
+     "Window between stars: The fixed-width window is found in the middle of the text."},
+    {"id=0123456789abcdef0123456789ABCDEF-x", "id=????????????????0123456789?BCDEF-?", true,
+     "Long window: A window wider than one vector register is compared block by block."},
+    {"id=0123456789abcdef0123456789ABCDEF-x", "id=????????????????0123456789?BCDEF-y", false,
+     "Long window tail mismatch: Only the last byte of a wide window differs."},
+    {"xx2024-05-17T09:41|2024-05-17T09:41", "*2024-?\?-??T??:??", true,
+     "Window backtracking: The first window occurrence is not anchored at the end of the text."},
+
     // --- Large & Complex Cases ---
     {std::string(30, 'a') + "b",
      [] {
@@ -156,4 +179,119 @@ const std::vector<SolverTestCase> solver_test_cases = {
      }(),
      true,
      "Greedy algorithm stability: Each '*' must correctly match an empty string. Tests stability "
-     "with a highly repetitive and structured pattern."}};
\ No newline at end of file
+     "with a highly repetitive and structured pattern."}};
+
+// Test cases for brace alternation; the patterns are parsed with ParseOptions::alternation.
+const std::vector<SolverTestCase> alternation_test_cases = {
+    {"photo.png", "*.{jpg,png,gif}", true, "Alternation of extensions: second alternative."},
+    {"photo.bmp", "*.{jpg,png,gif}", false, "Alternation of extensions: no alternative matches."},
+    {"x.jpeg", "x.{jpg,jpeg}", true, "Shared prefix: the longer alternative matches."},
+    {"x.jp", "x.{jpg,jpeg}", false, "Shared prefix: the shared part alone does not match."},
+    {"ab", "a{,b}", true, "Empty alternative: the non-empty one matches."},
+    {"a", "a{,b}", true, "Empty alternative: matches the empty text."},
+    {"acd", "a{b,c{d,e}}", true, "Nested alternation: inner alternative matches."},
+    {"ac", "a{b,c{d,e}}", false, "Nested alternation: inner alternation must consume a character."},
+    {"a/b/c.txt", "{*/,}*.{txt,log}", true, "Alternatives with wildcards: star in an alternative."},
+    {"abc", "{a,ab}{bc,c}", true, "Adjacent alternations: several ways to split the text."},
+    {"abbc", "{a,ab}{bc,c}", true, "Adjacent alternations: longest choices on both sides."},
+    {"ac", "{a,ab}{bc,c}", true, "Adjacent alternations: shortest choices on both sides."},
+    {"abcc", "{a,ab}{bc,c}", false, "Adjacent alternations: no split consumes the whole text."},
+    {"a?c", "a{\\?,\\*}c", true, "Escaped wildcards inside an alternative are literal."},
+    {"abc", "a{\\?,\\*}c", false, "Escaped wildcards inside an alternative are not wildcards."}};
+
+
+// Test cases for character classes; the patterns are parsed with ParseOptions::char_classes.
+const std::vector<SolverTestCase> char_class_test_cases = {
+    {"IMG_0042.jpg", "IMG_[0-9][0-9][0-9][0-9].*", true, "Digit classes: every digit matches."},
+    {"IMG_00a2.jpg", "IMG_[0-9][0-9][0-9][0-9].*", false, "Digit classes: a letter is rejected."},
+    {"b", "[!a-c]", false, "Negated class: a member of the range is rejected."},
+    {"d", "[^a-c]", true, "Negated class: a byte outside the range matches."},
+    {"", "[a-z]", false, "A class must consume exactly one character."},
+    {"ab", "[a-z]", false, "A class consumes only one character."},
+    {"]", "[]]", true, "A leading ']' is a member."},
+    {"-", "[a-]", true, "A trailing '-' is a member."},
+    {"log-2024-01-15.txt", "*[0-9].txt", true, "Leading star skips to the class."},
+    {"log-2024-01-15.TXT", "*[0-9].txt", false, "Leading star: the suffix after the class fails."},
+    {"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxa1", "*[a-c][0-9]", true,
+     "Skip over a long run before the only candidate."},
+    {"a1xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx", "*[a-c][0-9]", false,
+     "The candidate is not at the end of the text."},
+    {"key=VALUE;", "*=[A-Z]*;", true, "Classes between stars."},
+    {"key=value;", "*=[A-Z]*;", false, "Classes between stars: wrong case."},
+    {"a?c", "a[?*]c", true, "Wildcard characters are plain members of a class."},
+    {"abc", "a[?*]c", false, "Wildcard characters inside a class are not wildcards."}};
+
+// Test cases for case-insensitive literals; the patterns are parsed with
+// ParseOptions::case_insensitive.
+const std::vector<SolverTestCase> case_insensitive_test_cases = {
+    {"README.md", "readme.MD", true, "Every letter matches in either case."},
+    {"ReadMe.md", "readme.md", true, "Mixed case text."},
+    {"readme.mdx", "readme.md", false, "Folding does not change the length."},
+    {"@", "`", false, "Bytes that differ in bit 0x20 but are not letters stay exact."},
+    {"[", "{", false, "Only ASCII letters are folded."},
+    {"\xC4", "\xE4", false, "Bytes above 0x7F are never folded."},
+    {"Report-2024.PDF", "report-????.pdf", true, "Folded literals around a run of '?'."},
+    {"Report-2024.PDF", "*-2024.pdf", true, "A leading star before a folded tail."},
+    {"x/IMAGES/y/Logo.PNG", "*/images/*.png", true, "Folded segments between stars."},
+    {"x/IMAGES/y/Logo.PNG", "*/images/*.gif", false, "Folded segments: wrong extension."},
+    {"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaAB", "*ab", true,
+     "Folded tail after a long run of the same letter."},
+    {"The Quick Brown Fox Jumps Over The Lazy Dog", "*quick brown fox jumps over the lazy*", true,
+     "A folded literal longer than one vector block."},
+    {"The Quick Brown Fox Jumps Over The Lazy Cat", "*quick brown fox jumps over the lazy dog",
+     false, "A long folded literal that fails on its last letter."},
+    {"Q", "?", true, "A '?' is unaffected by folding."}};
+
+// Test cases for the UTF-8 mode; the patterns are parsed with ParseOptions::utf8.
+const std::vector<SolverTestCase> utf8_test_cases = {
+    {"h\xC3\xA9llo", "h?llo", true, "'?' matches a two-byte code point."},
+    {"h\xC3\xA9llo", "h??llo", false, "'?' does not match a single byte of a code point."},
+    {"\xE2\x82\xAC" "5", "?5", true, "'?' matches a three-byte code point."},
+    {"\xF0\x9F\x98\x80", "?", true, "'?' matches a four-byte code point."},
+    {"\xF0\x9F\x98\x80", "??", false, "A four-byte code point is only one character."},
+    {"ab", "??", true, "ASCII characters are code points of one byte."},
+    {"\xE5\x8C\x97\xE4\xBA\xAC.example", "??.example", true, "Host names with CJK labels."},
+    {"\xE5\x8C\x97\xE4\xBA\xAC.example", "?.example", false, "Two code points are not one."},
+    {"log: caf\xC3\xA9 ok", "*caf\xC3\xA9*", true, "Multi-byte literals match byte-wise."},
+    {"log: cafe ok", "*caf\xC3\xA9*", false, "Multi-byte literals do not match ASCII."},
+    {"\xC3\xA9t\xC3\xA9", "*?t?", true, "A leading star followed by code points."}};
+
+// Test cases for raw byte texts; the patterns are parsed with ParseOptions::binary.
+const std::vector<SolverTestCase> binary_test_cases = {
+    {bytes("\0\0\x01\xFF"), "\\x00\\x00\\x01\\xff", true, "Every byte value can be spelled."},
+    {bytes("\0\0\x01\xFE"), "\\x00\\x00\\x01\\xff", false, "The last byte differs."},
+    {bytes("GET /\0\0\0HTTP"), "GET /*HTTP", true, "A star absorbs embedded NULs."},
+    {bytes("\x89PNG\r\n\x1A\n\0\0\0\rIHDR"), "\\x89PNG*IHDR", true, "A file signature."},
+    {bytes("\x89PNX\r\n\x1A\n\0\0\0\rIHDR"), "\\x89PNG*IHDR", false, "A broken signature."},
+    {bytes("\xC3\0"), "??", true, "'?' matches any single byte, even a lone lead byte."},
+    {bytes("\xC3\0"), "?", false, "Bytes are never grouped into characters."},
+    {bytes("a\0b\0c\0a\0b\0d"), "*a\\x00b\\x00d", true, "A tail with NULs after restarts."},
+    {bytes("a\0b\0c\0a\0b\0d"), "*a\\x00b\\x00c", false, "A NUL-separated tail is missing."},
+    {bytes("\0"), "\\x00*", true, "A single NUL byte."}};
+
+// Test cases for path mode; the patterns are parsed with ParseOptions::path.
+const std::vector<SolverTestCase> path_test_cases = {
+    {"src/main.c", "src/*.c", true, "'*' matches within a segment."},
+    {"src/lib/main.c", "src/*.c", false, "'*' does not match '/'."},
+    {"axb", "a?b", true, "'?' matches a character other than '/'."},
+    {"a/b", "a?b", false, "'?' does not match '/'."},
+    {"x-long-yz", "x*yz", true, "A path '*' between literals spans several characters."},
+    {"src/lib/util/main.c", "src/**/*.c", true, "'**' spans several segments."},
+    {"src/main.c", "src/**/*.c", true, "'**' matches zero segments."},
+    {"src/lib/main.h", "src/**/*.c", false, "'**' spans segments: wrong extension."},
+    {"z.txt", "**/z.txt", true, "A leading '**' matches zero segments."},
+    {"x/y/z.txt", "**/z.txt", true, "A leading '**' matches several segments."},
+    {"x/yz.txt", "**/z.txt", false, "'**' absorbs whole segments only."},
+    {"docs/a/b", "docs/**", true, "A trailing '**' matches everything below."},
+    {"docs/", "docs/**", true, "A trailing '**' matches an empty last segment."},
+    {"docs", "docs/**", false, "A trailing '**' needs the '/' before it."},
+    {"any/path/at/all", "**", true, "A lone '**' matches every path."},
+    {"", "**", true, "A lone '**' matches the empty path."},
+    {"abcd", "a**d", true, "'**' inside a segment is a plain '*'."},
+    {"ab/cd", "a**d", false, "'**' inside a segment does not match '/'."},
+    {"a/b/c/d/e", "a/**/c/**/e", true, "Two '**' segments."},
+    {"a/b/c/d/e", "a/**/d/**/c", false, "Two '**' segments: wrong order."},
+    {"a/x/b/x/b/c", "a/**/x/b/c", true, "A mismatch after '**' restarts one segment later."},
+    {"/usr/bin/env", "/usr/*/env", true, "Absolute paths start with an empty segment."},
+    {"usr/bin/env", "/usr/*/env", false, "A relative path does not match an absolute one."},
+    {"a//b", "a/*/b", true, "'*' matches an empty segment."}};
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "engine/adaptive.hpp"
+#include "engine/planner.hpp"
+#include "multi/adaptive_list.hpp"
+#include "solvers/greedy.hpp"
+#include "test_solver_cases.hpp"
+#include "utils/parser.hpp"
+
+namespace {
+
+/**
+ * @brief Creates an adaptive matcher for a pattern with the given options.
+ */
+AdaptiveMatcher makeMatcher(const std::string& pattern, AdaptiveOptions options = {}) {
+    return AdaptiveMatcher::create(Parser::parse(pattern).tokens, std::move(options));
+}
+
+TEST(AdaptiveMatcherTest, MatchesAccordingToDefinedCases) {
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "Test Case: " << test_case.description));
+        AdaptiveMatcher matcher = makeMatcher(test_case.pattern, {1, 1});
+
+        // With a sample interval of 1 every call rotates through the candidates
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(matcher.match(test_case.text), test_case.expected_result);
+        }
+    }
+}
+
+TEST(AdaptiveMatcherTest, StartsOnThePlannedEngineAndSamplesAlternatives) {
+    AdaptiveMatcher matcher = makeMatcher("*needle*", {4, 1000});
+    const std::string text = "a short needle";
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_TRUE(matcher.match(text));
+    }
+
+    EXPECT_EQ(matcher.currentEngine(), Planner::choose(Parser::parse("*needle*").tokens, 14));
+    EXPECT_EQ(matcher.engineStats(Engine::GREEDY).calls, 12u);
+    EXPECT_EQ(matcher.engineStats(Engine::BYTECODE).calls +
+                  matcher.engineStats(Engine::JIT).calls,
+              4u);
+    EXPECT_GT(matcher.engineStats(Engine::BYTECODE).calls, 0u);
+    EXPECT_GT(matcher.engineStats(Engine::JIT).calls, 0u);
+
+    // Matches shorter than a microsecond still accumulate latency
+    EXPECT_GT(matcher.engineStats(Engine::GREEDY).total_ns, 0u);
+}
+
+TEST(AdaptiveMatcherTest, StartsOnACandidateWhenThePlannedEngineIsNotOne) {
+    ASSERT_EQ(Planner::choose(Parser::parse("*needle*").tokens, 14), Engine::GREEDY);
+    AdaptiveMatcher matcher = makeMatcher("*needle*", {4, 1, {Engine::BYTECODE, Engine::JIT}});
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(matcher.match("a short needle"));
+    }
+    EXPECT_NE(matcher.currentEngine(), Engine::GREEDY);
+    EXPECT_EQ(matcher.engineStats(Engine::GREEDY).calls, 0u);
+
+    // Observations of other engines are ignored as well
+    matcher.observe(Engine::GREEDY, 1);
+    EXPECT_EQ(matcher.engineStats(Engine::GREEDY).calls, 0u);
+}
+
+TEST(AdaptiveMatcherTest, ConvergesOnTheFastestEngine) {
+    AdaptiveMatcher matcher = makeMatcher("*needle*", {16, 3});
+    matcher.observe(Engine::GREEDY, 50);
+    EXPECT_EQ(matcher.currentEngine(), Engine::GREEDY);
+
+    // Too few samples of the faster engine so far
+    matcher.observe(Engine::BYTECODE, 10);
+    matcher.observe(Engine::BYTECODE, 10);
+    EXPECT_EQ(matcher.currentEngine(), Engine::GREEDY);
+
+    matcher.observe(Engine::BYTECODE, 10);
+    EXPECT_EQ(matcher.currentEngine(), Engine::BYTECODE);
+
+    // A slower engine does not take over, however often it is sampled
+    for (int i = 0; i < 10; ++i) {
+        matcher.observe(Engine::JIT, 20);
+    }
+    EXPECT_EQ(matcher.currentEngine(), Engine::BYTECODE);
+
+    // But it does once the current engine degrades
+    for (int i = 0; i < 10; ++i) {
+        matcher.observe(Engine::BYTECODE, 100);
+    }
+    EXPECT_EQ(matcher.currentEngine(), Engine::JIT);
+}
+
+TEST(AdaptiveMatcherTest, ExportsAndImportsLearnedState) {
+    AdaptiveMatcher matcher = makeMatcher("*.log");
+    EXPECT_EQ(matcher.exportState(), "");
+    for (int i = 0; i < 8; ++i) {
+        matcher.observe(Engine::BYTECODE, 3);
+    }
+    matcher.observe(Engine::GREEDY, 7);
+    const std::string state = matcher.exportState();
+    EXPECT_EQ(state, "best=bytecode greedy=1/7 bytecode=8/24 jit=0/0");
+
+    AdaptiveMatcher restored = makeMatcher("*.log");
+    ASSERT_TRUE(restored.importState(state));
+    EXPECT_EQ(restored.currentEngine(), Engine::BYTECODE);
+    EXPECT_EQ(restored.engineStats(Engine::BYTECODE).total_ns, 24);
+    EXPECT_EQ(restored.exportState(), state);
+
+    EXPECT_FALSE(restored.importState("greedy=1/7"));
+    EXPECT_FALSE(restored.importState("best=fastest"));
+    EXPECT_FALSE(restored.importState("best=greedy greedy=-1/7"));
+    EXPECT_FALSE(restored.importState("best=greedy greedy=1"));
+    EXPECT_EQ(restored.exportState(), state);
+}
+
+TEST(AdaptiveMatcherTest, RunsDialectPatternsOnTheAutomaton) {
+    AdaptiveMatcher matcher =
+        AdaptiveMatcher::create(Parser::parse("[0-9]", {.char_classes = true}).tokens);
+    EXPECT_TRUE(matcher.match("5"));
+    EXPECT_FALSE(matcher.match("a"));
+    EXPECT_EQ(matcher.currentEngine(), Engine::NFA);
+    EXPECT_EQ(matcher.engineStats(Engine::NFA).calls, 2u);
+}
+
+TEST(AdaptiveMatcherTest, SamplesOnlyEnginesThatRunThePattern) {
+    AdaptiveMatcher matcher =
+        AdaptiveMatcher::create(Parser::parse("x{yy,zz}", {.alternation = true}).tokens, {1, 1});
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(matcher.match("xzz"));
+        EXPECT_FALSE(matcher.match("x"));
+    }
+    EXPECT_EQ(matcher.engineStats(Engine::NFA).calls, 8u);
+    for (Engine engine : {Engine::GREEDY, Engine::BYTECODE, Engine::JIT}) {
+        EXPECT_EQ(matcher.engineStats(engine).calls, 0u);
+    }
+
+    // Observations and imported state for other engines are rejected
+    matcher.observe(Engine::GREEDY, 1);
+    EXPECT_EQ(matcher.engineStats(Engine::GREEDY).calls, 0u);
+    EXPECT_FALSE(matcher.importState("best=greedy nfa=1/1"));
+    EXPECT_EQ(matcher.currentEngine(), Engine::NFA);
+    EXPECT_EQ(matcher.exportState().rfind("best=nfa nfa=8/", 0), 0u);
+}
+
+TEST(AdaptiveMatcherCacheTest, RoundTripsThroughAStream) {
+    AdaptiveMatcherCache cache;
+    cache.get("*.log").observe(Engine::JIT, 2);
+    cache.get("a b\\*").observe(Engine::GREEDY, 5);
+    cache.get("unused");
+
+    std::stringstream stream;
+    cache.exportState(stream);
+    EXPECT_EQ(stream.str(), "5:*.log best=jit greedy=0/0 bytecode=0/0 jit=1/2\n"
+                            "5:a b\\* best=greedy greedy=1/5 bytecode=0/0 jit=0/0\n");
+
+    AdaptiveMatcherCache restored;
+    ASSERT_TRUE(restored.importState(stream));
+    EXPECT_EQ(restored.size(), 2u);
+    EXPECT_EQ(restored.get("*.log").currentEngine(), Engine::JIT);
+    EXPECT_EQ(restored.get("a b\\*").engineStats(Engine::GREEDY).total_ns, 5);
+    EXPECT_TRUE(restored.get("a b\\*").match("a b*"));
+
+    std::stringstream malformed("5:*.log\n");
+    EXPECT_FALSE(AdaptiveMatcherCache().importState(malformed));
+}
+
+TEST(AdaptivePatternListTest, FindsAMatchWheneverOneExists) {
+    std::vector<std::string> patterns;
+    for (const auto& test_case : solver_test_cases) {
+        patterns.push_back(test_case.pattern);
+    }
+    AdaptivePatternList list = AdaptivePatternList::create(patterns, {1, 3});
+
+    for (int round = 0; round < 3; ++round) {
+        for (const auto& test_case : solver_test_cases) {
+            SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+            bool expected = false;
+            for (const auto& pattern : patterns) {
+                expected = expected || GreedySolver::runAndProfile(test_case.text, pattern).result;
+            }
+            const std::optional<size_t> found = list.matchAny(test_case.text);
+            ASSERT_EQ(found.has_value(), expected);
+            if (found) {
+                EXPECT_TRUE(GreedySolver::runAndProfile(test_case.text, patterns[*found]).result);
+            }
+        }
+    }
+}
+
+TEST(AdaptivePatternListTest, MovesFrequentlyHitPatternsToTheFront) {
+    AdaptivePatternList list =
+        AdaptivePatternList::create({"*.jpg", "*.png", "*.gif", "*.log"}, {1, 50});
+    EXPECT_EQ(list.order(), (std::vector<size_t>{0, 1, 2, 3}));
+
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(list.matchAny("service-" + std::to_string(i) + ".log"), 3u);
+    }
+    EXPECT_EQ(list.order().front(), 3u);
+    EXPECT_EQ(list.counters(3).hits, 200u);
+    EXPECT_EQ(list.counters(0).hits, 0u);
+
+    // Once reordered, the other patterns are no longer tried for these texts
+    const std::uint64_t tries_before = list.counters(0).tries;
+    list.matchAny("app.log");
+    EXPECT_EQ(list.counters(0).tries, tries_before);
+
+    std::ostringstream out;
+    list.exportCounters(out);
+    EXPECT_EQ(out.str().rfind("3 tries=", 0), 0u);
+    EXPECT_NE(out.str().find(" hits=201 "), std::string::npos);
+}
+
+}  // namespace
\ No newline at end of file
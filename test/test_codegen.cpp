@@ -0,0 +1,95 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "codegen_patterns.hpp"
+#include "solvers/greedy.hpp"
+#include "test_solver_cases.hpp"
+#include "utils/codegen.hpp"
+#include "utils/parser.hpp"
+
+namespace {
+
+// Texts exercising the patterns of test/data/codegen_patterns.txt, besides the solver cases.
+const std::vector<std::string> texts = {
+    "",          "a",           "ab",          "abc",        "app.log",   "app.log.gz",
+    "log",       ".log",        "mississippi", "aab",        "abacde",    "a*b",
+    "a?c",       "a\\b",        "x/y/z.log",   "GET /api/v1/users/42.json",
+    "2024-05-17T09:41:00",      "log 2024-05-17T09:41:00 ok"};
+
+/**
+ * @brief Checks the generated matcher of every pattern against GreedySolver on one text.
+ */
+void expectAgreesWithGreedy(std::string_view text) {
+    SCOPED_TRACE(testing::Message() << "s: \"" << text << "\"");
+    for (std::size_t id = 0; id < wildcard_patterns::pattern_count; ++id) {
+        const auto& entry = wildcard_patterns::patterns[id];
+        SCOPED_TRACE(testing::Message() << "p: \"" << entry.pattern << "\"");
+        const auto tokens = Parser::parse(entry.pattern).tokens;
+        EXPECT_EQ(entry.match(text), GreedySolver::runAndProfile(text, tokens).result);
+    }
+}
+
+TEST(CodegenTest, GeneratedMatchersAgreeWithGreedySolver) {
+    ASSERT_GT(wildcard_patterns::pattern_count, 0u);
+    for (const auto& text : texts) {
+        expectAgreesWithGreedy(text);
+    }
+    for (const auto& test_case : solver_test_cases) {
+        expectAgreesWithGreedy(test_case.text);
+    }
+}
+
+TEST(CodegenTest, FirstMatchReturnsTheEarliestPattern) {
+    EXPECT_EQ(wildcard_patterns::patterns[0].pattern, "*.log");
+    EXPECT_EQ(wildcard_patterns::firstMatch("server.log"), 0);
+    EXPECT_EQ(wildcard_patterns::firstMatch("apple"), 1);
+    EXPECT_EQ(wildcard_patterns::firstMatch("x"), 9);
+
+    // Only the final lone '*' accepts the empty text.
+    EXPECT_EQ(wildcard_patterns::firstMatch(""),
+              static_cast<long>(wildcard_patterns::pattern_count) - 1);
+}
+
+TEST(CodegenTest, EscapesLiteralsInGeneratedSource) {
+    const std::vector<PatternDefinition> definitions = {
+        {"a\\?\"*", Parser::parse("a\\?\"*").tokens}};
+    const std::string source = CodeGenerator::generateSource(definitions, CodegenOptions{});
+
+    // '?' is always escaped, so the generated code cannot contain trigraphs.
+    EXPECT_NE(source.find("\"a\\?\\\"\""), std::string::npos);
+    EXPECT_EQ(source.find("??"), std::string::npos);
+    EXPECT_NE(source.find("bool match_0(std::string_view s)"), std::string::npos);
+}
+
+TEST(CodegenTest, FoldsCaseOfCaseInsensitiveLetters) {
+    const std::vector<PatternDefinition> definitions = {
+        {"X1*", Parser::parse("X1*", {.case_insensitive = true}).tokens}};
+    const std::string source = CodeGenerator::generateSource(definitions, CodegenOptions{});
+
+    // The letter accepts both cases through bit 0x20, and the digit is compared exactly.
+    EXPECT_NE(source.find("((p)[0] | 0x20) == 'x'"), std::string::npos);
+    EXPECT_NE(source.find("(p)[1] == '1'"), std::string::npos);
+}
+
+TEST(CodegenTest, OmitsTheLengthGuardOfABareStar) {
+    const std::vector<PatternDefinition> definitions = {{"*", Parser::parse("*").tokens},
+                                                        {"a*", Parser::parse("a*").tokens}};
+    const std::string source = CodeGenerator::generateSource(definitions, CodegenOptions{});
+
+    // An unsigned size is never below 0, so that comparison would be dead code.
+    EXPECT_EQ(source.find("s.size() < 0"), std::string::npos);
+    EXPECT_NE(source.find("s.size() < 1"), std::string::npos);
+}
+
+TEST(CodegenTest, RejectsDialectPatterns) {
+    EXPECT_TRUE(CodeGenerator::supports(Parser::parse("*.log").tokens));
+    EXPECT_TRUE(CodeGenerator::supports(Parser::parse("X1*", {.case_insensitive = true}).tokens));
+    EXPECT_FALSE(CodeGenerator::supports(Parser::parse("[0-9]*", {.char_classes = true}).tokens));
+    EXPECT_FALSE(CodeGenerator::supports(Parser::parse("{a,b}", {.alternation = true}).tokens));
+    EXPECT_FALSE(CodeGenerator::supports(Parser::parse("src/*.c", {.path = true}).tokens));
+}
+
+}  // namespace
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "engine/cost_model.hpp"
+#include "solvers/auto.hpp"
+#include "test_solver_cases.hpp"
+#include "utils/parser.hpp"
+
+namespace {
+
+/**
+ * @brief Parses a pattern and estimates its cost on one engine.
+ */
+EngineCost estimate(Engine engine, const std::string& pattern, std::size_t text_length) {
+    return CostModel::estimate(engine, Parser::parse(pattern).tokens, text_length);
+}
+
+TEST(CostModelTest, PatternsWithoutStarsAreLinearEverywhere) {
+    for (const auto& cost : CostModel::estimateAll(Parser::parse("abc?e").tokens, 1 << 20)) {
+        // The automaton advances all 5 positions for at most 5 characters
+        EXPECT_EQ(cost.steps, cost.engine == Engine::NFA ? 5u * 6u : 5u)
+            << engineToString(cost.engine);
+    }
+}
+
+TEST(CostModelTest, EstimatesTheDpTable) {
+    // Tokens: '*', "ab", '?', '*' -> n = 4
+    const EngineCost cost = estimate(Engine::DP, "*ab?*", 99);
+    EXPECT_EQ(cost.steps, 100u * 5u);
+
+    // The table plus the masked windows, which the greedy solver holds besides 5 words of state
+    const EngineCost greedy = estimate(Engine::GREEDY, "*ab?*", 99);
+    EXPECT_EQ(cost.bytes, 100u * 5u * sizeof(bool) + greedy.bytes - 5 * sizeof(std::size_t));
+}
+
+TEST(CostModelTest, RanksEnginesByAsymptoticCost) {
+    const std::size_t text_length = 10000;
+    const EngineCost recursive = estimate(Engine::RECURSIVE, "*a*b*c*d", text_length);
+    const EngineCost memo = estimate(Engine::MEMO, "*a*b*c*d", text_length);
+    const EngineCost dp = estimate(Engine::DP, "*a*b*c*d", text_length);
+    const EngineCost greedy = estimate(Engine::GREEDY, "*a*b*c*d", text_length);
+
+    EXPECT_GT(recursive.steps, memo.steps);
+    EXPECT_GT(memo.bytes, dp.bytes);
+    EXPECT_GT(dp.bytes, greedy.bytes);
+    EXPECT_EQ(estimate(Engine::BYTECODE, "*a*b*c*d", text_length).steps, greedy.steps);
+}
+
+TEST(CostModelTest, SaturatesInsteadOfOverflowing) {
+    const EngineCost cost = estimate(Engine::RECURSIVE, "*a*b*c*d*e*f*g*h*", 1 << 20);
+    EXPECT_EQ(cost.steps, std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST(CostModelTest, BoundsTheMeasuredSpace) {
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "Test Case: " << test_case.description));
+        const auto tokens = Parser::parse(test_case.pattern).tokens;
+        for (Engine engine : {Engine::RECURSIVE, Engine::MEMO, Engine::DP, Engine::GREEDY,
+                              Engine::BYTECODE, Engine::NFA}) {
+            const SolverProfile profile = AutoSolver::runEngine(engine, test_case.text, tokens);
+            EXPECT_LE(profile.space_used_bytes,
+                      CostModel::estimate(engine, tokens, test_case.text.length()).bytes)
+                << engineToString(engine);
+        }
+    }
+}
+
+TEST(CostModelTest, DialectPatternsOnlyRunOnTheAutomaton) {
+    const auto tokens = Parser::parse("*.{jpg,png}", {.alternation = true}).tokens;
+    for (const auto& cost : CostModel::estimateAll(tokens, 1000)) {
+        if (cost.engine == Engine::NFA) {
+            // 7 positions in one word (*.{jp,pn}g)
+            EXPECT_EQ(cost.steps, 1000u * 8u) << engineToString(cost.engine);
+        } else {
+            EXPECT_EQ(cost.steps, std::numeric_limits<std::uint64_t>::max())
+                << engineToString(cost.engine);
+        }
+    }
+
+    const AdmissionDecision decision = CostModel::admit(tokens, 1000, Engine::GREEDY, {});
+    EXPECT_TRUE(decision.admitted);
+    EXPECT_EQ(decision.engine, Engine::NFA);
+}
+
+TEST(CostModelTest, AdmitsDowngradesOrRejects) {
+    const auto tokens = Parser::parse("*error*timeout*").tokens;
+    CostLimits limits;
+    limits.max_bytes = 64 * 1024;
+
+    AdmissionDecision decision = CostModel::admit(tokens, 1000, Engine::DP, limits);
+    EXPECT_TRUE(decision.admitted);
+    EXPECT_FALSE(decision.isDowngraded());
+
+    decision = CostModel::admit(tokens, 1 << 20, Engine::DP, limits);
+    EXPECT_TRUE(decision.admitted);
+    EXPECT_TRUE(decision.isDowngraded());
+    EXPECT_EQ(decision.engine, Engine::GREEDY);
+    EXPECT_EQ(decision.requested_cost.engine, Engine::DP);
+
+    limits.allow_downgrade = false;
+    decision = CostModel::admit(tokens, 1 << 20, Engine::DP, limits);
+    EXPECT_FALSE(decision.admitted);
+    EXPECT_EQ(decision.engine, Engine::DP);
+
+    limits.allow_downgrade = true;
+    limits.max_steps = 1000;
+    decision = CostModel::admit(tokens, 1 << 20, Engine::GREEDY, limits);
+    EXPECT_FALSE(decision.admitted);
+}
+
+}  // namespace
\ No newline at end of file
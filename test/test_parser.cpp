@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cctype>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -20,9 +21,10 @@ TEST_P(ParserTest, CorrectlyTokenizesAndIdentifiesEvents) {
     const auto& test_case = GetParam();
     SCOPED_TRACE(test_case.description);  // Provides context on failure.
 
-    ParseResult actual_result = Parser::parse(test_case.pattern);
+    ParseResult actual_result = Parser::parse(test_case.pattern, test_case.options);
     EXPECT_EQ(actual_result.tokens, test_case.expected_result.tokens);
     EXPECT_EQ(actual_result.events, test_case.expected_result.events);
+    EXPECT_EQ(actual_result.token_positions.size(), actual_result.tokens.size());
 }
 
 // Instantiate the test suite with all the defined test cases.
@@ -36,4 +38,13 @@ INSTANTIATE_TEST_SUITE_P(ParserLogic, ParserTest, ::testing::ValuesIn(parser_tes
                              return name;
                          });
 
+// Token positions point at the first raw character of each token, including escapes.
+TEST(ParserPositionsTest, RecordsTheStartOfEveryToken) {
+    ParseResult result = Parser::parse("*a?b\\*c**d\\");
+    EXPECT_EQ(result.token_positions, (std::vector<size_t>{1, 2, 3, 4, 8, 10}));
+
+    result = Parser::parse("\\\\?x");
+    EXPECT_EQ(result.token_positions, (std::vector<size_t>{1, 3, 4}));
+}
+
 }  // namespace
\ No newline at end of file
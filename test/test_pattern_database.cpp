@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "multi/compact_set.hpp"
+#include "multi/pattern_database.hpp"
+#include "solvers/greedy.hpp"
+#include "test_solver_cases.hpp"
+
+namespace {
+
+/**
+ * @brief Collects the distinct patterns of the solver test cases.
+ */
+std::vector<std::string> solverCasePatterns() {
+    std::vector<std::string> patterns;
+    for (const auto& test_case : solver_test_cases) {
+        patterns.push_back(test_case.pattern);
+    }
+    return patterns;
+}
+
+/**
+ * @brief Checks a database against the greedy solver on every solver test case.
+ */
+void expectAgreesWithGreedySolver(const PatternDatabase& database,
+                                  const std::vector<std::string>& patterns) {
+    ASSERT_EQ(database.size(), patterns.size());
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+        const MatchBitset matches = database.match(test_case.text);
+
+        std::optional<size_t> first;
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            const bool expected = GreedySolver::runAndProfile(test_case.text, patterns[id]).result;
+            EXPECT_EQ(matches.test(id), expected) << "p: \"" << patterns[id] << "\"";
+            if (expected && !first) {
+                first = id;
+            }
+        }
+        EXPECT_EQ(database.matchFirst(test_case.text), first);
+    }
+}
+
+TEST(PatternDatabaseTest, RoundTripsThroughBytes) {
+    const std::vector<std::string> patterns = solverCasePatterns();
+    const std::string bytes = PatternDatabase::serialize(CompactPatternSet::compile(patterns));
+
+    const std::optional<PatternDatabase> database = PatternDatabase::fromBytes(bytes);
+    ASSERT_TRUE(database.has_value());
+    EXPECT_FALSE(database->isMapped());
+    expectAgreesWithGreedySolver(*database, patterns);
+}
+
+TEST(PatternDatabaseTest, OpensFilesInPlace) {
+    const std::vector<std::string> patterns = solverCasePatterns();
+    const std::string path = testing::TempDir() + "pattern_database_test.wcdb";
+    ASSERT_TRUE(PatternDatabase::writeFile(CompactPatternSet::compile(patterns), path));
+
+    std::optional<PatternDatabase> database = PatternDatabase::open(path);
+    ASSERT_TRUE(database.has_value());
+#if defined(APP_HAS_MMAP)
+    EXPECT_TRUE(database->isMapped());
+#endif
+    expectAgreesWithGreedySolver(*database, patterns);
+
+    // Moving the database keeps the mapped tables valid
+    const PatternDatabase moved = std::move(*database);
+    EXPECT_EQ(moved.matchAll("abc"), CompactPatternSet::compile(patterns).matchAll("abc"));
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(PatternDatabase::open(path).has_value());
+}
+
+TEST(PatternDatabaseTest, RejectsInvalidFiles) {
+    const std::string bytes =
+        PatternDatabase::serialize(CompactPatternSet::compile({"*.log", "/api/*", "a?c"}));
+    ASSERT_TRUE(PatternDatabase::fromBytes(bytes).has_value());
+
+    EXPECT_FALSE(PatternDatabase::fromBytes("").has_value());
+    EXPECT_FALSE(PatternDatabase::fromBytes(bytes.substr(0, bytes.size() - 1)).has_value());
+
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    EXPECT_FALSE(PatternDatabase::fromBytes(bad_magic).has_value());
+
+    std::string bad_version = bytes;
+    bad_version[offsetof(PatternDatabaseHeader, version)] ^= 0x7f;
+    EXPECT_FALSE(PatternDatabase::fromBytes(bad_version).has_value());
+
+    // A flipped byte in the body is caught by the checksum unless verification is skipped
+    std::string corrupted = bytes;
+    corrupted.back() ^= 0x01;
+    EXPECT_FALSE(PatternDatabase::fromBytes(corrupted).has_value());
+    EXPECT_TRUE(PatternDatabase::fromBytes(corrupted, false).has_value());
+}
+
+TEST(PatternDatabaseTest, HandlesEmptySets) {
+    const std::string bytes = PatternDatabase::serialize(CompactPatternSet::compile(
+        std::vector<std::string>{}));
+    const std::optional<PatternDatabase> database = PatternDatabase::fromBytes(bytes);
+    ASSERT_TRUE(database.has_value());
+    EXPECT_EQ(database->size(), 0u);
+    EXPECT_TRUE(database->matchAll("anything").empty());
+    EXPECT_EQ(database->matchFirst("anything"), std::nullopt);
+}
+
+TEST(PatternDatabaseTest, KeepsCaseFoldedLiterals) {
+    const std::vector<std::vector<Token>> token_lists = {
+        Parser::parse("*/Images/*.PNG", {.case_insensitive = true}).tokens,
+        Parser::parse("*/Images/*.PNG").tokens};
+    const std::string bytes = PatternDatabase::serialize(*CompactPatternSet::compile(token_lists));
+    const std::optional<PatternDatabase> database = PatternDatabase::fromBytes(bytes);
+    ASSERT_TRUE(database.has_value());
+    EXPECT_EQ(database->matchAll("x/IMAGES/logo.png"), (std::vector<size_t>{0}));
+    EXPECT_EQ(database->matchAll("x/Images/logo.PNG"), (std::vector<size_t>{0, 1}));
+}
+
+}  // namespace
\ No newline at end of file
@@ -0,0 +1,547 @@
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "multi/aho_corasick.hpp"
+#include "multi/bit_nfa.hpp"
+#include "multi/bucketed_set.hpp"
+#include "multi/compact_set.hpp"
+#include "multi/literal_pool.hpp"
+#include "multi/pattern_set.hpp"
+#include "multi/redundancy.hpp"
+#include "multi/rule_engine.hpp"
+#include "solvers/greedy.hpp"
+#include "solvers/nfa.hpp"
+#include "test_solver_cases.hpp"
+#include "utils/validator.hpp"
+
+namespace {
+
+/**
+ * @brief Collects the distinct patterns of the solver test cases.
+ */
+std::vector<std::string> solverCasePatterns() {
+    std::vector<std::string> patterns;
+    for (const auto& test_case : solver_test_cases) {
+        patterns.push_back(test_case.pattern);
+    }
+    return patterns;
+}
+
+TEST(AhoCorasickTest, ReportsEveryOccurrence) {
+    const AhoCorasick automaton = AhoCorasick::build({"he", "she", "his", "hers", "", "he"});
+    std::vector<std::pair<std::uint32_t, size_t>> hits;
+    automaton.scan("ushers", [&](std::uint32_t id, size_t end) { hits.push_back({id, end}); });
+
+    // "she" and "he" both end at index 4, "hers" at 6; the duplicate "he" maps to ID 0
+    const std::vector<std::pair<std::uint32_t, size_t>> expected = {{1, 4}, {0, 4}, {3, 6}};
+    EXPECT_EQ(hits, expected);
+}
+
+TEST(PatternSetTest, AgreesWithGreedySolverOnEveryPattern) {
+    const std::vector<std::string> patterns = solverCasePatterns();
+    const PatternSet set = PatternSet::compile(patterns);
+    ASSERT_EQ(set.size(), patterns.size());
+
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+        const MatchBitset matches = set.match(test_case.text);
+
+        std::optional<size_t> first;
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            const bool expected = GreedySolver::runAndProfile(test_case.text, patterns[id]).result;
+            EXPECT_EQ(matches.test(id), expected) << "p: \"" << patterns[id] << "\"";
+            if (expected && !first) {
+                first = id;
+            }
+        }
+        EXPECT_EQ(set.matchFirst(test_case.text), first);
+        EXPECT_EQ(set.matchAll(test_case.text).size(), matches.count());
+
+        const std::optional<size_t> any = set.matchAny(test_case.text);
+        EXPECT_EQ(any.has_value(), first.has_value());
+        if (any) {
+            EXPECT_TRUE(matches.test(*any));
+        }
+    }
+}
+
+TEST(PatternSetTest, ReportsFirstAndAllMatches) {
+    const PatternSet set = PatternSet::compile(
+        std::vector<std::string>{"*.log", "app*", "*error*", "app.log", "???", "*"});
+
+    EXPECT_EQ(set.matchAll("app.log"), (std::vector<size_t>{0, 1, 3, 5}));
+    EXPECT_EQ(set.matchFirst("app.log"), 0u);
+    EXPECT_EQ(set.matchAll("an error occurred"), (std::vector<size_t>{2, 5}));
+    EXPECT_EQ(set.matchAll("abc"), (std::vector<size_t>{4, 5}));
+
+    const MatchBitset first = set.match("app.log", MatchMode::FIRST);
+    EXPECT_EQ(first.count(), 1u);
+    EXPECT_TRUE(first.test(0));
+}
+
+/**
+ * @brief Parses a pattern and returns its canonical token vector.
+ */
+std::vector<Token> canonical(std::string_view pattern) {
+    return RedundancyAnalyzer::canonicalize(Parser::parse(pattern).tokens);
+}
+
+TEST(RedundancyAnalyzerTest, CanonicalizesWildcardRuns) {
+    EXPECT_EQ(canonical("a*?*b"), canonical("a?*b"));
+    EXPECT_EQ(canonical("**?*?"), canonical("??*"));
+    EXPECT_EQ(canonical("a**b"), canonical("a*b"));
+    EXPECT_NE(canonical("a?b"), canonical("a*b"));
+    EXPECT_NE(canonical("a\\*b"), canonical("a*b"));
+
+    const std::vector<Token> expected = {{TokenType::LITERAL_SEQUENCE, "a"},
+                                         {TokenType::ANY_CHAR},
+                                         {TokenType::ANY_CHAR},
+                                         {TokenType::ANY_SEQUENCE},
+                                         {TokenType::LITERAL_SEQUENCE, "b"}};
+    EXPECT_EQ(canonical("a*?*?b"), expected);
+    EXPECT_EQ(RedundancyAnalyzer::canonicalKey(expected), "1:a??*1:b");
+}
+
+TEST(RedundancyAnalyzerTest, DetectsSubsumption) {
+    const auto subsumes = [](std::string_view general, std::string_view specific) {
+        return RedundancyAnalyzer::subsumes(canonical(general), canonical(specific));
+    };
+    EXPECT_TRUE(subsumes("*.log", "app*.log"));
+    EXPECT_TRUE(subsumes("*", "anything?*"));
+    EXPECT_TRUE(subsumes("a?c", "abc"));
+    EXPECT_TRUE(subsumes("*error*", "*error*timeout*"));
+    EXPECT_TRUE(subsumes("?*", "?"));
+    EXPECT_TRUE(subsumes("app*.log", "app*.log"));
+
+    EXPECT_FALSE(subsumes("app*.log", "*.log"));
+    EXPECT_FALSE(subsumes("abc", "a?c"));
+    EXPECT_FALSE(subsumes("a?c", "a*c"));
+    EXPECT_FALSE(subsumes("??", "?*"));
+}
+
+TEST(RedundancyAnalyzerTest, DetectsSubsumptionOfDialectTokens) {
+    const auto subsumes = [](std::string_view general, std::string_view specific) {
+        const ParseOptions options = {.alternation = true, .char_classes = true};
+        return RedundancyAnalyzer::subsumes(
+            RedundancyAnalyzer::canonicalize(Parser::parse(general, options).tokens),
+            RedundancyAnalyzer::canonicalize(Parser::parse(specific, options).tokens));
+    };
+    EXPECT_TRUE(subsumes("[a-z]*", "[a-c]x"));
+    EXPECT_TRUE(subsumes("[a-c]", "b"));
+    EXPECT_TRUE(subsumes("?", "[a-c]"));
+    EXPECT_TRUE(subsumes("*", "{a,bc}"));
+
+    EXPECT_FALSE(subsumes("[a-c]", "d"));
+    EXPECT_FALSE(subsumes("[a-c]", "?"));
+    EXPECT_FALSE(subsumes("[a-c]", "[a-d]"));
+    EXPECT_FALSE(subsumes("?", "{a,bc}"));
+}
+
+TEST(RedundancyAnalyzerTest, DetectsSubsumptionOfCaseFoldedLiterals) {
+    const auto subsumes = [](std::string_view general, bool fold_general,
+                             std::string_view specific, bool fold_specific) {
+        return RedundancyAnalyzer::subsumes(
+            RedundancyAnalyzer::canonicalize(
+                Parser::parse(general, {.case_insensitive = fold_general}).tokens),
+            RedundancyAnalyzer::canonicalize(
+                Parser::parse(specific, {.case_insensitive = fold_specific}).tokens));
+    };
+    EXPECT_TRUE(subsumes("*.log", true, "App.LOG", false));
+    EXPECT_TRUE(subsumes("*.LOG", true, "*.log", true));
+    EXPECT_TRUE(subsumes("*.1", false, "*.1", true));  // No letters, so nothing is folded
+
+    EXPECT_FALSE(subsumes("*.log", false, "*.log", true));
+    EXPECT_FALSE(subsumes("*.log", true, "*.lag", false));
+}
+
+TEST(PatternSetTest, MergesDuplicatesAndSkipsSubsumedPatterns) {
+    const PatternSet set = PatternSet::compile(std::vector<std::string>{
+        "app*.log", "*.log", "a*?*b", "a?*b", "a**?*b", "*.log", "app*.log.1"});
+    EXPECT_EQ(set.size(), 7u);
+    EXPECT_EQ(set.programCount(), 4u);  // "*.log", "a?*b" and "app*.log" repeat
+    EXPECT_EQ(set.liveCount(), 3u);     // "app*.log" is covered by "*.log"
+
+    // IDs are preserved for every duplicate
+    EXPECT_EQ(set.matchAll("app.log"), (std::vector<size_t>{0, 1, 5}));
+    EXPECT_EQ(set.matchAll("a-b"), (std::vector<size_t>{2, 3, 4}));
+    EXPECT_EQ(set.matchFirst("app.log"), 0u);
+    EXPECT_EQ(set.matchFirst("a-b"), 2u);
+
+    // ANY queries only verify the surviving patterns
+    EXPECT_EQ(set.matchAny("app.log"), 1u);
+    EXPECT_EQ(set.matchAny("app.log.1"), 6u);
+    EXPECT_EQ(set.matchAny("ab"), std::nullopt);
+}
+
+TEST(PatternSetTest, HandlesEmptySets) {
+    const PatternSet set = PatternSet::compile(std::vector<std::string>{});
+    EXPECT_TRUE(set.matchAll("anything").empty());
+    EXPECT_EQ(set.matchFirst("anything"), std::nullopt);
+}
+
+TEST(BucketedPatternSetTest, AgreesWithGreedySolverOnEveryPattern) {
+    const std::vector<std::string> patterns = solverCasePatterns();
+    const BucketedPatternSet set = BucketedPatternSet::compile(patterns);
+    ASSERT_EQ(set.size(), patterns.size());
+
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+        const MatchBitset matches = set.match(test_case.text);
+
+        std::optional<size_t> first;
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            const bool expected = GreedySolver::runAndProfile(test_case.text, patterns[id]).result;
+            EXPECT_EQ(matches.test(id), expected) << "p: \"" << patterns[id] << "\"";
+            if (expected && !first) {
+                first = id;
+            }
+        }
+        EXPECT_EQ(set.matchFirst(test_case.text), first);
+    }
+}
+
+TEST(BucketedPatternSetTest, ClassifiesPatternsByShape) {
+    const BucketedPatternSet set = BucketedPatternSet::compile(
+        std::vector<std::string>{"app.log", "", "app*", "*", "*.log", "*error*", "a?c", "a*b"});
+
+    EXPECT_EQ(set.shapeOf(0), PatternShapeKind::EXACT);
+    EXPECT_EQ(set.shapeOf(1), PatternShapeKind::EXACT);
+    EXPECT_EQ(set.shapeOf(2), PatternShapeKind::PREFIX);
+    EXPECT_EQ(set.shapeOf(3), PatternShapeKind::PREFIX);
+    EXPECT_EQ(set.shapeOf(4), PatternShapeKind::SUFFIX);
+    EXPECT_EQ(set.shapeOf(5), PatternShapeKind::GENERAL);
+    EXPECT_EQ(set.shapeOf(6), PatternShapeKind::GENERAL);
+    EXPECT_EQ(set.shapeOf(7), PatternShapeKind::GENERAL);
+}
+
+TEST(BucketedPatternSetTest, KeepsGlobalIdsAcrossBuckets) {
+    const BucketedPatternSet set = BucketedPatternSet::compile(std::vector<std::string>{
+        "*error*", "app.log", "*.log", "app*", "app.log", "", "*"});
+
+    EXPECT_EQ(set.matchAll("app.log"), (std::vector<size_t>{1, 2, 3, 4, 6}));
+    EXPECT_EQ(set.matchFirst("app.log"), 1u);
+    EXPECT_EQ(set.matchAll("app error.log"), (std::vector<size_t>{0, 2, 3, 6}));
+    EXPECT_EQ(set.matchFirst("app error.log"), 0u);
+    EXPECT_EQ(set.matchAll(""), (std::vector<size_t>{5, 6}));
+
+    const MatchBitset first = set.match("app.log", MatchMode::FIRST);
+    EXPECT_EQ(first.count(), 1u);
+    EXPECT_TRUE(first.test(1));
+}
+
+TEST(BucketedPatternSetTest, ScalesWithManySimplePatterns) {
+    std::vector<std::string> patterns;
+    for (int i = 0; i < 3000; ++i) {
+        patterns.push_back("host-" + std::to_string(i));
+        patterns.push_back("/api/v" + std::to_string(i) + "/*");
+        patterns.push_back("*." + std::to_string(i) + ".log");
+    }
+    const BucketedPatternSet set = BucketedPatternSet::compile(patterns);
+
+    EXPECT_EQ(set.matchAll("host-42"), (std::vector<size_t>{126}));
+    EXPECT_EQ(set.matchAll("/api/v7/users"), (std::vector<size_t>{22}));
+    EXPECT_EQ(set.matchAll("/api/v12/x.12.log"), (std::vector<size_t>{37, 38}));
+    EXPECT_TRUE(set.matchAll("unrelated").empty());
+}
+
+TEST(BitParallelSetTest, AgreesWithGreedySolverOnEveryPattern) {
+    const std::vector<std::string> patterns = solverCasePatterns();
+    const BitParallelSet set = BitParallelSet::compile(patterns);
+    ASSERT_EQ(set.size(), patterns.size());
+
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+        const MatchBitset matches = set.match(test_case.text);
+
+        std::optional<size_t> first;
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            const bool expected = GreedySolver::runAndProfile(test_case.text, patterns[id]).result;
+            EXPECT_EQ(matches.test(id), expected) << "p: \"" << patterns[id] << "\"";
+            if (expected && !first) {
+                first = id;
+            }
+        }
+        EXPECT_EQ(set.matchFirst(test_case.text), first);
+    }
+}
+
+TEST(BitParallelSetTest, CarriesStatesAcrossWordBoundaries) {
+    // Both patterns are longer than one 128-bit block, so their states straddle several words
+    const std::string long_literal(150, 'x');
+    const BitParallelSet set = BitParallelSet::compile(
+        std::vector<std::string>{long_literal + "*end", "*" + long_literal + "?", long_literal});
+    EXPECT_GE(set.stateBits(), 2 * 150u);
+
+    EXPECT_EQ(set.matchAll(long_literal + "--end"), (std::vector<size_t>{0}));
+    EXPECT_EQ(set.matchAll("ab" + long_literal + "!"), (std::vector<size_t>{1}));
+    EXPECT_EQ(set.matchAll(long_literal), (std::vector<size_t>{2}));
+    EXPECT_EQ(set.matchAll(long_literal + "x"), (std::vector<size_t>{1}));
+    EXPECT_TRUE(set.matchAll(std::string(149, 'x')).empty());
+}
+
+TEST(BitParallelSetTest, ReportsFirstAndAllMatches) {
+    const BitParallelSet set = BitParallelSet::compile(
+        std::vector<std::string>{"*.log", "app*", "*error*", "app.log", "???", "*", ""});
+
+    EXPECT_EQ(set.matchAll("app.log"), (std::vector<size_t>{0, 1, 3, 5}));
+    EXPECT_EQ(set.matchFirst("app.log"), 0u);
+    EXPECT_EQ(set.matchAll("an error occurred"), (std::vector<size_t>{2, 5}));
+    EXPECT_EQ(set.matchAll("abc"), (std::vector<size_t>{4, 5}));
+    EXPECT_EQ(set.matchAll(""), (std::vector<size_t>{5, 6}));
+
+    const BitParallelSet empty = BitParallelSet::compile(std::vector<std::string>{});
+    EXPECT_TRUE(empty.matchAll("anything").empty());
+}
+
+TEST(BitParallelSetTest, MatchesCharacterClasses) {
+    std::vector<std::vector<Token>> token_lists;
+    for (const char* pattern : {"IMG_[0-9][0-9].*", "*[!a-z]", "[a-c]*[x-z]"}) {
+        token_lists.push_back(Parser::parse(pattern, {.char_classes = true}).tokens);
+    }
+    const std::optional<BitParallelSet> set = BitParallelSet::compile(token_lists);
+    ASSERT_TRUE(set.has_value());
+
+    EXPECT_EQ(set->matchAll("IMG_42.png"), (std::vector<size_t>{0}));
+    EXPECT_EQ(set->matchAll("IMG_42.PNG"), (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(set->matchAll("IMG_4a.PNG"), (std::vector<size_t>{1}));
+    EXPECT_EQ(set->matchAll("b--y"), (std::vector<size_t>{2}));
+    EXPECT_TRUE(set->matchAll("d--y").empty());
+}
+
+TEST(BitParallelSetTest, RejectsAlternations) {
+    const std::vector<Token> alternation = Parser::parse("x{yy,zz}", {.alternation = true}).tokens;
+    EXPECT_FALSE(BitParallelSet::supports(alternation));
+    EXPECT_FALSE(BitParallelSet::compile({Parser::parse("x*").tokens, alternation}).has_value());
+    EXPECT_TRUE(BitParallelSet::compile({Parser::parse("x*").tokens}).has_value());
+}
+
+TEST(BitParallelSetTest, RejectsPathWildcards) {
+    for (const char* pattern : {"src/*.c", "src/**/x", "**"}) {
+        SCOPED_TRACE(pattern);
+        const std::vector<Token> tokens = Parser::parse(pattern, {.path = true}).tokens;
+        EXPECT_FALSE(BitParallelSet::supports(tokens));
+        EXPECT_FALSE(BitParallelSet::compile({tokens}).has_value());
+    }
+
+    // Without a '*' a path pattern only has classes and literals, which fit in one run of bits
+    const std::vector<Token> fixed = Parser::parse("a?/b", {.path = true}).tokens;
+    ASSERT_TRUE(BitParallelSet::supports(fixed));
+    EXPECT_EQ(BitParallelSet::compile({fixed})->matchAll("ax/b"), (std::vector<size_t>{0}));
+    EXPECT_TRUE(BitParallelSet::compile({fixed})->matchAll("a//b").empty());
+}
+
+TEST(PatternSetTest, EverySetAgreesWithGreedySolverOnCaseFoldedPatterns) {
+    std::vector<std::vector<Token>> token_lists;
+    for (const auto& test_case : case_insensitive_test_cases) {
+        token_lists.push_back(Parser::parse(test_case.pattern, {.case_insensitive = true}).tokens);
+        token_lists.push_back(Parser::parse(test_case.pattern).tokens);
+    }
+    const PatternSet pattern_set = PatternSet::compile(token_lists);
+    const BucketedPatternSet bucketed = BucketedPatternSet::compile(token_lists);
+    const CompactPatternSet compact = *CompactPatternSet::compile(token_lists);
+    const BitParallelSet bit_parallel = *BitParallelSet::compile(token_lists);
+
+    for (const auto& test_case : case_insensitive_test_cases) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+        std::vector<size_t> expected;
+        for (size_t id = 0; id < token_lists.size(); ++id) {
+            if (GreedySolver::runAndProfile(test_case.text, token_lists[id]).result) {
+                expected.push_back(id);
+            }
+        }
+        EXPECT_EQ(pattern_set.matchAll(test_case.text), expected);
+        EXPECT_EQ(bucketed.matchAll(test_case.text), expected);
+        EXPECT_EQ(compact.matchAll(test_case.text), expected);
+        EXPECT_EQ(bit_parallel.matchAll(test_case.text), expected);
+    }
+}
+
+TEST(PatternSetTest, RunsDialectPatternsOnTheAutomaton) {
+    std::vector<std::vector<Token>> token_lists;
+    std::vector<std::string> texts;
+    const std::pair<const std::vector<SolverTestCase>*, ParseOptions> dialects[] = {
+        {&alternation_test_cases, {.alternation = true}},
+        {&char_class_test_cases, {.char_classes = true}},
+        {&path_test_cases, {.path = true}}};
+    for (const auto& [test_cases, options] : dialects) {
+        for (const auto& test_case : *test_cases) {
+            token_lists.push_back(Parser::parse(test_case.pattern, options).tokens);
+            texts.push_back(test_case.text);
+        }
+    }
+    const PatternSet pattern_set = PatternSet::compile(token_lists);
+    const BucketedPatternSet bucketed = BucketedPatternSet::compile(token_lists);
+
+    for (const auto& text : texts) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << text << "\""));
+        std::vector<size_t> expected;
+        for (size_t id = 0; id < token_lists.size(); ++id) {
+            if (NfaSolver::runAndProfile(text, token_lists[id]).result) {
+                expected.push_back(id);
+            }
+        }
+        EXPECT_EQ(pattern_set.matchAll(text), expected);
+        EXPECT_EQ(bucketed.matchAll(text), expected);
+    }
+}
+
+TEST(RuleEngineTest, LastMatchingRuleWins) {
+    const RuleEngine rules =
+        RuleEngine::compile({"*.tmp", "!keep*.tmp", "keep-not.tmp", "build/*", "!build/*.txt"});
+    ASSERT_EQ(rules.size(), 5u);
+    EXPECT_TRUE(rules.isNegated(1));
+    EXPECT_FALSE(rules.isNegated(2));
+
+    EXPECT_EQ(rules.lastMatch("a.tmp"), 0u);
+    EXPECT_TRUE(rules.matches("a.tmp"));
+    EXPECT_EQ(rules.lastMatch("keep1.tmp"), 1u);
+    EXPECT_FALSE(rules.matches("keep1.tmp"));
+    EXPECT_EQ(rules.lastMatch("keep-not.tmp"), 2u);
+    EXPECT_TRUE(rules.matches("keep-not.tmp"));
+    EXPECT_EQ(rules.lastMatch("build/notes.txt"), 4u);
+    EXPECT_FALSE(rules.matches("build/notes.txt"));
+    EXPECT_TRUE(rules.matches("build/app.o"));
+    EXPECT_EQ(rules.lastMatch("src/main.cpp"), std::nullopt);
+    EXPECT_FALSE(rules.matches("src/main.cpp"));
+}
+
+TEST(RuleEngineTest, SplitsNegationsAndEscapedExclamationMarks) {
+    using Split = std::pair<bool, std::string_view>;
+    EXPECT_EQ(RuleEngine::splitRule("*.log"), Split(false, "*.log"));
+    EXPECT_EQ(RuleEngine::splitRule("!*.log"), Split(true, "*.log"));
+    EXPECT_EQ(RuleEngine::splitRule("\\!x*"), Split(false, "!x*"));
+    EXPECT_EQ(RuleEngine::splitRule("!\\!x*"), Split(true, "!x*"));
+    EXPECT_EQ(RuleEngine::splitRule("a\\!"), Split(false, "a\\!"));
+    EXPECT_EQ(RuleEngine::splitRule("!"), Split(true, ""));
+
+    const RuleEngine rules = RuleEngine::compile({"*", "\\!x*"});
+    EXPECT_EQ(rules.lastMatch("!xy"), 1u);
+    EXPECT_EQ(rules.lastMatch("\\!xy"), 0u);
+}
+
+TEST(RuleEngineTest, AgreesWithEvaluatingEveryRule) {
+    const std::vector<std::string> rule_list = {"*",    "!*.log", "?",    "!a*", "\\!x*",
+                                                "a?c*", "*.log",  "!abc", "*b*", "!"};
+    for (const auto& rule : rule_list) {
+        const std::string pattern(RuleEngine::splitRule(rule).second);
+        EXPECT_TRUE(Validator::validateRawString(pattern).empty()) << "rule: " << rule;
+        EXPECT_TRUE(Validator::validateParseResult(Parser::parse(pattern)).empty())
+            << "rule: " << rule;
+    }
+    const RuleEngine rules = RuleEngine::compile(rule_list);
+    const std::vector<std::string> texts = {"", "a", "abc", "abcd", "x.log", "!x", "bb", "a.log"};
+
+    for (const auto& text : texts) {
+        std::optional<size_t> expected;
+        for (size_t rule = 0; rule < rule_list.size(); ++rule) {
+            const std::string_view pattern = RuleEngine::splitRule(rule_list[rule]).second;
+            if (GreedySolver::runAndProfile(text, std::string(pattern)).result) {
+                expected = rule;
+            }
+        }
+        EXPECT_EQ(rules.lastMatch(text), expected) << "s: \"" << text << "\"";
+        EXPECT_EQ(rules.matches(text), expected && !rules.isNegated(*expected));
+    }
+
+    // Without negations, a match of any rule selects the text
+    const RuleEngine positive = RuleEngine::compile({"*.log", "app*.log", "*.txt"});
+    EXPECT_TRUE(positive.matches("app.log"));
+    EXPECT_TRUE(positive.matches("a.txt"));
+    EXPECT_FALSE(positive.matches("a.tmp"));
+}
+
+TEST(RuleEngineTest, ParsesRulesWithTheGivenOptions) {
+    const std::vector<std::string> rule_list = {"build/**", "!build/*.txt", "*.tmp"};
+    const RuleEngine rules = RuleEngine::compile(rule_list, {.path = true});
+    EXPECT_TRUE(rules.matches("build/out/app.o"));
+    EXPECT_FALSE(rules.matches("build/notes.txt"));
+    EXPECT_TRUE(rules.matches("build/docs/notes.txt"));  // '*' stops at '/'
+    EXPECT_TRUE(rules.matches("a.tmp"));
+    EXPECT_FALSE(rules.matches("src/a.tmp"));
+
+    // Without the path mode '*' crosses '/', so the exclusion covers every level
+    const RuleEngine plain = RuleEngine::compile(rule_list);
+    EXPECT_FALSE(plain.matches("build/docs/notes.txt"));
+    EXPECT_TRUE(plain.matches("src/a.tmp"));
+}
+
+TEST(LiteralPoolTest, InternsEachLiteralOnce) {
+    LiteralPool pool;
+    const std::uint32_t api = pool.intern("/api/");
+    const std::uint32_t json = pool.intern(".json");
+    EXPECT_EQ(pool.intern("/api/"), api);
+    EXPECT_EQ(pool.intern(".json"), json);
+    EXPECT_EQ(pool.bytes(), "/api/.json");
+
+    const PooledToken token = pool.intern(Token{TokenType::LITERAL_SEQUENCE, ".json"});
+    EXPECT_EQ(token.offset, json);
+    EXPECT_EQ(pool.view(token), ".json");
+    EXPECT_EQ(pool.intern(Token{TokenType::ANY_SEQUENCE}).length, 0u);
+}
+
+TEST(CompactPatternSetTest, AgreesWithGreedySolverOnEveryPattern) {
+    const std::vector<std::string> patterns = solverCasePatterns();
+    const CompactPatternSet set = CompactPatternSet::compile(patterns);
+    ASSERT_EQ(set.size(), patterns.size());
+
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+        const MatchBitset matches = set.match(test_case.text);
+
+        std::optional<size_t> first;
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            const bool expected = GreedySolver::runAndProfile(test_case.text, patterns[id]).result;
+            EXPECT_EQ(matches.test(id), expected) << "p: \"" << patterns[id] << "\"";
+            if (expected && !first) {
+                first = id;
+            }
+        }
+        EXPECT_EQ(set.matchFirst(test_case.text), first);
+    }
+}
+
+TEST(CompactPatternSetTest, SharesRepeatedLiterals) {
+    std::vector<std::string> patterns;
+    for (int i = 0; i < 1000; ++i) {
+        patterns.push_back("GET /api/*/" + std::to_string(i % 10) + ".json");
+    }
+    const size_t pool_size = std::string("GET /api/").size() + 10 * std::string("/0.json").size();
+    const CompactPatternSet set = CompactPatternSet::compile(patterns);
+    EXPECT_EQ(set.poolBytes(), pool_size);
+    EXPECT_EQ(set.matchAll("GET /api/users/3.json").size(), 100u);
+    EXPECT_EQ(set.matchFirst("GET /api/users/3.json"), 3u);
+    EXPECT_EQ(set.matchFirst("GET /api/3.json"), std::nullopt);
+
+    // Distinct patterns that share fragments take less memory than compiled programs
+    std::vector<std::string> hosts;
+    for (int i = 0; i < 1000; ++i) {
+        hosts.push_back("https://host-" + std::to_string(i) + ".example.com/api/*.json?*");
+    }
+    const CompactPatternSet compact = CompactPatternSet::compile(hosts);
+    EXPECT_LT(compact.spaceUsed(), PatternSet::compile(hosts).spaceUsed());
+    EXPECT_EQ(compact.matchAll("https://host-7.example.com/api/a.json?x=1"),
+              (std::vector<size_t>{7}));
+}
+
+TEST(CompactPatternSetTest, RejectsDialectPatterns) {
+    const std::pair<const char*, ParseOptions> dialects[] = {{"x{yy,zz}", {.alternation = true}},
+                                                             {"x[a-c]*", {.char_classes = true}},
+                                                             {"src/**/x", {.path = true}}};
+    for (const auto& [pattern, options] : dialects) {
+        SCOPED_TRACE(pattern);
+        const std::vector<Token> tokens = Parser::parse(pattern, options).tokens;
+        EXPECT_FALSE(CompactPatternSet::supports(tokens));
+        EXPECT_FALSE(CompactPatternSet::compile({Parser::parse("x*").tokens, tokens}).has_value());
+    }
+
+    // Case folding keeps every token poolable
+    const std::vector<Token> folded = Parser::parse("*.PNG", {.case_insensitive = true}).tokens;
+    ASSERT_TRUE(CompactPatternSet::supports(folded));
+    EXPECT_EQ(CompactPatternSet::compile({folded})->matchAll("logo.png"), (std::vector<size_t>{0}));
+}
+
+}  // namespace
\ No newline at end of file
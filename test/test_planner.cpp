@@ -0,0 +1,124 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "engine/planner.hpp"
+#include "solvers/auto.hpp"
+#include "solvers/greedy.hpp"
+#include "test_solver_cases.hpp"
+#include "utils/parser.hpp"
+
+namespace {
+
+/**
+ * @brief Parses a pattern and asks the planner for an engine.
+ */
+Engine choose(const std::string& pattern, std::size_t text_length) {
+    return Planner::choose(Parser::parse(pattern).tokens, text_length);
+}
+
+TEST(PlannerTest, AnalyzesPatternShape) {
+    const PatternShape shape = Planner::analyze(Parser::parse("ab*c??*defg").tokens);
+    EXPECT_EQ(shape.star_count, 2u);
+    EXPECT_EQ(shape.any_char_count, 2u);
+    EXPECT_EQ(shape.literal_length, 7u);
+    EXPECT_EQ(shape.longest_literal, 4u);
+    EXPECT_EQ(shape.min_text_length, 9u);
+    EXPECT_DOUBLE_EQ(shape.anyCharDensity(), 2.0 / 9.0);
+
+    EXPECT_EQ(Planner::analyze({}).min_text_length, 0u);
+    EXPECT_DOUBLE_EQ(Planner::analyze({}).anyCharDensity(), 0.0);
+}
+
+TEST(PlannerTest, PrefersGreedyWithoutSetupCost) {
+    // No '*': a single linear pass
+    EXPECT_EQ(choose("abc?e", 1 << 20), Engine::GREEDY);
+    // Short texts do not amortize compilation
+    EXPECT_EQ(choose("*needle*", Planner::short_text_length - 1), Engine::GREEDY);
+    // Nothing for a substring search to skip
+    EXPECT_EQ(choose("*a*b*c*", 4096), Engine::GREEDY);
+    EXPECT_EQ(choose("*ab???*", 4096), Engine::GREEDY);
+}
+
+TEST(PlannerTest, CompilesPatternsWithSearchableLiterals) {
+    EXPECT_EQ(choose("*needle*", 4096), Engine::BYTECODE);
+    EXPECT_EQ(choose("GET /api/*/users/*.json", Planner::short_text_length), Engine::BYTECODE);
+    // Generating native code for a single text does not pay off, however long the text
+    EXPECT_EQ(choose("*needle*", Planner::jit_text_length), Engine::BYTECODE);
+    const auto tokens = Parser::parse("*needle*").tokens;
+#if defined(APP_JIT_X86_64)
+    EXPECT_EQ(Planner::choose(tokens, Planner::jit_text_length, true), Engine::JIT);
+#else
+    EXPECT_EQ(Planner::choose(tokens, Planner::jit_text_length, true), Engine::BYTECODE);
+#endif
+    EXPECT_EQ(Planner::choose(tokens, Planner::jit_text_length - 1, true), Engine::BYTECODE);
+}
+
+TEST(PlannerTest, RunsDialectTokensOnTheAutomaton) {
+    const auto tokens = Parser::parse("*.{jpg,png}", {.alternation = true}).tokens;
+    const PatternShape shape = Planner::analyze(tokens);
+    EXPECT_TRUE(shape.usesDialect());
+    EXPECT_EQ(shape.alternation_count, 1u);
+    EXPECT_EQ(shape.position_count, 7u);  // The shared 'g' is factored out: *.{jp,pn}g
+    EXPECT_EQ(shape.min_text_length, 4u);
+    EXPECT_EQ(Planner::choose(tokens, 10), Engine::NFA);
+    EXPECT_EQ(Planner::choose(tokens, 1 << 20), Engine::NFA);
+
+    const auto class_tokens = Parser::parse("IMG_[0-9]*", {.char_classes = true}).tokens;
+    const PatternShape class_shape = Planner::analyze(class_tokens);
+    EXPECT_TRUE(class_shape.usesDialect());
+    EXPECT_EQ(class_shape.char_class_count, 1u);
+    EXPECT_EQ(class_shape.min_text_length, 5u);
+    EXPECT_EQ(Planner::choose(class_tokens, 1 << 20), Engine::NFA);
+
+    const auto path_tokens = Parser::parse("src/**/*.c", {.path = true}).tokens;
+    const PatternShape path_shape = Planner::analyze(path_tokens);
+    EXPECT_TRUE(path_shape.usesDialect());
+    EXPECT_EQ(path_shape.path_star_count, 2u);
+    EXPECT_EQ(path_shape.min_text_length, 6u);  // Only "src/" and ".c" are required
+    EXPECT_EQ(Planner::choose(path_tokens, 1 << 20), Engine::NFA);
+}
+
+TEST(PlannerTest, NeverPicksQuadraticSpaceOrExponentialEngines) {
+    for (const auto& test_case : solver_test_cases) {
+        const Engine engine = choose(test_case.pattern, test_case.text.length());
+        EXPECT_NE(engine, Engine::RECURSIVE);
+        EXPECT_NE(engine, Engine::MEMO);
+        EXPECT_NE(engine, Engine::DP);
+    }
+}
+
+TEST(AutoSolverTest, ReportsTheChosenEngine) {
+    const std::string text = std::string(4096, 'x') + "needle" + std::string(100, 'y');
+    SolverProfile profile = AutoSolver::runAndProfile(text, "*needle*");
+    EXPECT_TRUE(profile.result);
+    EXPECT_EQ(profile.engine, "bytecode");
+
+    // The per-call solver never generates native code
+    profile = AutoSolver::runAndProfile(std::string(Planner::jit_text_length, 'x') + "needle",
+                                        "*needle*");
+    EXPECT_TRUE(profile.result);
+    EXPECT_EQ(profile.engine, "bytecode");
+
+    profile = AutoSolver::runAndProfile("short", "s*t");
+    EXPECT_TRUE(profile.result);
+    EXPECT_EQ(profile.engine, "greedy");
+}
+
+TEST(AutoSolverTest, EveryEngineAgreesWithGreedySolver) {
+    const std::vector<Engine> engines = {Engine::RECURSIVE, Engine::MEMO, Engine::DP,
+                                         Engine::GREEDY,    Engine::BYTECODE, Engine::JIT,
+                                         Engine::NFA};
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "Test Case: " << test_case.description));
+        const auto tokens = Parser::parse(test_case.pattern).tokens;
+        for (Engine engine : engines) {
+            SolverProfile profile = AutoSolver::runEngine(engine, test_case.text, tokens);
+            EXPECT_EQ(profile.result, test_case.expected_result);
+            EXPECT_EQ(profile.engine, engineToString(engine));
+        }
+    }
+}
+
+}  // namespace
\ No newline at end of file
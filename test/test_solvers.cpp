@@ -1,10 +1,27 @@
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "engine/jit.hpp"
+#include "engine/nfa.hpp"
+#include "engine/path.hpp"
+#include "solvers/auto.hpp"
+#include "solvers/bytecode.hpp"
 #include "solvers/dp.hpp"
 #include "solvers/greedy.hpp"
+#include "solvers/jit.hpp"
 #include "solvers/memo.hpp"
+#include "solvers/nfa.hpp"
 #include "solvers/recursive.hpp"
 #include "test_solver_cases.hpp"
+#include "utils/masked_literal.hpp"
+#include "utils/simd.hpp"
 #include "wildcard_matcher.hpp"
 
 /**
@@ -48,13 +65,454 @@ TYPED_TEST_P(WildcardSolverTest, MatchesAccordingToDefinedCases) {
     }
 }
 
+/**
+ * @brief Verifies case-insensitive literals, which every solver runs on the same tokens.
+ */
+TYPED_TEST_P(WildcardSolverTest, MatchesCaseInsensitiveLiterals) {
+    for (const auto& test_case : case_insensitive_test_cases) {
+        SCOPED_TRACE((testing::Message()
+                      << "Test Case: " << test_case.description << "\n  s: \"" << test_case.text
+                      << "\"" << "\n  p: \"" << test_case.pattern << "\""));
+
+        const auto tokens = Parser::parse(test_case.pattern, {.case_insensitive = true}).tokens;
+        EXPECT_EQ(TypeParam::runAndProfile(test_case.text, tokens).result,
+                  test_case.expected_result);
+    }
+}
+
+/**
+ * @brief Verifies raw byte texts with embedded NULs, passed without copying or validation.
+ */
+TYPED_TEST_P(WildcardSolverTest, MatchesBinaryTexts) {
+    for (const auto& test_case : binary_test_cases) {
+        SCOPED_TRACE((testing::Message() << "Test Case: " << test_case.description));
+
+        const auto tokens = Parser::parse(test_case.pattern, {.binary = true}).tokens;
+        EXPECT_EQ(runSolver<TypeParam>(std::as_bytes(std::span(test_case.text)), tokens).result,
+                  test_case.expected_result);
+    }
+}
+
+/**
+ * @brief Verifies dialect patterns, which every solver hands to the automaton rather than
+ * misreading their tokens.
+ */
+TYPED_TEST_P(WildcardSolverTest, MatchesDialectPatterns) {
+    const std::pair<const std::vector<SolverTestCase>*, ParseOptions> dialects[] = {
+        {&alternation_test_cases, {.alternation = true}},
+        {&char_class_test_cases, {.char_classes = true}},
+        {&path_test_cases, {.path = true}}};
+    for (const auto& [test_cases, options] : dialects) {
+        for (const auto& test_case : *test_cases) {
+            SCOPED_TRACE((testing::Message() << "Test Case: " << test_case.description
+                                             << "\n  s: \"" << test_case.text << "\""
+                                             << "\n  p: \"" << test_case.pattern << "\""));
+
+            const auto tokens = Parser::parse(test_case.pattern, options).tokens;
+            EXPECT_EQ(TypeParam::runAndProfile(test_case.text, tokens).result,
+                      test_case.expected_result);
+        }
+    }
+}
+
 // Register the test case implementation with the test suite.
 // This connects the logic inside the TYPED_TEST_P block to the suite name.
-REGISTER_TYPED_TEST_SUITE_P(WildcardSolverTest, MatchesAccordingToDefinedCases);
+REGISTER_TYPED_TEST_SUITE_P(WildcardSolverTest, MatchesAccordingToDefinedCases,
+                            MatchesCaseInsensitiveLiterals, MatchesBinaryTexts,
+                            MatchesDialectPatterns);
 
 // A type list containing all solver classes to be tested.
-using SolverImplementations = ::testing::Types<RecursiveSolver, MemoSolver, DpSolver, GreedySolver>;
+using SolverImplementations = ::testing::Types<RecursiveSolver, MemoSolver, DpSolver, GreedySolver,
+                                               BytecodeSolver, JitSolver, NfaSolver, AutoSolver>;
 
 // Instantiate the test suite for each type in the SolverImplementations list.
 // The first argument is a user-defined prefix for the test suite name in the final output.
-INSTANTIATE_TYPED_TEST_SUITE_P(AllSolvers, WildcardSolverTest, SolverImplementations);
\ No newline at end of file
+INSTANTIATE_TYPED_TEST_SUITE_P(AllSolvers, WildcardSolverTest, SolverImplementations);
+
+/**
+ * @brief Verifies that a pattern JIT-compiled once agrees with GreedySolver on every test case, and
+ * that native code is actually generated on targets that support it.
+ */
+TEST(JitMatcherTest, AgreesWithGreedySolver) {
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "Test Case: " << test_case.description));
+
+        const auto tokens = Parser::parse(test_case.pattern).tokens;
+        const JitMatcher matcher = JitMatcher::compile(tokens);
+#if defined(APP_JIT_X86_64)
+        EXPECT_TRUE(matcher.isNative());
+#endif
+        EXPECT_EQ(matcher.match(test_case.text),
+                  GreedySolver::runAndProfile(test_case.text, tokens).result);
+    }
+}
+
+/**
+ * @brief Expands every ALTERNATION of a token vector, for checking against the basic solvers.
+ */
+std::vector<std::vector<Token>> expandAlternations(const std::vector<Token>& p_tokens) {
+    std::vector<std::vector<Token>> expansions = {{}};
+    for (const auto& token : p_tokens) {
+        std::vector<std::vector<Token>> next;
+        for (const auto& prefix : expansions) {
+            if (token.type != TokenType::ALTERNATION) {
+                next.push_back(prefix);
+                next.back().push_back(token);
+                continue;
+            }
+            for (const auto& alternative : token.alternatives) {
+                for (const auto& tail : expandAlternations(alternative)) {
+                    next.push_back(prefix);
+                    next.back().insert(next.back().end(), tail.begin(), tail.end());
+                }
+            }
+        }
+        expansions = std::move(next);
+    }
+    return expansions;
+}
+
+/**
+ * @brief Verifies brace alternation on the NFA engine and through AutoSolver, and checks the result
+ * against the expanded patterns on GreedySolver.
+ */
+TEST(NfaSolverTest, MatchesBraceAlternation) {
+    for (const auto& test_case : alternation_test_cases) {
+        SCOPED_TRACE((testing::Message()
+                      << "Test Case: " << test_case.description << "\n  s: \"" << test_case.text
+                      << "\"" << "\n  p: \"" << test_case.pattern << "\""));
+
+        const auto tokens = Parser::parse(test_case.pattern, {.alternation = true}).tokens;
+        EXPECT_EQ(NfaSolver::runAndProfile(test_case.text, tokens).result,
+                  test_case.expected_result);
+
+        const SolverProfile profile = AutoSolver::runAndProfile(test_case.text, tokens);
+        EXPECT_EQ(profile.result, test_case.expected_result);
+        EXPECT_EQ(profile.engine, "nfa");
+
+        bool expanded_result = false;
+        for (const auto& expansion : expandAlternations(tokens)) {
+            expanded_result =
+                expanded_result || GreedySolver::runAndProfile(test_case.text, expansion).result;
+        }
+        EXPECT_EQ(expanded_result, test_case.expected_result);
+    }
+}
+
+/**
+ * @brief Verifies that nested and repeated braces compile to an automaton linear in the pattern
+ * length rather than in the number of expansions.
+ */
+TEST(NfaSolverTest, BracesDoNotExpand) {
+    // 2^24 expansions, 48 positions
+    std::string pattern;
+    std::string text;
+    for (int i = 0; i < 24; ++i) {
+        pattern += "{a,b}";
+        text += i % 3 == 0 ? 'a' : 'b';
+    }
+    const NfaMatcher matcher =
+        NfaMatcher::compile(Parser::parse(pattern, {.alternation = true}).tokens);
+    EXPECT_EQ(matcher.positionCount(), 48u);
+    EXPECT_TRUE(matcher.match(text));
+    EXPECT_FALSE(matcher.match(text + "a"));
+
+    // Deep nesting: {a,{a,{a,...{a,b}...}}} with 200 levels
+    pattern.clear();
+    for (int i = 0; i < 200; ++i) {
+        pattern += "{a,";
+    }
+    pattern += "b" + std::string(200, '}');
+    const NfaMatcher nested =
+        NfaMatcher::compile(Parser::parse(pattern, {.alternation = true}).tokens);
+    EXPECT_LE(nested.positionCount(), 201u);
+    EXPECT_TRUE(nested.match("a"));
+    EXPECT_TRUE(nested.match("b"));
+    EXPECT_FALSE(nested.match("ab"));
+}
+
+/**
+ * @brief Verifies character classes on the NFA engine and through AutoSolver.
+ */
+TEST(NfaSolverTest, MatchesCharacterClasses) {
+    for (const auto& test_case : char_class_test_cases) {
+        SCOPED_TRACE((testing::Message()
+                      << "Test Case: " << test_case.description << "\n  s: \"" << test_case.text
+                      << "\"" << "\n  p: \"" << test_case.pattern << "\""));
+
+        const auto tokens = Parser::parse(test_case.pattern, {.char_classes = true}).tokens;
+        EXPECT_EQ(NfaSolver::runAndProfile(test_case.text, tokens).result,
+                  test_case.expected_result);
+
+        const SolverProfile profile = AutoSolver::runAndProfile(test_case.text, tokens);
+        EXPECT_EQ(profile.result, test_case.expected_result);
+        EXPECT_EQ(profile.engine, "nfa");
+    }
+}
+
+/**
+ * @brief Verifies the UTF-8 mode on the NFA engine and through AutoSolver.
+ */
+TEST(NfaSolverTest, MatchesUtf8CodePoints) {
+    for (const auto& test_case : utf8_test_cases) {
+        SCOPED_TRACE((testing::Message()
+                      << "Test Case: " << test_case.description << "\n  s: \"" << test_case.text
+                      << "\"" << "\n  p: \"" << test_case.pattern << "\""));
+
+        const auto tokens = Parser::parse(test_case.pattern, {.utf8 = true}).tokens;
+        EXPECT_EQ(NfaSolver::runAndProfile(test_case.text, tokens).result,
+                  test_case.expected_result);
+        EXPECT_EQ(AutoSolver::runAndProfile(test_case.text, tokens).result,
+                  test_case.expected_result);
+    }
+}
+
+/**
+ * @brief Verifies path mode on the segment-wise matcher, the whole-pattern automaton and through
+ * AutoSolver.
+ */
+TEST(NfaSolverTest, MatchesPathSegments) {
+    for (const auto& test_case : path_test_cases) {
+        SCOPED_TRACE((testing::Message()
+                      << "Test Case: " << test_case.description << "\n  s: \"" << test_case.text
+                      << "\"" << "\n  p: \"" << test_case.pattern << "\""));
+
+        const auto tokens = Parser::parse(test_case.pattern, {.path = true}).tokens;
+        EXPECT_EQ(NfaMatcher::compile(tokens).match(test_case.text), test_case.expected_result);
+        if (const std::optional<PathMatcher> path = PathMatcher::compile(tokens)) {
+            EXPECT_EQ(path->match(test_case.text), test_case.expected_result);
+        }
+        EXPECT_EQ(NfaSolver::runAndProfile(test_case.text, tokens).result,
+                  test_case.expected_result);
+        EXPECT_EQ(AutoSolver::runAndProfile(test_case.text, tokens).result,
+                  test_case.expected_result);
+    }
+}
+
+/**
+ * @brief A character-by-character reference matcher for literals, case-folded literals, '?', '*',
+ * classes and the path wildcards.
+ */
+bool referenceMatch(std::string_view s, const std::vector<Token>& p_tokens) {
+    // matched[i]: the tokens seen so far match the first i characters
+    std::vector<bool> matched(s.length() + 1, false);
+    matched[0] = true;
+    for (const auto& token : p_tokens) {
+        if (token.type == TokenType::ANY_SEQUENCE || token.type == TokenType::SEGMENT_SEQUENCE) {
+            for (size_t i = 1; i <= s.length(); ++i) {
+                matched[i] = matched[i] ||
+                             (matched[i - 1] &&
+                              (token.type == TokenType::ANY_SEQUENCE || s[i - 1] != '/'));
+            }
+            continue;
+        }
+        if (token.type == TokenType::ANY_SEGMENTS) {
+            // Any matched prefix may be extended up to and including a later '/'
+            bool matched_before = false;
+            for (size_t i = 1; i <= s.length(); ++i) {
+                matched_before = matched_before || matched[i - 1];
+                matched[i] = matched[i] || (matched_before && s[i - 1] == '/');
+            }
+            continue;
+        }
+        const std::string characters = token.value.value_or(std::string(1, '\0'));
+        for (char c : characters) {
+            for (size_t i = s.length(); i > 0; --i) {
+                const auto text_char = static_cast<unsigned char>(s[i - 1]);
+                const bool folds = token.fold_case && text_char >= 'A' && text_char <= 'Z';
+                const auto folded_char =
+                    static_cast<unsigned char>(folds ? text_char | 0x20 : text_char);
+                const bool accepts = token.type == TokenType::ANY_CHAR ||
+                                     (token.type == TokenType::CHAR_CLASS &&
+                                      token.char_class.contains(text_char)) ||
+                                     (token.type == TokenType::LITERAL_SEQUENCE &&
+                                      static_cast<unsigned char>(c) == folded_char);
+                matched[i] = matched[i - 1] && accepts;
+            }
+            matched[0] = false;
+        }
+    }
+    return matched[s.length()];
+}
+
+/**
+ * @brief Verifies that skipping over runs of bytes while a '*' is the only active position gives
+ * the same results as a stepwise simulation, for automata of one and of several words.
+ */
+TEST(NfaSolverTest, SkipsAgreeWithTheReferenceMatcher) {
+    const std::vector<std::string> pieces = {"a", "b", "ab", "[ab]", "[!a]", "[b-c]", "?", "*"};
+    std::mt19937 random(12345);
+    for (int round = 0; round < 400; ++round) {
+        std::string pattern;
+        const size_t piece_count = round % 4 == 0 ? 60 : 1 + random() % 8;
+        for (size_t k = 0; k < piece_count; ++k) {
+            pattern += pieces[random() % pieces.size()];
+        }
+        const auto tokens = Parser::parse(pattern, {.char_classes = true}).tokens;
+        const NfaMatcher matcher = NfaMatcher::compile(tokens);
+
+        for (int t = 0; t < 20; ++t) {
+            std::string text(random() % 90, 'a');
+            for (char& c : text) {
+                c = "abcd"[random() % 4];
+            }
+            SCOPED_TRACE((testing::Message() << "s: \"" << text << "\"\n  p: \"" << pattern
+                                             << "\""));
+            EXPECT_EQ(matcher.match(text), referenceMatch(text, tokens));
+        }
+    }
+}
+
+/**
+ * @brief Verifies that matching segment by segment, with '**' backtracking over whole segments,
+ * agrees with the whole-pattern automaton and a stepwise simulation.
+ */
+TEST(PathMatcherTest, AgreesWithTheReferenceMatcher) {
+    const std::vector<std::string> pieces = {"a", "b", "/", "/", "*", "?", "**/", "/**", "[!a]"};
+    std::mt19937 random(4096);
+    size_t segment_wise = 0;
+    for (int round = 0; round < 600; ++round) {
+        std::string pattern;
+        for (size_t k = 0, count = 1 + random() % 9; k < count; ++k) {
+            pattern += pieces[random() % pieces.size()];
+        }
+        const auto tokens = Parser::parse(pattern, {.char_classes = true, .path = true}).tokens;
+        const NfaMatcher nfa = NfaMatcher::compile(tokens);
+        const std::optional<PathMatcher> path = PathMatcher::compile(tokens);
+        segment_wise += path ? 1 : 0;
+
+        for (int t = 0; t < 20; ++t) {
+            std::string text(random() % 16, 'a');
+            for (char& c : text) {
+                c = "ab//"[random() % 4];
+            }
+            SCOPED_TRACE((testing::Message() << "s: \"" << text << "\"\n  p: \"" << pattern
+                                             << "\""));
+            const bool expected = referenceMatch(text, tokens);
+            EXPECT_EQ(nfa.match(text), expected);
+            if (path) {
+                EXPECT_EQ(path->match(text), expected);
+            }
+        }
+    }
+    EXPECT_GT(segment_wise, 300u);
+}
+
+/**
+ * @brief Verifies that the masked windows, the bytecode and the NFA all fold case exactly like a
+ * stepwise simulation, including on literals longer than one vector block.
+ */
+TEST(CaseInsensitiveTest, AgreesWithTheReferenceMatcher) {
+    const std::vector<std::string> pieces = {"a", "B", "aB", "1", "@", "?", "*",
+                                             "xYxYxYxYxYxYxYxYz"};
+    std::mt19937 random(2024);
+    for (int round = 0; round < 400; ++round) {
+        std::string pattern;
+        for (size_t k = 0, count = 1 + random() % 8; k < count; ++k) {
+            pattern += pieces[random() % pieces.size()];
+        }
+        const auto tokens = Parser::parse(pattern, {.case_insensitive = true}).tokens;
+        const BytecodeProgram program = BytecodeProgram::compile(tokens);
+        const JitMatcher jit = JitMatcher::compile(tokens);
+        const NfaMatcher nfa = NfaMatcher::compile(tokens);
+
+        for (int t = 0; t < 20; ++t) {
+            std::string text(random() % 60, 'a');
+            for (char& c : text) {
+                c = "aAbB1@`xXyYz"[random() % 12];
+            }
+            SCOPED_TRACE((testing::Message() << "s: \"" << text << "\"\n  p: \"" << pattern
+                                             << "\""));
+            const bool expected = referenceMatch(text, tokens);
+            EXPECT_EQ(GreedySolver::runAndProfile(text, tokens).result, expected);
+            EXPECT_EQ(program.match(text), expected);
+            EXPECT_EQ(jit.match(text), expected);
+            EXPECT_EQ(nfa.match(text), expected);
+        }
+    }
+}
+
+/**
+ * @brief Verifies that lazily compiled windows equal the eagerly compiled ones and are only built
+ * for the runs that are looked up.
+ */
+TEST(MaskedLiteralTest, CompilesRunsOnFirstUse) {
+    const auto tokens = Parser::parse("ab?*c*?d").tokens;
+    const std::vector<MaskedLiteral> eager = MaskedLiteralCompiler::compile(tokens);
+    LazyMaskedLiterals lazy(tokens);
+    EXPECT_EQ(lazy.spaceUsed(), 0u);
+
+    const MaskedLiteral& head = lazy[0];
+    EXPECT_EQ(head.bytes, eager[0].bytes);
+    EXPECT_EQ(head.mask, eager[0].mask);
+    EXPECT_EQ(head.token_count, 2u);
+    const std::size_t head_only = lazy.spaceUsed();
+    EXPECT_GT(head_only, 0u);
+
+    const MaskedLiteral& tail = lazy[5];
+    EXPECT_EQ(tail.bytes, eager[5].bytes);
+    EXPECT_EQ(tail.token_count, 2u);
+    EXPECT_EQ(lazy[3].bytes, "c");
+    EXPECT_GE(lazy.spaceUsed(), head_only);
+}
+
+/**
+ * @brief Verifies the vectorized case-folded compare and search at every length and offset.
+ */
+TEST(CaseInsensitiveTest, FoldedCompareAndSearchAgreeWithScalarCode) {
+    const std::string text = "Aa@`Zz[{" + std::string(70, 'Q') + "qQ\x80\xC1\xE1" + "Mm";
+    std::string lower = text;
+    for (char& c : lower) {
+        c = c >= 'A' && c <= 'Z' ? static_cast<char>(c + 0x20) : c;
+    }
+    for (size_t len = 0; len <= text.length(); ++len) {
+        EXPECT_TRUE(foldedEquals(text.data(), lower.data(), len));
+        if (len > 0) {
+            std::string wrong = lower;
+            wrong[len - 1] = static_cast<char>(wrong[len - 1] ^ 0x01);
+            EXPECT_FALSE(foldedEquals(text.data(), wrong.data(), len));
+        }
+    }
+    for (char letter : {'a', 'q', 'm', 'z'}) {
+        for (size_t pos = 0; pos <= text.length(); ++pos) {
+            const char* expected = nullptr;
+            for (size_t i = pos; i < text.length() && expected == nullptr; ++i) {
+                expected = (text[i] | 0x20) == letter ? text.data() + i : nullptr;
+            }
+            ASSERT_EQ(findFoldedByte(text.data() + pos, text.length() - pos, letter), expected);
+        }
+    }
+}
+
+/**
+ * @brief Verifies the vectorized byte-class search against the bitmap at every start offset.
+ */
+TEST(ByteClassSearchTest, AgreesWithTheBitmap) {
+    std::mt19937_64 random(42);
+    std::string text(300, '\0');
+    for (char& c : text) {
+        c = static_cast<char>(random() % 256);
+    }
+
+    std::vector<std::vector<std::uint64_t>> classes = {
+        {0, 0, 0, 0}, {~0ull, ~0ull, ~0ull, ~0ull}, {0, 0, 0, 1ull << 63}, {1, 0, 0, 0}};
+    for (int k = 0; k < 20; ++k) {
+        // Sparse random classes, so that hits are spread over the text
+        classes.push_back({random() & random() & random(), random() & random() & random(),
+                           random() & random() & random(), random() & random() & random()});
+    }
+    for (const auto& bits : classes) {
+        const ByteClassTable table = ByteClassTable::build(bits.data());
+        for (size_t pos = 0; pos <= text.length(); ++pos) {
+            size_t expected = static_cast<size_t>(-1);
+            for (size_t i = pos; i < text.length(); ++i) {
+                const auto c = static_cast<unsigned char>(text[i]);
+                if (((bits[c / 64] >> (c % 64)) & 1) != 0) {
+                    expected = i;
+                    break;
+                }
+            }
+            ASSERT_EQ(findByteInClass(text.data(), text.length(), pos, table), expected);
+        }
+    }
+}
\ No newline at end of file
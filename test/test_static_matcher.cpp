@@ -0,0 +1,71 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "solvers/greedy.hpp"
+#include "solvers/static_matcher.hpp"
+#include "utils/parser.hpp"
+#include "utils/static_parser.hpp"
+#include "wildcard_matcher.hpp"
+
+namespace {
+
+// The specialized matchers satisfy the solver concept and are evaluable at compile time.
+static_assert(WildcardSolver<StaticMatcher<"*.log">>);
+static_assert(StaticMatcher<"*.log">::match("app.log"));
+static_assert(!StaticMatcher<"*.log">::match("app.txt"));
+static_assert(StaticMatcher<"2024-?\?-??T*">::match("2024-05-17T09:41"));
+static_assert(StaticMatcher<"a\\*b">::match("a*b"));
+static_assert(!StaticMatcher<"a\\*b">::match("axb"));
+
+// A text corpus shared by all agreement checks below.
+const std::vector<std::string> texts = {
+    "",         "a",         "ab",           "abc",         "app.log",     "app.log.gz",
+    "log",      ".log",      "mississippi",  "aab",         "abacde",      "a*b",
+    "a?c",      "x/y/z.log", "GET /api/v1",  "GET /api/v1/users/42.json", "2024-05-17T09:41"};
+
+/**
+ * @brief Checks that StaticMatcher<Pattern> tokenizes like Parser and matches like GreedySolver.
+ */
+template <FixedString Pattern>
+void expectAgreesWithRuntime() {
+    SCOPED_TRACE(testing::Message() << "p: \"" << Pattern.view() << "\"");
+    const auto runtime_tokens = Parser::parse(Pattern.view()).tokens;
+    EXPECT_EQ(StaticMatcher<Pattern>::tokens(), runtime_tokens);
+
+    for (const auto& text : texts) {
+        SCOPED_TRACE(testing::Message() << "s: \"" << text << "\"");
+        SolverProfile profile = runSolver<StaticMatcher<Pattern>>(text, runtime_tokens);
+        EXPECT_EQ(profile.result, GreedySolver::runAndProfile(text, runtime_tokens).result);
+    }
+}
+
+TEST(StaticMatcherTest, AgreesWithRuntimeParserAndGreedySolver) {
+    expectAgreesWithRuntime<"">();
+    expectAgreesWithRuntime<"*">();
+    expectAgreesWithRuntime<"**">();
+    expectAgreesWithRuntime<"abc">();
+    expectAgreesWithRuntime<"a?c">();
+    expectAgreesWithRuntime<"*.log">();
+    expectAgreesWithRuntime<"app*">();
+    expectAgreesWithRuntime<"a*b">();
+    expectAgreesWithRuntime<"a*ab">();
+    expectAgreesWithRuntime<"m*iss*pi">();
+    expectAgreesWithRuntime<"a*c?e">();
+    expectAgreesWithRuntime<"*a*b">();
+    expectAgreesWithRuntime<"?*">();
+    expectAgreesWithRuntime<"*?.???">();
+    expectAgreesWithRuntime<"a\\*b">();
+    expectAgreesWithRuntime<"a\\?c">();
+    expectAgreesWithRuntime<"GET /api/*/users/*.json">();
+    expectAgreesWithRuntime<"*/*.log">();
+}
+
+TEST(StaticMatcherTest, ReportsProfile) {
+    SolverProfile profile = StaticMatcher<"*.log">::runAndProfile("server.log");
+    EXPECT_TRUE(profile.result);
+    EXPECT_EQ(profile.space_used_bytes, sizeof(std::size_t));
+}
+
+}  // namespace
\ No newline at end of file
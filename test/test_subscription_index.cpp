@@ -0,0 +1,84 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "multi/subscription_index.hpp"
+#include "solvers/greedy.hpp"
+#include "test_solver_cases.hpp"
+
+namespace {
+
+using Ids = std::vector<SubscriptionIndex::SubscriptionId>;
+
+TEST(SubscriptionIndexTest, AgreesWithGreedySolverOnEveryPattern) {
+    SubscriptionIndex index;
+    std::vector<std::string> patterns;
+    for (const auto& test_case : solver_test_cases) {
+        EXPECT_EQ(index.add(test_case.pattern), patterns.size());
+        patterns.push_back(test_case.pattern);
+    }
+    ASSERT_EQ(index.size(), patterns.size());
+
+    for (const auto& test_case : solver_test_cases) {
+        SCOPED_TRACE((testing::Message() << "s: \"" << test_case.text << "\""));
+        Ids expected;
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            if (GreedySolver::runAndProfile(test_case.text, patterns[id]).result) {
+                expected.push_back(id);
+            }
+        }
+        EXPECT_EQ(index.match(test_case.text), expected);
+    }
+}
+
+TEST(SubscriptionIndexTest, AddsAndRemovesIndividualSubscriptions) {
+    SubscriptionIndex index;
+    const auto sensors = index.add("sensors/*/temperature");
+    const auto kitchen = index.add("sensors/kitchen/*");
+    const auto any_alert = index.add("*/alert");
+    const auto exact = index.add("sensors/kitchen/temperature");
+
+    EXPECT_EQ(index.match("sensors/kitchen/temperature"), (Ids{sensors, kitchen, exact}));
+    EXPECT_EQ(index.match("sensors/alert"), (Ids{any_alert}));
+
+    EXPECT_TRUE(index.remove(kitchen));
+    EXPECT_FALSE(index.remove(kitchen));
+    EXPECT_EQ(index.match("sensors/kitchen/temperature"), (Ids{sensors, exact}));
+
+    EXPECT_TRUE(index.remove(exact));
+    EXPECT_TRUE(index.remove(any_alert));
+    EXPECT_EQ(index.match("sensors/kitchen/temperature"), (Ids{sensors}));
+    EXPECT_TRUE(index.match("sensors/alert").empty());
+    EXPECT_EQ(index.size(), 1u);
+
+    // IDs are never reused, even after the trie branch was pruned
+    const auto again = index.add("sensors/kitchen/*");
+    EXPECT_GT(again, exact);
+    EXPECT_EQ(index.match("sensors/kitchen/humidity"), (Ids{again}));
+}
+
+TEST(SubscriptionIndexTest, ServesMatchesWhileSubscriptionsChange) {
+    SubscriptionIndex index;
+    const auto stable = index.add("orders/*/created");
+    std::atomic<bool> done = false;
+
+    std::thread writer([&] {
+        for (int i = 0; i < 2000; ++i) {
+            const auto id = index.add("orders/" + std::to_string(i % 50) + "/*");
+            index.remove(id);
+        }
+        done = true;
+    });
+    while (!done) {
+        const Ids ids = index.match("orders/7/created");
+        ASSERT_FALSE(ids.empty());
+        EXPECT_EQ(ids.front(), stable);
+    }
+    writer.join();
+    EXPECT_EQ(index.size(), 1u);
+}
+
+}  // namespace
\ No newline at end of file
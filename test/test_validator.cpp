@@ -1,8 +1,17 @@
 // test/test_validator.cpp
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "engine/cost_model.hpp"
+#include "engine/lint.hpp"
 #include "utils/issues.hpp"
 #include "utils/parser.hpp"
+#include "utils/simd.hpp"
 #include "utils/validator.hpp"
 
 namespace {
@@ -31,6 +40,96 @@ TEST_F(ValidatorTest, DetectsMultiByteCharacter) {
         << "The error message should pinpoint the correct position.";
 }
 
+// --- Tests for Validator::validateUtf8String ---
+
+TEST_F(ValidatorTest, AcceptsWellFormedUtf8AndReportsAscii) {
+    bool ascii = false;
+    EXPECT_TRUE(Validator::validateUtf8String("plain-ascii?*", &ascii).empty());
+    EXPECT_TRUE(ascii);
+
+    // Two-, three- and four-byte characters, past the first vector block
+    EXPECT_TRUE(Validator::validateUtf8String(
+                    "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 \xE5\x8C\x97\xE4\xBA\xAC "
+                    "\xF4\x8F\xBF\xBF \xEF\xBF\xBF \xC2\x80",
+                    &ascii)
+                    .empty());
+    EXPECT_FALSE(ascii);
+}
+
+TEST_F(ValidatorTest, DetectsMalformedUtf8) {
+    const std::vector<std::pair<std::string, size_t>> cases = {
+        {"ab\x80", 3},                          // Stray continuation byte
+        {"a\xC0\xAF", 2},                       // Overlong two-byte form
+        {"\xE0\x80\xAF", 1},                    // Overlong three-byte form
+        {"x\xED\xA0\x80", 2},                   // Surrogate
+        {"\xF4\x90\x80\x80", 1},                // Above U+10FFFF
+        {"\xC3\xA9\xE2\x82", 3},                // Truncated at the end
+        {std::string(40, 'a') + "\xC3(", 41}};  // Missing continuation after a vector block
+    for (const auto& [text, position] : cases) {
+        const auto issues = Validator::validateUtf8String(text);
+        ASSERT_EQ(issues.size(), 1);
+        EXPECT_EQ(issues[0].code, IssueCode::INVALID_UTF8_SEQUENCE);
+        EXPECT_TRUE(issues[0].isError());
+        EXPECT_NE(issues[0].message.find("position " + std::to_string(position)),
+                  std::string::npos)
+            << issues[0].message;
+    }
+}
+
+TEST_F(ValidatorTest, VectorizedUtf8ValidationAgreesWithDecoding) {
+    // Reference: decode each sequence and check its length, range and continuation bytes
+    const auto reference = [](const std::string& s) -> size_t {
+        for (size_t i = 0; i < s.size();) {
+            const auto lead = static_cast<unsigned char>(s[i]);
+            size_t length = 0;
+            if (lead < 0x80) {
+                length = 1;
+            } else if ((lead & 0xE0) == 0xC0) {
+                length = 2;
+            } else if ((lead & 0xF0) == 0xE0) {
+                length = 3;
+            } else if ((lead & 0xF8) == 0xF0) {
+                length = 4;
+            }
+            if (length == 0 || i + length > s.size()) {
+                return i;
+            }
+            std::uint32_t code_point = length == 1 ? lead : lead & (0x7F >> length);
+            for (size_t k = 1; k < length; ++k) {
+                const auto c = static_cast<unsigned char>(s[i + k]);
+                if ((c & 0xC0) != 0x80) {
+                    return i;
+                }
+                code_point = code_point << 6 | (c & 0x3F);
+            }
+            const std::uint32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+            if (code_point < minimum[length] || code_point > 0x10FFFF ||
+                (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+                return i;
+            }
+            i += length;
+        }
+        return static_cast<size_t>(-1);
+    };
+
+    // The first five pieces are valid; odd rounds mix in malformed and boundary sequences
+    const std::vector<std::string> pieces = {
+        "a",    "xyz",      "\xC3\xA9",     "\xE2\x82\xAC",     "\xF0\x9F\x98\x80",
+        "\x80", "\xC0\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xFF",
+        "\xC3", "\xE2\x82", "\xF0\x9F\x98", "\xED\x9F\xBF",     "\xF4\x8F\xBF\xBF"};
+    std::mt19937 random(99);
+    for (int round = 0; round < 20000; ++round) {
+        std::string text;
+        for (size_t k = 0, count = random() % 30; k < count; ++k) {
+            text += random() % 4 == 0 ? std::string(random() % 20, 'a')
+                                      : pieces[random() % (round % 2 == 0 ? 5 : pieces.size())];
+        }
+        const Utf8Validation validation = validateUtf8(text.data(), text.size());
+        ASSERT_EQ(validation.error, reference(text)) << "round " << round;
+        ASSERT_EQ(validation.ascii, findNonAscii(text.data(), text.size()) == size_t(-1));
+    }
+}
+
 // --- Tests for Validator::validateParseResult ---
 
 TEST_F(ValidatorTest, ConvertsConsecutiveAsterisksToWarning) {
@@ -92,4 +191,86 @@ TEST_F(ValidatorTest, HandlesMultipleEventsCorrectly) {
     EXPECT_TRUE(found_error) << "The trailing backslash error was not generated.";
 }
 
+// --- Tests for PerformanceLinter::lintPerformance ---
+
+TEST_F(ValidatorTest, LintsNothingForOrdinaryPatterns) {
+    LintOptions options;
+    options.max_text_length = 100;
+    EXPECT_TRUE(PerformanceLinter::lintPerformance(Parser::parse("*.log"), options).empty());
+    EXPECT_TRUE(
+        PerformanceLinter::lintPerformance(Parser::parse("GET /api/*/users/*.json")).empty());
+    EXPECT_TRUE(PerformanceLinter::lintPerformance(Parser::parse("*error*id=*timeout*")).empty());
+}
+
+TEST_F(ValidatorTest, WarnsAboutManyStarsWithShortLiterals) {
+    auto issues = PerformanceLinter::lintPerformance(Parser::parse("x*a*b*c*d"));
+
+    ASSERT_EQ(issues.size(), 1);
+    const auto& issue = issues[0];
+    EXPECT_EQ(issue.code, IssueCode::MANY_STARS_WITH_SHORT_LITERALS);
+    EXPECT_EQ(issue.type, IssueType::WARNING);
+    // The fourth '*' reaches the default threshold
+    EXPECT_NE(issue.message.find("Warning at position 8"), std::string::npos);
+}
+
+TEST_F(ValidatorTest, WarnsAboutLeadingStarWithShortLiteral) {
+    auto issues = PerformanceLinter::lintPerformance(Parser::parse("*e*rror"));
+
+    ASSERT_EQ(issues.size(), 1);
+    EXPECT_EQ(issues[0].code, IssueCode::LEADING_STAR_SHORT_LITERAL);
+    EXPECT_NE(issues[0].message.find("Warning at position 2"), std::string::npos);
+    EXPECT_NE(issues[0].message.find("'e'"), std::string::npos);
+
+    // A short suffix is anchored at the end of the text and cheap to check
+    EXPECT_TRUE(PerformanceLinter::lintPerformance(Parser::parse("*.c")).empty());
+}
+
+TEST_F(ValidatorTest, WarnsAboutPatternsLongerThanTheText) {
+    LintOptions options;
+    options.max_text_length = 4;
+    auto issues = PerformanceLinter::lintPerformance(Parser::parse("ab*c\\?d"), options);
+
+    ASSERT_EQ(issues.size(), 1);
+    EXPECT_EQ(issues[0].code, IssueCode::PATTERN_LONGER_THAN_TEXT);
+    EXPECT_NE(issues[0].message.find("Warning at position 4: The pattern requires more than 4"),
+              std::string::npos);
+}
+
+// --- Tests for PerformanceLinter::validateAdmission ---
+
+TEST_F(ValidatorTest, AcceptsAdmittedPatternSilently) {
+    auto decision = CostModel::admit(Parser::parse("*.log").tokens, 100, Engine::DP, {});
+    EXPECT_TRUE(PerformanceLinter::validateAdmission(decision).empty());
+}
+
+TEST_F(ValidatorTest, ReportsRejectedPatternAsError) {
+    CostLimits limits;
+    limits.max_steps = 1000;
+    limits.allow_downgrade = false;
+    auto decision = CostModel::admit(Parser::parse("*a*b*c").tokens, 1000, Engine::DP, limits);
+    auto issues = PerformanceLinter::validateAdmission(decision);
+
+    ASSERT_EQ(issues.size(), 1);
+    const auto& issue = issues[0];
+    EXPECT_EQ(issue.code, IssueCode::PATTERN_TOO_EXPENSIVE);
+    EXPECT_TRUE(issue.isError());
+    EXPECT_NE(issue.message.find("Error in pattern: Pattern exceeds the cost limit"),
+              std::string::npos);
+    EXPECT_NE(issue.message.find("on the 'dp' engine for a text of 1000 characters"),
+              std::string::npos);
+}
+
+TEST_F(ValidatorTest, ReportsDowngradedPatternAsWarning) {
+    CostLimits limits;
+    limits.max_bytes = 4096;
+    auto decision = CostModel::admit(Parser::parse("*a*b*c").tokens, 1000, Engine::DP, limits);
+    auto issues = PerformanceLinter::validateAdmission(decision);
+
+    ASSERT_EQ(issues.size(), 1);
+    const auto& issue = issues[0];
+    EXPECT_EQ(issue.code, IssueCode::ENGINE_DOWNGRADED);
+    EXPECT_EQ(issue.type, IssueType::WARNING);
+    EXPECT_NE(issue.message.find("downgraded from 'dp' to 'greedy'"), std::string::npos);
+}
+
 }  // namespace
\ No newline at end of file
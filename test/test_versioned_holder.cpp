@@ -0,0 +1,116 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "multi/pattern_set.hpp"
+#include "multi/versioned_holder.hpp"
+
+namespace {
+
+/**
+ * @brief Counts live instances so tests can observe when retired versions are destroyed.
+ */
+struct Tracked {
+    explicit Tracked(int value_in, std::atomic<int>& live_in) : value(value_in), live(live_in) {
+        ++live;
+    }
+    ~Tracked() { --live; }
+
+    int value;
+    std::atomic<int>& live;
+};
+
+TEST(VersionedHolderTest, PublishesNewVersions) {
+    std::atomic<int> live = 0;
+    VersionedHolder<Tracked> holder(std::make_unique<Tracked>(1, live));
+    auto reader = holder.reader();
+    EXPECT_EQ(holder.version(), 1u);
+    EXPECT_EQ(reader.read()->value, 1);
+
+    EXPECT_EQ(holder.publish(std::make_unique<Tracked>(2, live)), 2u);
+    const auto guard = reader.read();
+    EXPECT_EQ(guard->value, 2);
+    EXPECT_EQ(guard.versionNumber(), 2u);
+
+    // No read section held version 1 while it was replaced, so it is already gone
+    EXPECT_EQ(holder.retiredCount(), 0u);
+    EXPECT_EQ(live, 1);
+}
+
+TEST(VersionedHolderTest, KeepsPinnedVersionsAlive) {
+    std::atomic<int> live = 0;
+    VersionedHolder<Tracked> holder(std::make_unique<Tracked>(1, live));
+    auto slow = holder.reader();
+    auto fast = holder.reader();
+
+    {
+        const auto pinned = slow.read();
+        holder.publish(std::make_unique<Tracked>(2, live));
+        holder.publish(std::make_unique<Tracked>(3, live));
+        EXPECT_EQ(fast.read()->value, 3);
+
+        // `slow` pins epoch 0, which holds back every version retired after it
+        EXPECT_EQ(pinned->value, 1);
+        EXPECT_EQ(holder.retiredCount(), 2u);
+        EXPECT_EQ(live, 3);
+        EXPECT_EQ(holder.reclaim(), 0u);
+    }
+
+    EXPECT_EQ(holder.reclaim(), 2u);
+    EXPECT_EQ(holder.retiredCount(), 0u);
+    EXPECT_EQ(live, 1);
+}
+
+TEST(VersionedHolderTest, ReusesReleasedReaderSlots) {
+    std::atomic<int> live = 0;
+    VersionedHolder<Tracked> holder(std::make_unique<Tracked>(1, live));
+    {
+        auto reader = holder.reader();
+        EXPECT_EQ(reader.read()->value, 1);
+    }
+    auto reader = holder.reader();
+    const auto guard = reader.read();
+    holder.publish(std::make_unique<Tracked>(2, live));
+    EXPECT_EQ(holder.retiredCount(), 1u);
+}
+
+TEST(VersionedHolderTest, ReloadsPatternSetsUnderConcurrentReads) {
+    VersionedHolder<PatternSet> holder(std::make_unique<const PatternSet>(
+        PatternSet::compile(std::vector<std::string>{"*.log", "v0"})));
+    std::atomic<bool> done = false;
+    std::atomic<long> reads = 0;
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            auto reader = holder.reader();
+            while (!done) {
+                const auto guard = reader.read();
+                // Every version keeps "*.log" as pattern 0
+                ASSERT_EQ(guard->matchFirst("app.log"), 0u);
+                ++reads;
+            }
+        });
+    }
+
+    for (int version = 1; version <= 200; ++version) {
+        holder.publish(std::make_unique<const PatternSet>(PatternSet::compile(
+            std::vector<std::string>{"*.log", "v" + std::to_string(version)})));
+    }
+    done = true;
+    for (auto& thread : readers) {
+        thread.join();
+    }
+
+    EXPECT_EQ(holder.version(), 201u);
+    holder.reclaim();
+    EXPECT_EQ(holder.retiredCount(), 0u);
+    auto reader = holder.reader();
+    EXPECT_EQ(reader.read()->matchAll("v200"), (std::vector<size_t>{1}));
+}
+
+}  // namespace
\ No newline at end of file